@@ -10,7 +10,9 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "Hil_Compiler.h"
+#include "Hil_DeviceProductionData.h"
 
 
 #define HIL_HBOOT_STANDARD_COOKIE                       0xF3BEAF00
@@ -37,6 +39,8 @@ typedef __HIL_PACKED_PRE struct __HIL_PACKED_POST HIL_FILE_HBOOT_BOOT_HEADER_NAI
 
 } HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T;
 
+#define HBOOT_NAI_HEADER_OFFSET 448 // behind the vector table
+
 
 
 
@@ -59,6 +63,16 @@ typedef enum FILE_TYPE_Etag {
 	FILETYPE_UPD, // update area file
 	FILETYPE_NAI, // user firmware for APP side
 	FILETYPE_NXF, // legacy firmware, netX 51, netX 52 , etc
+	FILETYPE_LIST, // text file listing files for batch processing
+	FILETYPE_MANIFEST, // sector hash manifest
+	FILETYPE_INDEX, // fleet index
+	FILETYPE_NXE, // extension of an NXI firmware in SQI flash
+	FILETYPE_NAE, // extension of an NAI firmware
+	FILETYPE_NXO, // optional firmware module, legacy
+	FILETYPE_NXD, // database
+	FILETYPE_NXL, // license
+	FILETYPE_NXB, // binary file
+	FILETYPE_NXM, // firmware module, obsolete
 	FILETYPE_UNKNOWN,
 }FILE_TYPE_E;
 
@@ -67,6 +81,314 @@ typedef enum FILE_TYPE_Etag {
 #define USE_CASE_B 1
 #define USE_CASE_C 2
 
+#define FLASH_DUMP_DEFAULT_BLOCK_SIZE 0x1000 // erase block size of the netX 90 internal flash
+#define FLASH_WORD_SIZE               16     // programming granularity of the netX 90 internal flash
+
+/* sector states of the fill level analysis */
+#define SECTOR_ERASED  0 // all bytes 0xFF
+#define SECTOR_PARTIAL 1 // programmed data followed by an erased tail of at least one flash word
+#define SECTOR_USED    2 // programmed up to the last flash word
+
+extern FILE_T tFlashDumpFile[3][8];
+extern FILE_T tSQIDumpFile[3][3];
+extern FILE_T tAppDumpFile[1];
+
+extern FILE_TYPE_E GetFileType(char* szFilename);
+extern uint32_t getOffset(int iUseCase,char *szSuffix);
+
+extern uint32_t getLength(int iUseCase,char *szSuffix);
+extern uint8_t* LoadFile(char* szFilename, size_t* pulSize);
+extern void AttachFileData(FILE* hFile, const uint8_t* pabData, size_t ulSize);
+extern size_t ReadFileData(FILE* hFile, fpos_t offset, void* pvBuffer, size_t ulSize);
+extern const uint8_t* AttachedFileData(FILE* hFile, fpos_t offset, size_t* pulSize);
+extern long GetFileDataSize(FILE* hFile);
+extern void* FileScratch(size_t ulSize);
+extern void FileScratchRelease(void);
+extern int AnalyzeNxfFileHeader(fpos_t offset, FILE* hInFile);
+extern int AnalyzeNaiFileHeader(fpos_t offset, FILE* hInFile);
+extern int AnalyzeNaeFileHeader(fpos_t offset, FILE* hInFile);
+extern int AnalyzeDefaultFileHeader(fpos_t offset, FILE* hInFile, int iMaxModuleInfos);
+extern int AnalyzeFDL(fpos_t offset, FILE* hInFile);
+
+extern bool BlockEqual(const uint8_t* pabA, const uint8_t* pabB, uint32_t ulSize);
+extern bool BlockEqualErased(const uint8_t* pabA, const uint8_t* pabB, uint32_t ulSize, bool* pbErased);
+extern uint32_t BlockFirstMismatch(const uint8_t* pabA, const uint8_t* pabB, uint32_t ulSize);
+extern bool BlockErased(const uint8_t* pab, uint32_t ulSize);
+extern uint32_t BlockWrittenEnd(const uint8_t* pab, uint32_t ulSize);
+extern uint8_t GetSectorState(const uint8_t* pab, uint32_t ulSize);
+
+typedef struct AREA_FILL_Ttag {
+	uint32_t ulUsed;       // sectors programmed up to the end
+	uint32_t ulPartial;    // sectors with an erased tail
+	uint32_t ulErased;     // sectors completely erased
+	uint32_t ulMissing;    // sectors beyond the end of the input
+	uint32_t ulWrittenEnd; // offset behind the highest programmed byte, 0 if erased
+} AREA_FILL_T;
+
+extern void ScanAreaFill(const uint8_t* pabData, size_t ulDataSize, const FILE_T* ptArea, uint32_t ulBlockSize, AREA_FILL_T* ptFill, uint8_t* abState);
+extern int AnalyzeFillLevel(const uint8_t* pabData, size_t ulDataSize, const FILE_T* atArea, int iNumAreas, uint32_t ulBlockSize);
+
+
+#define SHA256_DIGEST_SIZE 32
+
+typedef struct SHA256_CTX_Ttag {
+	uint32_t aulState[8];
+	uint64_t ullLength;
+	uint8_t abBuffer[64];
+	size_t ulBufferLen;
+} SHA256_CTX_T;
+
+extern void Sha256Init(SHA256_CTX_T* ptCtx);
+extern void Sha256Update(SHA256_CTX_T* ptCtx, const void* pvData, size_t ulSize);
+extern void Sha256Final(SHA256_CTX_T* ptCtx, uint8_t* abDigest);
+extern void Sha256(const void* pvData, size_t ulSize, uint8_t* abDigest);
+extern const char* Sha256Engine(void);
+
+#define SHA224_DIGEST_SIZE 28
+#define SHA384_DIGEST_SIZE 48
+#define SHA512_DIGEST_SIZE 64
+#define SHA512_LANES 4
+
+typedef struct SHA512_CTX_Ttag {
+	uint64_t aullState[8];
+	uint64_t ullLength;
+	uint8_t abBuffer[128];
+	size_t ulBufferLen;
+} SHA512_CTX_T;
+
+extern void Sha512Init(SHA512_CTX_T* ptCtx);
+extern void Sha384Init(SHA512_CTX_T* ptCtx);
+extern void Sha512Update(SHA512_CTX_T* ptCtx, const void* pvData, size_t ulSize);
+extern void Sha512Final(SHA512_CTX_T* ptCtx, uint8_t* abDigest);
+extern void Sha384(const void* pvData, size_t ulSize, uint8_t* abDigest);
+extern void Sha384Multi(const uint8_t* const* apabData, const size_t* aulSize, int iNumBuffers, uint8_t* abDigest);
+extern const char* Sha512Engine(void);
+
+
+#define MD5_DIGEST_SIZE 16
+#define MD5_MAX_LANES 16
+
+typedef struct MD5_CTX_Ttag {
+	uint32_t aulState[4];
+	uint64_t ullLength;
+	uint8_t abBuffer[64];
+	size_t ulBufferLen;
+} MD5_CTX_T;
+
+extern void Md5Init(MD5_CTX_T* ptCtx);
+extern void Md5Update(MD5_CTX_T* ptCtx, const void* pvData, size_t ulSize);
+extern void Md5Final(MD5_CTX_T* ptCtx, uint8_t* abDigest);
+extern void Md5Multi(const uint8_t* const* apabData, const size_t* aulSize, int iNumBuffers, uint8_t* abDigest);
+extern int Md5Lanes(void);
+extern const char* Md5Engine(void);
+
+extern bool HBootIsMagic(uint32_t ulMagic);
+extern int AnalyzeHBootChain(fpos_t offset, FILE* hInFile, const HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T* ptHeader);
+extern int VerifyHBootHashes(char** aszFiles, int iNumFiles, int iNumThreads);
+extern int VerifyFirmwareMd5(char** aszFiles, int iNumFiles, int iNumThreads);
+extern int CheckFirmwarePairs(char** aszFiles, int iNumFiles, int iNumThreads);
+extern int AnalyzeHwcFile(fpos_t offset, FILE* hInFile, uint32_t ulLength);
+extern int GroupHardwareConfigs(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads);
+extern int AnalyzeSqiDump(char* szFilename, int iUseCase, int iNumThreads);
+extern int AnalyzeFatArea(char* szFilename, FILE* hFile, uint32_t ulOffset, uint32_t ulLength, int iNumThreads);
+extern int AnalyzeDeviceImage(char** aszChipFiles, int iUseCase, int iNumThreads);
+extern int AnalyzeAppDump(char* szFilename);
+extern int AnalyzeAppDumps(char** aszFiles, int iNumFiles, int iNumThreads);
+extern int AnalyzeTagList(fpos_t offset, FILE* hInFile);
+extern int ExportTagList(char* szFilename);
+extern int DiffTagLists(char* szRefFilename, char** aszFiles, int iNumFiles, int iNumThreads);
+
+
+#define MERKLE_MANIFEST_SUFFIX ".mkl"
+
+extern int CreateMerkleManifest(char* szFilename, int iUseCase);
+extern int DiffMerkle(char* szRefFilename, char* szFilename, int iUseCase);
+
+
+/* analysis result record, the structured counterpart of the printed analysis */
+#define RECORD_FW_COM  0 // NXI area of a dump, or a single NXI/NXF/UPD file
+#define RECORD_FW_UPD  1 // update area of a dump
+#define RECORD_FW_MXF  2 // maintenance firmware
+#define RECORD_FW_NAI  3 // APP side firmware
+#define RECORD_FW_NUM  4
+
+#define RECORD_FLAG_FDL_VALID   0x00000001 // FDL start and end token found
+#define RECORD_FLAG_FDL_CRC_OK  0x00000002 // FDL checksum matches
+#define RECORD_FLAG_LOAD_ERROR  0x80000000 // file could not be read
+
+#define RECORD_VERSION 1 // increment when BuildRecord fills a record differently, cached records of other versions are dropped
+
+typedef struct NETX_FW_RECORD_Ttag {
+	uint32_t ulCookie;           // boot header cookie, 0xFFFFFFFF for an erased area
+	uint16_t usManufacturer;
+	uint16_t usDeviceClass;
+	uint8_t  bHwCompatibility;
+	uint8_t  bChipType;
+	uint16_t ausHwOptions[4];
+	uint32_t ulLicenseFlags1;
+	uint32_t ulLicenseFlags2;
+	uint16_t usNetXLicenseID;
+	uint16_t usNetXLicenseFlags;
+	uint16_t ausFwVersion[4];
+	uint32_t ulFwNumber;
+	uint32_t ulDeviceNumber;
+	uint32_t ulSerialNumber;
+	uint32_t ulHeaderCRC32;
+	uint32_t ulCommonCRC32;
+	uint32_t aulMD5[4];
+} NETX_FW_RECORD_T;
+
+typedef struct NETX_RECORD_Ttag {
+	uint32_t ulFileType;         // FILE_TYPE_E
+	uint32_t ulUseCase;
+	uint32_t ulFileSize;
+	uint32_t ulFlags;            // RECORD_FLAG_xxx
+	uint8_t  abSha256[SHA256_DIGEST_SIZE]; // content hash of the whole file
+	HIL_PRODUCT_DATA_BASIC_DEVICE_DATA_T tBasicDeviceData;
+	HIL_PRODUCT_DATA_MAC_ADDRESSES_COM_T tMACAddressesCom;
+	HIL_PRODUCT_DATA_MAC_ADDRESSES_APP_T tMACAddressesApp;
+	NETX_FW_RECORD_T atFw[RECORD_FW_NUM];
+} NETX_RECORD_T;
+
+extern uint64_t PackFwVersion(const uint16_t* ausFwVersion);
+extern int ParseVersionPattern(const char* szPattern, uint64_t* pullValue, uint64_t* pullMask);
+extern void BuildRecord(const uint8_t* pabData, size_t ulDataSize, FILE_TYPE_E eFileType, int iUseCase, NETX_RECORD_T* ptRecord);
+
+/* header bytes of one area read without the rest of the file */
+typedef struct RECORD_FRAGMENT_Ttag {
+	const char* szSuffix;        // area of a flash dump
+	const uint8_t* pabData;
+	size_t ulSize;               // bytes read, may be less than requested at the end of the file
+} RECORD_FRAGMENT_T;
+
+extern void BuildFragmentRecord(const RECORD_FRAGMENT_T* atFragment, int iNumFragments, FILE_TYPE_E eFileType, int iUseCase, NETX_RECORD_T* ptRecord);
+extern void PrintRecordSummary(const char* szFilename, const NETX_RECORD_T* ptRecord);
+extern int CollectRecords(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads, char* szCacheFilename, NETX_RECORD_T* atRecord, bool* abCached);
+extern int AnalyzeBatch(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads, char* szCacheFilename);
+
+
+/* fleet index, columnar store of the records of a batch */
+extern int CreateFleetIndex(char* szIndexFilename, char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads, char* szCacheFilename);
+extern int QueryFleetIndex(char* szIndexFilename, char* szQuery);
+
+typedef struct COMPAT_MATRIX_Ttag COMPAT_MATRIX_T;
+
+extern COMPAT_MATRIX_T* LoadCompatMatrix(char* szMatrixFile);
+extern void FreeCompatMatrix(COMPAT_MATRIX_T* ptMatrix);
+extern int CheckCompatRecord(const NETX_RECORD_T* ptRecord, const COMPAT_MATRIX_T* ptMatrix);
+extern int CheckCompatibility(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads, char* szCacheFilename, char* szMatrixFile);
+
+extern int AuditUniqueness(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads, char* szCacheFilename, uint32_t ulMemoryMB, char* szSpillPrefix);
+
+
+
+/* persistent result cache */
+typedef struct FILE_ID_Ttag {
+	uint64_t ullDevice;          // device / volume serial number
+	uint64_t ullInode;           // inode / file index
+	uint64_t ullSize;
+	int64_t  llMTime;            // modification time in ns
+} FILE_ID_T;
+
+typedef struct RESULT_CACHE_Ttag RESULT_CACHE_T;
+
+extern int GetFileId(const char* szFilename, FILE_ID_T* ptId);
+extern RESULT_CACHE_T* CacheOpen(char* szCacheFilename);
+extern bool CacheLookupId(RESULT_CACHE_T* ptCache, const FILE_ID_T* ptId, FILE_TYPE_E eFileType, int iUseCase, NETX_RECORD_T* ptRecord);
+extern bool CacheLookupHash(RESULT_CACHE_T* ptCache, const uint8_t* abSha256, FILE_TYPE_E eFileType, int iUseCase, NETX_RECORD_T* ptRecord);
+extern void CacheInsert(RESULT_CACHE_T* ptCache, const FILE_ID_T* ptId, const NETX_RECORD_T* ptRecord);
+extern int CacheClose(RESULT_CACHE_T* ptCache);
+
+extern bool RecordFile(RESULT_CACHE_T* ptCache, char* szFilename, int iUseCase, NETX_RECORD_T* ptRecord);
+
+extern int TriageBatch(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads);
+
+
+
+
+extern uint32_t GetDumpBlockSize(const uint8_t* pabDump, size_t ulDumpSize, int iUseCase);
+extern int DiffFlashDumps(char* szRefFilename, char* szFilename, int iUseCase);
+extern void PrintChangedRanges(const FILE_T* ptRegion, uint32_t ulBlockSize, const uint8_t* abChanged);
+
+extern bool IsVolatileArea(const char* szSuffix);
+extern int CheckCompliance(char* szGoldenFilename, char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads);
+
+
+#define BATCH_MAX_PATH 260
+
+typedef void (*BATCH_JOB_FN)(int iJob, int iWorker, void* pvContext);
+
+extern int BatchGetNumCpus(void);
+extern char** BatchLoadList(char* szListFile, int* piNumFiles);
+extern void BatchFreeList(char** aszFiles, int iNumFiles);
+extern int BatchRun(int iNumJobs, int iNumThreads, BATCH_JOB_FN fnJob, void* pvContext);
+extern void* BatchLockCreate(void);
+extern void BatchLock(void* pvLock);
+extern void BatchUnlock(void* pvLock);
+extern void BatchLockDestroy(void* pvLock);
+extern int* BatchOrderBySize(char** aszFiles, int iNumFiles);
+extern int* BatchOrderByPosition(char** aszFiles, int iNumFiles, bool* pbExtents);
+
+/* whole file handed to the parser, pabData is NULL if the file could not be read */
+typedef void (*BATCH_READ_FN)(int iJob, int iWorker, const uint8_t* pabData, size_t ulSize, void* pvContext);
+
+extern int BatchReadFiles(char** aszFiles, int iNumFiles, int iNumThreads, BATCH_READ_FN fnParse, void* pvContext);
+
+/* parts of a file read instead of the whole file, the parser gets them one after the
+ * other in one buffer, ulRead is set by the reader and is less than ulSize at the end of the file */
+#define BATCH_MAX_RANGES 4
+
+typedef struct BATCH_RANGE_Ttag {
+	uint32_t ulOffset;
+	uint32_t ulSize;
+	uint32_t ulRead;
+} BATCH_RANGE_T;
+
+typedef struct BATCH_RANGES_Ttag {
+	int iNumRanges;
+	BATCH_RANGE_T atRange[BATCH_MAX_RANGES];
+} BATCH_RANGES_T;
+
+extern int BatchReadRanges(char** aszFiles, int iNumFiles, int iNumThreads, BATCH_RANGES_T* atRanges, BATCH_READ_FN fnParse, void* pvContext);
+extern void BatchReadSetPhysicalOrder(bool bPhysical);
+extern void BatchReadSetDirect(bool bDirect);
+
+/* read only mapping of a whole file */
+typedef struct BATCH_MAP_Ttag {
+	const uint8_t* pabData;
+	size_t ulSize;
+#ifdef _WIN32
+	void* hFile;
+	void* hMapping;
+#endif
+} BATCH_MAP_T;
+
+extern int BatchMapFile(char* szFilename, BATCH_MAP_T* ptMap);
+extern void BatchUnmapFile(BATCH_MAP_T* ptMap);
+
+/* per file scratch memory, released at once by ArenaReset */
+#define ARENA_ALIGN 4096
+
+typedef struct ARENA_BLOCK_Ttag ARENA_BLOCK_T;
+
+typedef struct FILE_ARENA_Ttag {
+	ARENA_BLOCK_T* ptBlock;      // current block, blocks of a large file chained behind
+	size_t ulBlockSize;          // size of the next block
+	size_t ulUsed;               // since the last reset
+	size_t ulDefaultSize;        // block size of ArenaInit
+} FILE_ARENA_T;
+
+extern void ArenaInit(FILE_ARENA_T* ptArena, size_t ulBlockSize);
+extern void* ArenaAlloc(FILE_ARENA_T* ptArena, size_t ulSize, size_t ulAlign);
+extern void ArenaReset(FILE_ARENA_T* ptArena);
+extern void ArenaFree(FILE_ARENA_T* ptArena);
+
+/* heap functions counting the allocations */
+extern void* MemAlloc(size_t ulSize);
+extern void* MemCalloc(size_t ulNum, size_t ulSize);
+extern void* MemRealloc(void* pvData, size_t ulSize);
+extern long MemHeapAllocs(void);
+
 
 extern char* LookupCode(uint32_t ulCmd);
 extern char* LookupComClassCode(uint16_t ulCmd);
@@ -75,5 +397,8 @@ extern char* LookupDevClassCode(uint16_t ulCmd);
 extern char* LookupDevTypeCode(uint32_t ulCmd);
 extern char* LookupChipTypeCode(uint8_t ulCmd);
 
+extern uint32_t PS_CRC32(uint32_t ulPrevCrc, const uint8_t* pabBuffer, size_t numBytes);
+
+
 
 #endif /* INC_NETXFLASHANALYZER_H_ */
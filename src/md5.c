@@ -0,0 +1,335 @@
+/*
+ * md5.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  MD5 (RFC 1321)
+ *  Md5Multi hashes many buffers at once, one buffer per 32 bit lane:
+ *  16 lanes with AVX-512, 8 lanes with AVX2, otherwise one buffer after the other
+ */
+
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MD5_USE_SIMD
+#endif
+
+#include "netXFileChecker.h"
+
+
+static const uint32_t s_aulMd5K[64]={
+	0xd76aa478,0xe8c7b756,0x242070db,0xc1bdceee,0xf57c0faf,0x4787c62a,0xa8304613,0xfd469501,
+	0x698098d8,0x8b44f7af,0xffff5bb1,0x895cd7be,0x6b901122,0xfd987193,0xa679438e,0x49b40821,
+	0xf61e2562,0xc040b340,0x265e5a51,0xe9b6c7aa,0xd62f105d,0x02441453,0xd8a1e681,0xe7d3fbc8,
+	0x21e1cde6,0xc33707d6,0xf4d50d87,0x455a14ed,0xa9e3e905,0xfcefa3f8,0x676f02d9,0x8d2a4c8a,
+	0xfffa3942,0x8771f681,0x6d9d6122,0xfde5380c,0xa4beea44,0x4bdecfa9,0xf6bb4b60,0xbebfbc70,
+	0x289b7ec6,0xeaa127fa,0xd4ef3085,0x04881d05,0xd9d4d039,0xe6db99e5,0x1fa27cf8,0xc4ac5665,
+	0xf4292244,0x432aff97,0xab9423a7,0xfc93a039,0x655b59c3,0x8f0ccc92,0xffeff47d,0x85845dd1,
+	0x6fa87e4f,0xfe2ce6e0,0xa3014314,0x4e0811a1,0xf7537e82,0xbd3af235,0x2ad7d2bb,0xeb86d391,
+};
+
+static const uint8_t s_abMd5Shift[64]={
+	7,12,17,22,7,12,17,22,7,12,17,22,7,12,17,22,
+	5, 9,14,20,5, 9,14,20,5, 9,14,20,5, 9,14,20,
+	4,11,16,23,4,11,16,23,4,11,16,23,4,11,16,23,
+	6,10,15,21,6,10,15,21,6,10,15,21,6,10,15,21,
+};
+
+/* message word used in round i */
+static const uint8_t s_abMd5Word[64]={
+	0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,
+	1,6,11,0,5,10,15,4,9,14,3,8,13,2,7,12,
+	5,8,11,14,1,4,7,10,13,0,3,6,9,12,15,2,
+	0,7,14,5,12,3,10,1,8,15,6,13,4,11,2,9,
+};
+
+#define ROL32(x,n) (((x)<<(n))|((x)>>(32-(n))))
+
+
+
+static uint32_t Load32Le(const uint8_t* pab){
+	return (uint32_t)pab[0]|((uint32_t)pab[1]<<8)|((uint32_t)pab[2]<<16)|((uint32_t)pab[3]<<24);
+}
+
+
+
+static void Md5Block(uint32_t* aulState, const uint8_t* pabBlock){
+	uint32_t aulM[16];
+	uint32_t a=aulState[0],b=aulState[1],c=aulState[2],d=aulState[3];
+	int i=0;
+
+	for(i=0;i<16;i++){
+		aulM[i]=Load32Le(pabBlock+4*i);
+	}
+
+	for(i=0;i<64;i++){
+		uint32_t f=0;
+		uint32_t t=0;
+		switch(i>>4){
+		case 0: f=d^(b&(c^d)); break;
+		case 1: f=c^(d&(b^c)); break;
+		case 2: f=b^c^d;       break;
+		default: f=c^(b|~d);   break;
+		}
+		t=a+f+s_aulMd5K[i]+aulM[s_abMd5Word[i]];
+		a=d; d=c; c=b;
+		b=b+ROL32(t,s_abMd5Shift[i]);
+	}
+
+	aulState[0]+=a; aulState[1]+=b; aulState[2]+=c; aulState[3]+=d;
+}
+
+
+
+#ifdef MD5_USE_SIMD
+/* message words of one block of every lane, word w of lane l at aulM[w*iLanes+l] */
+static void Md5Transpose(uint32_t* aulM, const uint8_t** apabData, size_t ulOffset, int iLanes){
+	int w=0;
+	int l=0;
+
+	for(l=0;l<iLanes;l++){
+		const uint8_t* pabBlock=apabData[l]+ulOffset;
+		for(w=0;w<16;w++){
+			aulM[w*iLanes+l]=Load32Le(pabBlock+4*w);
+		}
+	}
+}
+
+#define MD5_AVX2_ROL(x,n) _mm256_or_si256(_mm256_slli_epi32((x),(n)),_mm256_srli_epi32((x),32-(n)))
+
+/* ulNumBlocks blocks of 8 buffers, lane l reads apabData[l] and updates aulState[4*l..4*l+3] */
+__attribute__((target("avx2")))
+static void Md5Blocks8Avx2(uint32_t* aulState, const uint8_t** apabData, size_t ulNumBlocks){
+	uint32_t aulM[16*8] __attribute__((aligned(32)));
+	uint32_t aulLane[8] __attribute__((aligned(32)));
+	const __m256i tOnes=_mm256_set1_epi32(-1);
+	__m256i atState[4];
+	__m256i a,b,c,d,f,t;
+	size_t ulBlock=0;
+	int i=0;
+	int l=0;
+
+	for(i=0;i<4;i++){
+		for(l=0;l<8;l++){
+			aulLane[l]=aulState[4*l+i];
+		}
+		atState[i]=_mm256_load_si256((const __m256i*)aulLane);
+	}
+
+	for(ulBlock=0;ulBlock<ulNumBlocks;ulBlock++){
+		Md5Transpose(aulM,apabData,ulBlock*64,8);
+		a=atState[0]; b=atState[1]; c=atState[2]; d=atState[3];
+
+		for(i=0;i<64;i++){
+			switch(i>>4){
+			case 0: f=_mm256_xor_si256(d,_mm256_and_si256(b,_mm256_xor_si256(c,d))); break;
+			case 1: f=_mm256_xor_si256(c,_mm256_and_si256(d,_mm256_xor_si256(b,c))); break;
+			case 2: f=_mm256_xor_si256(_mm256_xor_si256(b,c),d); break;
+			default: f=_mm256_xor_si256(c,_mm256_or_si256(b,_mm256_xor_si256(d,tOnes))); break;
+			}
+			t=_mm256_add_epi32(_mm256_add_epi32(a,f),_mm256_add_epi32(_mm256_set1_epi32((int)s_aulMd5K[i]),_mm256_load_si256((const __m256i*)&aulM[8*s_abMd5Word[i]])));
+			a=d; d=c; c=b;
+			b=_mm256_add_epi32(b,MD5_AVX2_ROL(t,s_abMd5Shift[i]));
+		}
+
+		atState[0]=_mm256_add_epi32(atState[0],a); atState[1]=_mm256_add_epi32(atState[1],b);
+		atState[2]=_mm256_add_epi32(atState[2],c); atState[3]=_mm256_add_epi32(atState[3],d);
+	}
+
+	for(i=0;i<4;i++){
+		_mm256_store_si256((__m256i*)aulLane,atState[i]);
+		for(l=0;l<8;l++){
+			aulState[4*l+i]=aulLane[l];
+		}
+	}
+}
+
+/* ulNumBlocks blocks of 16 buffers, ternary logic does each round function in one instruction */
+__attribute__((target("avx512f")))
+static void Md5Blocks16Avx512(uint32_t* aulState, const uint8_t** apabData, size_t ulNumBlocks){
+	uint32_t aulM[16*16] __attribute__((aligned(64)));
+	uint32_t aulLane[16] __attribute__((aligned(64)));
+	__m512i atState[4];
+	__m512i a,b,c,d,f,t;
+	size_t ulBlock=0;
+	int i=0;
+	int l=0;
+
+	for(i=0;i<4;i++){
+		for(l=0;l<16;l++){
+			aulLane[l]=aulState[4*l+i];
+		}
+		atState[i]=_mm512_load_si512(aulLane);
+	}
+
+	for(ulBlock=0;ulBlock<ulNumBlocks;ulBlock++){
+		Md5Transpose(aulM,apabData,ulBlock*64,16);
+		a=atState[0]; b=atState[1]; c=atState[2]; d=atState[3];
+
+		for(i=0;i<64;i++){
+			switch(i>>4){
+			case 0: f=_mm512_ternarylogic_epi32(b,c,d,0xCA); break; // b ? c : d
+			case 1: f=_mm512_ternarylogic_epi32(b,c,d,0xE4); break; // d ? b : c
+			case 2: f=_mm512_ternarylogic_epi32(b,c,d,0x96); break; // b ^ c ^ d
+			default: f=_mm512_ternarylogic_epi32(b,c,d,0x39); break; // c ^ (b | ~d)
+			}
+			t=_mm512_add_epi32(_mm512_add_epi32(a,f),_mm512_add_epi32(_mm512_set1_epi32((int)s_aulMd5K[i]),_mm512_load_si512(&aulM[16*s_abMd5Word[i]])));
+			a=d; d=c; c=b;
+			b=_mm512_add_epi32(b,_mm512_rolv_epi32(t,_mm512_set1_epi32(s_abMd5Shift[i])));
+		}
+
+		atState[0]=_mm512_add_epi32(atState[0],a); atState[1]=_mm512_add_epi32(atState[1],b);
+		atState[2]=_mm512_add_epi32(atState[2],c); atState[3]=_mm512_add_epi32(atState[3],d);
+	}
+
+	for(i=0;i<4;i++){
+		_mm512_store_si512(aulLane,atState[i]);
+		for(l=0;l<16;l++){
+			aulState[4*l+i]=aulLane[l];
+		}
+	}
+}
+#endif
+
+
+
+/* number of buffers Md5Multi hashes together, the batch size to aim for */
+int Md5Lanes(void){
+#ifdef MD5_USE_SIMD
+	if(__builtin_cpu_supports("avx512f"))
+		return 16;
+	if(__builtin_cpu_supports("avx2"))
+		return 8;
+#endif
+	return 1;
+}
+
+
+
+/* name of the multi buffer implementation in use, for reports */
+const char* Md5Engine(void){
+	switch(Md5Lanes()){
+	case 16: return "AVX-512 16 lanes";
+	case 8:  return "AVX2 8 lanes";
+	default: return "C";
+	}
+}
+
+
+
+void Md5Init(MD5_CTX_T* ptCtx){
+	ptCtx->aulState[0]=0x67452301;
+	ptCtx->aulState[1]=0xefcdab89;
+	ptCtx->aulState[2]=0x98badcfe;
+	ptCtx->aulState[3]=0x10325476;
+	ptCtx->ullLength=0;
+	ptCtx->ulBufferLen=0;
+}
+
+
+
+void Md5Update(MD5_CTX_T* ptCtx, const void* pvData, size_t ulSize){
+	const uint8_t* pabData=(const uint8_t*)pvData;
+
+	ptCtx->ullLength+=ulSize;
+
+	if(ptCtx->ulBufferLen){
+		size_t ulFill=HIL_MIN(ulSize,64-ptCtx->ulBufferLen);
+		memcpy(&ptCtx->abBuffer[ptCtx->ulBufferLen],pabData,ulFill);
+		ptCtx->ulBufferLen+=ulFill;
+		pabData+=ulFill;
+		ulSize-=ulFill;
+		if(ptCtx->ulBufferLen<64)
+			return;
+		Md5Block(ptCtx->aulState,ptCtx->abBuffer);
+		ptCtx->ulBufferLen=0;
+	}
+
+	while(ulSize>=64){
+		Md5Block(ptCtx->aulState,pabData);
+		pabData+=64;
+		ulSize-=64;
+	}
+
+	memcpy(ptCtx->abBuffer,pabData,ulSize);
+	ptCtx->ulBufferLen=ulSize;
+}
+
+
+
+void Md5Final(MD5_CTX_T* ptCtx, uint8_t* abDigest){
+	uint64_t ullBits=ptCtx->ullLength*8;
+	int i=0;
+
+	ptCtx->abBuffer[ptCtx->ulBufferLen++]=0x80;
+	if(ptCtx->ulBufferLen>56){
+		memset(&ptCtx->abBuffer[ptCtx->ulBufferLen],0,64-ptCtx->ulBufferLen);
+		Md5Block(ptCtx->aulState,ptCtx->abBuffer);
+		ptCtx->ulBufferLen=0;
+	}
+	memset(&ptCtx->abBuffer[ptCtx->ulBufferLen],0,56-ptCtx->ulBufferLen);
+	for(i=0;i<8;i++){
+		ptCtx->abBuffer[56+i]=(uint8_t)(ullBits>>(8*i));
+	}
+	Md5Block(ptCtx->aulState,ptCtx->abBuffer);
+
+	for(i=0;i<16;i++){
+		abDigest[i]=(uint8_t)(ptCtx->aulState[i/4]>>(8*(i%4)));
+	}
+}
+
+
+
+/* MD5 of iNumBuffers buffers, abDigest receives MD5_DIGEST_SIZE bytes per buffer
+ * groups of Md5Lanes() buffers step through their common full blocks together,
+ * the remaining blocks of the longer buffers are hashed one by one */
+void Md5Multi(const uint8_t* const* apabData, const size_t* aulSize, int iNumBuffers, uint8_t* abDigest){
+	MD5_CTX_T atCtx[MD5_MAX_LANES];
+	int iMaxLanes=Md5Lanes();
+	int iFirst=0;
+	int i=0;
+
+	for(iFirst=0;iFirst<iNumBuffers;iFirst+=iMaxLanes){
+		int iLanes=HIL_MIN(iMaxLanes,iNumBuffers-iFirst);
+		size_t aulDone[MD5_MAX_LANES]={0};
+
+		for(i=0;i<iLanes;i++){
+			Md5Init(&atCtx[i]);
+		}
+
+#ifdef MD5_USE_SIMD
+		if(iLanes>1){
+			uint32_t aulState[4*MD5_MAX_LANES];
+			const uint8_t* apabLane[MD5_MAX_LANES];
+			size_t ulCommon=aulSize[iFirst]/64;
+
+			/* unused lanes repeat lane 0, their result is dropped */
+			for(i=0;i<iMaxLanes;i++){
+				int iLane=i<iLanes ? i : 0;
+				apabLane[i]=apabData[iFirst+iLane];
+				memcpy(&aulState[4*i],atCtx[0].aulState,sizeof(atCtx[0].aulState));
+				ulCommon=HIL_MIN(ulCommon,aulSize[iFirst+iLane]/64);
+			}
+
+			if(ulCommon){
+				if(iMaxLanes==16)
+					Md5Blocks16Avx512(aulState,apabLane,ulCommon);
+				else
+					Md5Blocks8Avx2(aulState,apabLane,ulCommon);
+				for(i=0;i<iLanes;i++){
+					memcpy(atCtx[i].aulState,&aulState[4*i],sizeof(atCtx[i].aulState));
+					aulDone[i]=ulCommon*64;
+					atCtx[i].ullLength=aulDone[i];
+				}
+			}
+		}
+#endif
+
+		for(i=0;i<iLanes;i++){
+			Md5Update(&atCtx[i],apabData[iFirst+i]+aulDone[i],aulSize[iFirst+i]-aulDone[i]);
+			Md5Final(&atCtx[i],&abDigest[(iFirst+i)*MD5_DIGEST_SIZE]);
+		}
+	}
+}
@@ -2,7 +2,7 @@
  ============================================================================
  Name        : netxFlashAnalyzer.c
  Author      : Dirk Fischer
- Version     : 1.1.0.0
+ Version     : 1.2.0.0
  Copyright   : Hilscher Gesellschaft fr Systemautomation mbH
                MIT License
  Description : netXFileChecker utility to analyse netX 90 flash memory dumps
@@ -10,6 +10,32 @@
                utility provides FDL generator functionality
 
  ChangeLog:
+               V1.2.0.0 2026-10-19  added flash dump diff (-diff), sector compare per region
+                                    added golden image compliance check (-comply) for *.lst batches
+                                    added fill level analysis (-fill), erased/partial/used sectors
+                                    added per sector hash manifest with Merkle trees (-merkle, -mdiff)
+                                    added batch summary (-batch) with persistent result cache (-cache)
+                                    added fleet index (-index) and index queries (-query)
+                                    added MAC address and serial number uniqueness audit (-audit)
+                                    added firmware to hardware compatibility check (-compat, -matrix)
+                                    added HBOOT image hash check of *.nai files, batch check (-hboot)
+                                    added MD5 check of firmware files (-md5)
+                                    added NXE/NAE files, common CRC check of NXI+NXE and NAI+NAE pairs (-pair)
+                                    added HBOOT header chain walker, all segments are hash checked
+                                    added hardware config analysis, grouping of configs by fingerprint (-hwc)
+                                    added SQI flash dump analysis (-sqi) with FAT file system index and file hashes
+                                    added device image of INTFLASH0/1 and SQI flash, FDL areas resolved per chip (-device)
+                                    added tag list of legacy firmware files, export (-tags) and batch diff against a reference (-tagdiff)
+                                    file formats are looked up in one table (suffix, cookie, analyzer)
+                                    added NXO, NXD, NXL, NXB and NXM files, default header and module info analysis
+                                    added APP side flash dump analysis (-app), vector table, NAI headers and trailing data
+                                    the input file is read once, split writer, analyzers and fill level use the same buffer
+                                    added header triage of batches (-triage), only FDL and firmware headers are read
+                                    batch records without cache are read by an io_uring reader (Linux), worker threads otherwise
+                                    added physical read order of batches (-physical), first extent or inode, with readahead hints
+                                    added direct I/O for batch reads (-direct), aligned buffers sized to the flash layout, audit uses the batch reader
+                                    analyzer and batch buffers are taken from per file arenas, heap allocations of a batch are counted
+
                V1.1.0.0 2020-06-09  updated Hil_DeviceProductionData.h
                                     added functionality to CreateFDL()
                                       - works for use case A now
@@ -25,6 +51,7 @@
 #include <conio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -34,8 +61,6 @@
 
 #define MAX_FILENAME_LEN 100
 
-uint32_t PS_CRC32(uint32_t ulPrevCrc, const uint8_t* pabBuffer, size_t numBytes);
-
 
 
 FILE_T tFlashDumpFile[][8] ={
@@ -83,37 +108,196 @@ FILE_T tSQIDumpFile[][3] ={
 };
 
 
+/* internal flash of the APP CPU (INTFLASH2) */
+FILE_T tAppDumpFile[] ={
+				{".nai",0x00000,0x80000,0,},
+};
+
+
+
+/* analyzer of a file format, called with the opened file */
+typedef int (*FILE_ANALYZER_FN)(char* szFilename, FILE* hInFile, int iUseCase);
+
+typedef struct FILE_FORMAT_Ttag {
+	char szSuffix[5];            // lower case
+	FILE_TYPE_E eType;
+	uint32_t ulCookieOffset;     // offset of the file header cookie
+	uint32_t ulCookie;           // 0: no cookie
+	uint32_t ulCookieMask;
+	int iMaxModuleInfos;         // module infos of the DEFAULT header layout, NXM like NXF
+	FILE_ANALYZER_FN fnAnalyze;  // NULL: no single file analysis
+	const char* szDescription;
+} FILE_FORMAT_T;
+
+
+static int AnalyzeFlashDumpFile(char* szFilename, FILE* hInFile, int iUseCase){
+	printf("\n-------------------------------- Flash Device Label FDL----------------------------------\n");
+	AnalyzeFDL(getOffset(iUseCase, ".fdl"), hInFile); // FDL
+	printf("\n-------------------------------------- Firmware NXI--------------------------------------\n");
+	printf("offset: 0x%08x, areasize: 0x%08x [%dKB]\n",getOffset(iUseCase, ".nxi"),getLength(iUseCase, ".nxi"),getLength(iUseCase, ".nxi")/1024);
+	AnalyzeNxfFileHeader(getOffset(iUseCase, ".nxi"),hInFile);
+
+	if(iUseCase==USE_CASE_A || iUseCase==USE_CASE_B){
+		printf("\n-------------------------------------- Update Area --------------------------------------\n");
+		printf("offset: 0x%08x, areasize: 0x%08x [%dKB]\n",getOffset(iUseCase, ".upd"),getLength(iUseCase, ".upd"),getLength(iUseCase, ".upd")/1024);
+		AnalyzeNxfFileHeader(getOffset(iUseCase, ".upd"),hInFile);
+	}
+
+	printf("\n-------------------------------- Maintenance Firmware MXF--------------------------------\n");
+	printf("offset: 0x%08x, areasize: 0x%08x [%dKB]\n",getOffset(iUseCase, ".mxf"),getLength(iUseCase, ".mxf"),getLength(iUseCase, ".mxf")/1024);
+	AnalyzeNxfFileHeader(getOffset(iUseCase, ".mxf"),hInFile);
+	return 0;
+}
+
+static int AnalyzeFdlFile(char* szFilename, FILE* hInFile, int iUseCase){
+	return AnalyzeFDL(0x0000, hInFile);
+}
+
+static int AnalyzeFirmwareFile(char* szFilename, FILE* hInFile, int iUseCase){
+	return AnalyzeNxfFileHeader(0x0000, hInFile);
+}
+
+static int AnalyzeNaiFile(char* szFilename, FILE* hInFile, int iUseCase){
+	return AnalyzeNaiFileHeader(0x0000, hInFile);
+}
+
+static int AnalyzeNaeFile(char* szFilename, FILE* hInFile, int iUseCase){
+	return AnalyzeNaeFileHeader(0x0000, hInFile);
+}
+
+static const FILE_FORMAT_T* GetFileFormat(char* szFilename);
+
+static int AnalyzeDefaultFile(char* szFilename, FILE* hInFile, int iUseCase){
+	return AnalyzeDefaultFileHeader(0x0000, hInFile, GetFileFormat(szFilename)->iMaxModuleInfos);
+}
+
+static int AnalyzeHwConfigFile(char* szFilename, FILE* hInFile, int iUseCase){
+	return AnalyzeHwcFile(0x0000, hInFile, (uint32_t)GetFileDataSize(hInFile));
+}
+
+
+/* all known file formats, the file suffix selects the entry */
+static const FILE_FORMAT_T s_atFileFormat[]={
+		{".bin",FILETYPE_FLASHDUMP,0,0,0,0,AnalyzeFlashDumpFile,"flash dump"},
+		{".nxi",FILETYPE_NXI,0,HIL_FILE_HEADER_FIRMWARE_NXI_COOKIE,0xFFFFFFFF,0,AnalyzeFirmwareFile,"firmware"},
+		{".fdl",FILETYPE_FDL,0,0,0,0,AnalyzeFdlFile,"flash device label"},
+		{".mxf",FILETYPE_MXF,0,HIL_FILE_HEADER_FIRMWARE_MXF_COOKIE,0xFFFFFFFF,0,AnalyzeFirmwareFile,"maintenance firmware"},
+		{".hwc",FILETYPE_HWC,0,0,0,0,AnalyzeHwConfigFile,"hardware config"},
+		{".mwc",FILETYPE_MWC,0,0,0,0,AnalyzeHwConfigFile,"hardware config for maintenance firmware"},
+		{".rdt",FILETYPE_RDT,0,0,0,0,NULL,"remanent data"},
+		{".mng",FILETYPE_MNG,0,0,0,0,NULL,"managmenet data"},
+		{".upd",FILETYPE_UPD,0,0,0,0,AnalyzeFirmwareFile,"update area file"},
+		{".nai",FILETYPE_NAI,HBOOT_NAI_HEADER_OFFSET+sizeof(HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T),HIL_FILE_HEADER_FIRMWARE_NAI_COOKIE,0xFFFFFFFF,0,AnalyzeNaiFile,"user firmware on APP side"},
+		{".nxe",FILETYPE_NXE,0,HIL_FILE_HEADER_FIRMWARE_NXE_COOKIE,0xFFFFFFFF,0,AnalyzeFirmwareFile,"extension of a *.nxi firmware in SQI flash"},
+		{".nae",FILETYPE_NAE,0,HIL_FILE_HEADER_FIRMWARE_NAE_COOKIE,0xFFFFFFFF,0,AnalyzeNaeFile,"extension of a *.nai firmware"},
+		{".nxf",FILETYPE_NXF,0,HIL_FILE_HEADER_FIRMWARE_COOKIE,0xFFFFFF00,0,AnalyzeFirmwareFile,"legacy firmware netX 51, netx 52, etc."},
+		{".nxo",FILETYPE_NXO,0,HIL_FILE_HEADER_OPTION_COOKIE,0xFFFFFFFF,1,AnalyzeDefaultFile,"optional firmware module"},
+		{".nxd",FILETYPE_NXD,0,HIL_FILE_HEADER_DATABASE_COOKIE,0xFFFFFFFF,1,AnalyzeDefaultFile,"database"},
+		{".nxl",FILETYPE_NXL,0,HIL_FILE_HEADER_LICENSE_COOKIE,0xFFFFFFFF,0,AnalyzeDefaultFile,"license"},
+		{".nxb",FILETYPE_NXB,0,HIL_FILE_HEADER_BINARY_COOKIE,0xFFFFFFFF,0,AnalyzeDefaultFile,"binary file"},
+		{".nxm",FILETYPE_NXM,0,HIL_FILE_HEADER_MODULE_COOKIE,0xFFFFFFFF,6,AnalyzeDefaultFile,"firmware module (obsolete)"},
+		{".lst",FILETYPE_LIST,0,0,0,0,NULL,"list of files for batch processing"},
+		{".mkl",FILETYPE_MANIFEST,0,0,0,0,NULL,"sector hash manifest"},
+		{".idx",FILETYPE_INDEX,0,0,0,0,NULL,"fleet index"},
+};
+
+
+/* format of a file by its suffix, upper and lower case suffixes are accepted */
+static const FILE_FORMAT_T* GetFileFormat(char* szFilename){
+	size_t ulLen=strlen(szFilename);
+	char szSuffix[5]={0};
+	int i=0;
+
+	if(ulLen<=4){
+		return NULL;
+	}
+	for(i=0;i<4;i++){
+		szSuffix[i]=(char)tolower((unsigned char)szFilename[ulLen-4+i]);
+	}
+	for(i=0;i<sizeof(s_atFileFormat)/sizeof(FILE_FORMAT_T);i++){
+		if(0==strcmp(szSuffix,s_atFileFormat[i].szSuffix)){
+			return &s_atFileFormat[i];
+		}
+	}
+	return NULL;
+}
+
+
+/* the header cookie of a file has to match its suffix */
+static bool CheckFileCookie(const FILE_FORMAT_T* ptFormat, FILE* hInFile){
+	uint32_t ulCookie=0;
+
+	if(ptFormat->ulCookie==0)
+		return true;
+	if(ReadFileData(hInFile,ptFormat->ulCookieOffset,&ulCookie,sizeof(ulCookie))!=sizeof(ulCookie)){
+		printf("Warning: file too short for a %s header\n",ptFormat->szSuffix);
+		return false;
+	}
+	if((ulCookie&ptFormat->ulCookieMask)!=ptFormat->ulCookie){
+		printf("Warning: cookie 0x%08x [%s] doesn't match a %s file, expected 0x%08x\n",ulCookie,LookupCode(ulCookie),ptFormat->szSuffix,ptFormat->ulCookie);
+		return false;
+	}
+	return true;
+}
+
+
 
 void printHelp(char* szCommandName){
+	int i=0;
+
 	printf("usage: %s options filename\n",szCommandName);
 	printf("options: \n");
 	printf("         -h    print help\n");
 	printf("         -u    use case A|B|C default:A, used for flash dump analysis and creation\n");
 	printf("         -s    split, in case of a flash dump analysis, separate files are created\n");
 	printf("         -fdl  create a standard flash device label, parameter -u might be used\n");
+	printf("         -diff reference  compare a flash dump sector by sector against a reference dump\n");
+	printf("         -comply golden   check flash dumps against a golden image, FDL/RDT/MNG/UPD are ignored\n");
+	printf("         -j    number of worker threads for batch processing, default: number of CPUs\n");
+	printf("         -fill fill level analysis, erased, partially used and used sectors per area\n");
+	printf("         -merkle          create a sector hash manifest <filename>.mkl\n");
+	printf("         -mdiff reference compare sector hashes, reference and file may be dumps or manifests *.mkl\n");
+	printf("         -batch           one summary line per file (FDL, firmware versions)\n");
+	printf("         -cache file      reuse batch results of unchanged files, results are stored in file\n");
+	printf("         -index file.idx  write the batch results into a fleet index\n");
+	printf("         -query \"terms\"   list the files of a fleet index *.idx matching all terms\n");
+	printf("                          serial= device= hw= hwcomp= date= fwnum= class= chip= value or lo-hi\n");
+	printf("                          fw=2.3.x mac=00:02:a2:xx:xx:xx fdl=valid|invalid|crcerror\n");
+	printf("         -audit           report duplicate MAC addresses, overlapping MAC ranges and serial numbers\n");
+	printf("         -mem MB          memory limit of the audit, default 256, larger batches are spilled to disk\n");
+	printf("         -compat          check the firmware device info of NXI, UPD and MXF against the FDL\n");
+	printf("         -matrix file     check the combination of FDL and firmware against a compatibility matrix\n");
+	printf("         -hboot           check the HBOOT header chain and image hashes of *.nai files\n");
+	printf("         -md5             check the MD5 of firmware files *.nxi, *.nxf, *.mxf, *.upd\n");
+	printf("         -pair            check the common CRC of NXI+NXE and NAI+NAE pairs\n");
+	printf("         -hwc             group the hardware configs of *.hwc, *.mwc and flash dumps\n");
+	printf("         -sqi             analyze an SQI flash dump *.bin (use case B, C), FAT file system and files\n");
+	printf("         -device          analyze all flash areas of a device image *.bin, INTFLASH0/1 and SQI flash\n");
+	printf("         -chip1 file      INTFLASH1 of the device image, instead of the part of the container\n");
+	printf("         -chip2 file      SQI flash of the device image, instead of the part of the container\n");
+	printf("         -tags            export the tag list of a legacy firmware *.nxf into <filename>.tags\n");
+	printf("         -tagdiff reference  list the firmware files whose tags differ from the reference\n");
+	printf("         -app             analyze an APP side flash dump *.bin, vector table, NAI and trailing data\n");
+	printf("         -triage          summary line per file like -batch, only FDL and firmware headers are read\n");
+	printf("         -physical        batch files are read in the order of their data on the disk, output in list order\n");
+	printf("         -direct          batch files are read with direct I/O, bypassing the page cache\n");
 
 	printf("\nflash image analysis requires specification of use case (command line parameter -u)\n"
 			"no automatic evaluation of FDL supported\n");
 
 	printf("\nflash image analysis requires an input file with suffix *.bin\n");
 
+	printf("\nbatch modes accept a list file *.lst instead of a single file, one file name per line\n");
+
 	printf("\nfile analysis depends on file suffix\n"
 			"no automatic file type detection supported\n"
 			"FDL generator supports use case A only\n");
 
 
 	printf("\nfile suffixs: \n");
-	printf("         .bin flash dump                               \n");
-	printf("         .nxi firmware                                 \n");
-	printf("         .fdl flash device label                       \n");
-	printf("         .mxf maintenance firmware                     \n");
-	printf("         .hwc hardware config                          \n");
-	printf("         .mwc hardware config for maintenance firmware \n");
-	printf("         .rdt remanent data                            \n");
-	printf("         .mng managmenet data                          \n");
-	printf("         .upd update area file                         \n");
-	printf("         .nai user firmware on APP side                \n");
-	printf("         .nxf legacy firmware netX 51, netx 52, etc.   \n");
+	for(i=0;i<sizeof(s_atFileFormat)/sizeof(FILE_FORMAT_T);i++){
+		printf("         %s %s\n",s_atFileFormat[i].szSuffix,s_atFileFormat[i].szDescription);
+	}
 }
 
 
@@ -179,27 +363,137 @@ int OpenOutFile(char *szFilename, char *szSuffix, FILE** hFile){
 }
 
 
+/* reads a complete file into a buffer, the caller frees the buffer */
+uint8_t* LoadFile(char* szFilename, size_t* pulSize){
+	FILE* hFile=NULL;
+	uint8_t* abBuffer=0;
+	long lSize=0;
 
-int WriteData(int iUseCase, char szSuffix[], FILE* hInFile, char* szFilename){
+	hFile=fopen(szFilename,"rb");
+	if(hFile==NULL){
+		printf("\nError opening file %s\n",szFilename);
+		return NULL;
+	}
+	fseek(hFile,0,SEEK_END);
+	lSize=ftell(hFile);
+	fseek(hFile,0,SEEK_SET);
+	if(lSize<0){
+		printf("error reading file %s\n",szFilename);
+		fclose(hFile);
+		return NULL;
+	}
 
-	uint8_t *abBuffer=0;
+	abBuffer=MemAlloc(lSize ? lSize : 1);
+	if(abBuffer==NULL){
+		printf("error malloc\n");
+		fclose(hFile);
+		return NULL;
+	}
+	if(fread(abBuffer,sizeof(uint8_t),lSize,hFile)!=(size_t)lSize){
+		printf("error reading file %s\n",szFilename);
+		free(abBuffer);
+		fclose(hFile);
+		return NULL;
+	}
+	fclose(hFile);
 
-	fpos_t offset=getOffset(iUseCase,szSuffix);
-	size_t size=getLength(iUseCase,szSuffix);
-	FILE* hOutFile=getFileHandle(iUseCase,szSuffix);
+	*pulSize=(size_t)lSize;
+	return abBuffer;
+}
 
-	printf("write offset:0x%05x, size:0x%05x [%dKB] into %s%s\n",(int)offset,(int)size,(int)size/1024,szFilename,getSuffix(iUseCase, hOutFile));
 
-	abBuffer=malloc(size);
-	if(abBuffer==NULL){
-		printf("error malloc\n");
-		return EXIT_FAILURE;
+
+/* data of an opened file already loaded into memory, reads of the file are served from it */
+static FILE* s_hAttachedFile=NULL;
+static const uint8_t* s_pabAttachedData=0;
+static size_t s_ulAttachedSize=0;
+
+/* scratch memory of the analyzers, released when the next file is attached or detached
+ * or by FileScratchRelease, main thread only, batch jobs allocate their own buffers */
+#define FILE_SCRATCH_BLOCK 0x10000
+static FILE_ARENA_T s_tFileArena={0,FILE_SCRATCH_BLOCK,0,FILE_SCRATCH_BLOCK};
+
+/* pabData NULL detaches the data */
+void AttachFileData(FILE* hFile, const uint8_t* pabData, size_t ulSize){
+	s_hAttachedFile=pabData!=NULL ? hFile : NULL;
+	s_pabAttachedData=pabData;
+	s_ulAttachedSize=ulSize;
+	ArenaReset(&s_tFileArena);
+}
+
+/* zeroed analyzer buffer valid until the file is detached or the scratch released, nothing to free,
+ * reads beyond the end of a truncated file leave zeros instead of stale data */
+void* FileScratch(size_t ulSize){
+	void* pvData=ArenaAlloc(&s_tFileArena,ulSize ? ulSize : 1,sizeof(uint64_t));
+	if(pvData!=NULL)
+		memset(pvData,0,ulSize);
+	return pvData;
+}
+
+/* releases the scratch memory, for analyses without attached data after each area,
+ * the block is kept for the next area */
+void FileScratchRelease(void){
+	ArenaReset(&s_tFileArena);
+}
+
+static void FileScratchFree(void){
+	ArenaFree(&s_tFileArena);
+}
+
+/* reads from the attached data of the file if there is any, from the file otherwise */
+size_t ReadFileData(FILE* hFile, fpos_t offset, void* pvBuffer, size_t ulSize){
+	if(hFile!=NULL && hFile==s_hAttachedFile){
+		uint64_t ullOffset=(uint64_t)offset;
+		if(ullOffset>=s_ulAttachedSize)
+			return 0;
+		ulSize=HIL_MIN(ulSize,s_ulAttachedSize-(size_t)ullOffset);
+		memcpy(pvBuffer,s_pabAttachedData+ullOffset,ulSize);
+		return ulSize;
 	}
-	fsetpos(hInFile,&offset);
-	fread(abBuffer,sizeof(uint8_t),size,hInFile);
-	fwrite(abBuffer,sizeof(uint8_t),size,hOutFile);
-	free(abBuffer);
+	if(fsetpos(hFile,&offset))
+		return 0;
+	return fread(pvBuffer,sizeof(uint8_t),ulSize,hFile);
+}
+
+/* the attached data of the file from offset on without a copy, NULL if there is none */
+const uint8_t* AttachedFileData(FILE* hFile, fpos_t offset, size_t* pulSize){
+	uint64_t ullOffset=(uint64_t)offset;
+
+	if(hFile==NULL || hFile!=s_hAttachedFile || ullOffset>s_ulAttachedSize)
+		return NULL;
+	*pulSize=s_ulAttachedSize-(size_t)ullOffset;
+	return s_pabAttachedData+ullOffset;
+}
+
+long GetFileDataSize(FILE* hFile){
+	if(hFile!=NULL && hFile==s_hAttachedFile)
+		return (long)s_ulAttachedSize;
+	fseek(hFile,0,SEEK_END);
+	return ftell(hFile);
+}
+
+
 
+/* file type by suffix, no content based detection */
+FILE_TYPE_E GetFileType(char* szFilename){
+	const FILE_FORMAT_T* ptFormat=GetFileFormat(szFilename);
+
+	return ptFormat!=NULL ? ptFormat->eType : FILETYPE_UNKNOWN;
+}
+
+
+
+/* writes one area of the dump into its split file */
+int WriteData(const FILE_T* ptArea, const uint8_t* pabDump, size_t ulDumpSize, char* szFilename){
+	size_t offset=HIL_MIN(ptArea->ulOffset,ulDumpSize);
+	size_t size=HIL_MIN(ptArea->ulLength,ulDumpSize-offset);
+
+	printf("write offset:0x%05x, size:0x%05x [%dKB] into %s%s\n",(int)offset,(int)size,(int)size/1024,szFilename,ptArea->szSuffix);
+
+	if(fwrite(pabDump+offset,sizeof(uint8_t),size,ptArea->hFile)!=size){
+		printf("error writing file %s%s\n",szFilename,ptArea->szSuffix);
+		return EXIT_FAILURE;
+	}
 	return 0;
 }
 
@@ -215,13 +509,12 @@ int AnalyzeNxfBootHeader(fpos_t offset, FILE* hInFile){
 	HIL_FILE_BOOT_HEADER_V1_0_T* ptBootHeader=0;
 
 
-	abBuffer=malloc(size);
+	abBuffer=FileScratch(size);
 	if(abBuffer==NULL){
 		printf("error malloc\n");
 		return EXIT_FAILURE;
 	}
-	fsetpos(hInFile,&offset);
-	fread(abBuffer,sizeof(uint8_t),size,hInFile);
+	ReadFileData(hInFile,offset,abBuffer,size);
 	ptBootHeader=(HIL_FILE_BOOT_HEADER_V1_0_T*)abBuffer;
 	abSignature=(uint8_t*)&ptBootHeader->ulSignature;
 
@@ -244,7 +537,6 @@ int AnalyzeNxfBootHeader(fpos_t offset, FILE* hInFile){
 
 
 
-	free(abBuffer);
 	return 0;
 }
 
@@ -259,13 +551,12 @@ int AnalyzeNaiBootHeader(fpos_t offset, FILE* hInFile){
 	HIL_FILE_BOOT_HEADER_NAI_NAE_V1_0_T* ptBootHeader=0;
 
 
-	abBuffer=malloc(size);
+	abBuffer=FileScratch(size);
 	if(abBuffer==NULL){
 		printf("error malloc\n");
 		return EXIT_FAILURE;
 	}
-	fsetpos(hInFile,&offset);
-	fread(abBuffer,sizeof(uint8_t),size,hInFile);
+	ReadFileData(hInFile,offset,abBuffer,size);
 	ptBootHeader=(HIL_FILE_BOOT_HEADER_NAI_NAE_V1_0_T*)abBuffer;
 	abSignature=(uint8_t*)&ptBootHeader->ulSignature;
 
@@ -281,7 +572,6 @@ int AnalyzeNaiBootHeader(fpos_t offset, FILE* hInFile){
 	printf("App Checksum:    0x%08x\n",ptBootHeader->ulAppChecksum);
 	printf("Header Checksum: 0x%08x\n",ptBootHeader->ulBootHeaderChecksum);
 
-	free(abBuffer);
 	return 0;
 }
 
@@ -296,13 +586,12 @@ int AnalyzeNaiHBoot_BootHeader(fpos_t offset, FILE* hInFile){
 	HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T* ptBootHeader=0;
 
 
-	abBuffer=malloc(size);
+	abBuffer=FileScratch(size);
 	if(abBuffer==NULL){
 		printf("error malloc\n");
 		return EXIT_FAILURE;
 	}
-	fsetpos(hInFile,&offset);
-	fread(abBuffer,sizeof(uint8_t),size,hInFile);
+	ReadFileData(hInFile,offset,abBuffer,size);
 	ptBootHeader=(HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T*)abBuffer;
 	abSignature=(uint8_t*)&ptBootHeader->ulSignature;
 
@@ -319,8 +608,8 @@ int AnalyzeNaiHBoot_BootHeader(fpos_t offset, FILE* hInFile){
 	printf("Signature:      0x%08x - ",ptBootHeader->ulSignature);
 	printf("%c%c%c%c\n",(char)abSignature[0],(char)abSignature[1],(char)abSignature[2],(char)abSignature[3]);
 	printf("Boot Checksum:  0x%08x\n",ptBootHeader->ulBootChksm);
+	AnalyzeHBootChain(offset-HBOOT_NAI_HEADER_OFFSET,hInFile,ptBootHeader);
 
-	free(abBuffer);
 	return 0;
 }
 
@@ -329,7 +618,7 @@ int AnalyzeNaiHBoot_BootHeader(fpos_t offset, FILE* hInFile){
 
 
 
-int AnalyzeFHV3CommonHeader(fpos_t offset, FILE* hInFile){
+int AnalyzeFHV3CommonHeader(fpos_t offset, FILE* hInFile, int iMaxModuleInfos){
 	int i=0;
 	uint8_t *abBuffer=0;
 	uint8_t bNumModuleInfos=0;
@@ -340,13 +629,12 @@ int AnalyzeFHV3CommonHeader(fpos_t offset, FILE* hInFile){
 	HIL_FILE_MODULE_INFO_V1_0_T* ptModuleInfo=0;
 
 
-	abBuffer=malloc(size);
+	abBuffer=FileScratch(size);
 	if(abBuffer==NULL){
 		printf("error malloc\n");
 		return EXIT_FAILURE;
 	}
-	fsetpos(hInFile,&offset);
-	fread(abBuffer,sizeof(uint8_t),size,hInFile);
+	ReadFileData(hInFile,offset,abBuffer,size);
 	ptCommonHeader=(HIL_FILE_COMMON_HEADER_V3_0_T*)abBuffer;
 
 	printf("\n--------------------------------------\nV3 COMMON HEADER ANALYSIS \n");
@@ -354,28 +642,31 @@ int AnalyzeFHV3CommonHeader(fpos_t offset, FILE* hInFile){
 	printf("--------------------------------------\n");
 	printf("Header CRC32:   0x%08x\n",ptCommonHeader->ulHeaderCRC32);
 	printf("Common CRC32:   0x%08x\n",ptCommonHeader->ulCommonCRC32);
+	printf("MD5:            ");
+	for(i=0;i<MD5_DIGEST_SIZE;i++){
+		printf("%02x",((uint8_t*)ptCommonHeader->aulMD5)[i]);
+	}
+	printf("\n");
 	printf("Number Modules: %d\n",ptCommonHeader->bNumModuleInfos);
 
 	bNumModuleInfos=ptCommonHeader->bNumModuleInfos;
-	free(abBuffer);
+	if(bNumModuleInfos>iMaxModuleInfos) {
+		bNumModuleInfos=iMaxModuleInfos;
+	}
 
 
 	if(bNumModuleInfos){
 		offset=offset+sizeof(HIL_FILE_COMMON_HEADER_V3_0_T)+sizeof(HIL_FILE_DEVICE_INFO_V1_0_T);
 		size=bNumModuleInfos * sizeof(HIL_FILE_MODULE_INFO_V1_0_T);
-		abBuffer=malloc(size);
+		abBuffer=FileScratch(size);
 		if(abBuffer==NULL){
 			printf("error malloc\n");
 			return EXIT_FAILURE;
 		}
-		fsetpos(hInFile,&offset);
-		fread(abBuffer,sizeof(uint8_t),size,hInFile);
+		ReadFileData(hInFile,offset,abBuffer,size);
 		ptModuleInfo=(HIL_FILE_MODULE_INFO_V1_0_T*)abBuffer;
 
 		printf("--------\nMODULES\n--------\n");
-		if(bNumModuleInfos>6) {
-			bNumModuleInfos=6;
-		}
 
 		for(i=0;i<bNumModuleInfos;i++){
 			if(ptModuleInfo[i].usProtocolClass!=0 && ptModuleInfo[i].usProtocolClass!=0xFFFF){
@@ -386,7 +677,6 @@ int AnalyzeFHV3CommonHeader(fpos_t offset, FILE* hInFile){
 				printf("%s\n",LookupComClassCode(ptModuleInfo[i].usCommunicationClass));
 			}
 		}
-		free(abBuffer);
 	}
 
 
@@ -405,13 +695,12 @@ int AnalyzeFHV3DeviceInfo(fpos_t offset, FILE* hInFile){
 	HIL_FILE_DEVICE_INFO_V1_0_T* ptDeviceInfo=0;
 
 
-	abBuffer=malloc(size);
+	abBuffer=FileScratch(size);
 	if(abBuffer==NULL){
 		printf("error malloc\n");
 		return EXIT_FAILURE;
 	}
-	fsetpos(hInFile,&offset);
-	fread(abBuffer,sizeof(uint8_t),size,hInFile);
+	ReadFileData(hInFile,offset,abBuffer,size);
 	ptDeviceInfo=(HIL_FILE_DEVICE_INFO_V1_0_T*)abBuffer;
 
 	printf("\n--------------------------------------\nV3 DEVICE INFO ANALYSIS \n");
@@ -430,7 +719,6 @@ int AnalyzeFHV3DeviceInfo(fpos_t offset, FILE* hInFile){
 	printf("Serial Number:  %d\n",ptDeviceInfo->ulSerialNumber);
 
 
-	free(abBuffer);
 
 	return 0;
 
@@ -442,9 +730,11 @@ int AnalyzeNxfFileHeader(fpos_t offset, FILE* hInFile){
 
 	AnalyzeNxfBootHeader(offset,hInFile);
 	offset+=sizeof(HIL_FILE_BOOT_HEADER_V1_0_T);
-	AnalyzeFHV3CommonHeader(offset,hInFile);
+	AnalyzeFHV3CommonHeader(offset,hInFile,6);
 	offset+=sizeof(HIL_FILE_COMMON_HEADER_V3_0_T);
 	AnalyzeFHV3DeviceInfo(offset,hInFile);
+	offset-=sizeof(HIL_FILE_BOOT_HEADER_V1_0_T)+sizeof(HIL_FILE_COMMON_HEADER_V3_0_T);
+	AnalyzeTagList(offset,hInFile);
 
 	return 0;
 }
@@ -453,14 +743,108 @@ int AnalyzeNxfFileHeader(fpos_t offset, FILE* hInFile){
 int AnalyzeNaiFileHeader(fpos_t offset, FILE* hInFile){
 
 
-	offset+=448; // first 448 bytes: vector table
+	offset+=HBOOT_NAI_HEADER_OFFSET; // first 448 bytes: vector table
 	AnalyzeNaiHBoot_BootHeader(offset,hInFile);
 	offset+=sizeof(HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T);
 	AnalyzeNaiBootHeader(offset,hInFile);
 	offset+=sizeof(HIL_FILE_BOOT_HEADER_NAI_NAE_V1_0_T);
-	AnalyzeFHV3CommonHeader(offset,hInFile);
+	AnalyzeFHV3CommonHeader(offset,hInFile,6);
+	offset+=sizeof(HIL_FILE_COMMON_HEADER_V3_0_T);
+	AnalyzeFHV3DeviceInfo(offset,hInFile);
+
+	return 0;
+}
+
+
+int AnalyzeNaeFileHeader(fpos_t offset, FILE* hInFile){
+
+	AnalyzeNaiBootHeader(offset,hInFile);
+	offset+=sizeof(HIL_FILE_BOOT_HEADER_NAI_NAE_V1_0_T);
+	AnalyzeFHV3CommonHeader(offset,hInFile,6);
+	offset+=sizeof(HIL_FILE_COMMON_HEADER_V3_0_T);
+	AnalyzeFHV3DeviceInfo(offset,hInFile);
+
+	return 0;
+}
+
+
+
+/* module info of option modules and databases, all fields of the module */
+int AnalyzeFHV3ModuleInfo(fpos_t offset, FILE* hInFile, int iNumModules){
+	HIL_FILE_MODULE_INFO_V1_0_T tModuleInfo;
+	int i=0;
+	int j=0;
+
+	for(i=0;i<iNumModules;i++){
+		if(ReadFileData(hInFile,offset,&tModuleInfo,sizeof(tModuleInfo))!=sizeof(tModuleInfo)){
+			printf("error reading module info %d\n",i);
+			return EXIT_FAILURE;
+		}
+
+		printf("\n--------------------------------------\nV3 MODULE INFO ANALYSIS \n");
+		printf("check offset:   0x%05x\n",(int)offset);
+		printf("--------------------------------------\n");
+		printf("Version:        %d.%d\n",tModuleInfo.ulStructVersion>>16,tModuleInfo.ulStructVersion&0xFFFF);
+		printf("Comm. Class:    0x%04x - ",tModuleInfo.usCommunicationClass);
+		printf("%s\n",LookupComClassCode(tModuleInfo.usCommunicationClass));
+		printf("Protocol Class: 0x%04x - ",tModuleInfo.usProtocolClass);
+		printf("%s\n",LookupProtClassCode(tModuleInfo.usProtocolClass));
+		printf("DB Version:     %d.%d\n",tModuleInfo.ulDBVersion>>16,tModuleInfo.ulDBVersion&0xFFFF);
+		printf("Channel Sizes: ");
+		for(j=0;j<4 && tModuleInfo.ausChannelSizes[j];j++){
+			printf(" %d",tModuleInfo.ausChannelSizes[j]);
+		}
+		printf("\n");
+		printf("HW Options:     0x%04x 0x%04x 0x%04x 0x%04x \n",tModuleInfo.ausHwOptions[0],tModuleInfo.ausHwOptions[1],tModuleInfo.ausHwOptions[2],tModuleInfo.ausHwOptions[3]);
+		printf("HW Assignments:");
+		for(j=0;j<4;j++){
+			if(tModuleInfo.abHwAssignments[j]==0xFF)
+				printf(" any");
+			else
+				printf(" xC%d",tModuleInfo.abHwAssignments[j]);
+		}
+		printf("\n");
+
+		offset+=sizeof(HIL_FILE_MODULE_INFO_V1_0_T);
+	}
+	return 0;
+}
+
+
+/* files with DEFAULT header: NXO, NXD, NXL, NXB and NXM,
+ * iMaxModuleInfos is the number of module infos of the header layout of the format */
+int AnalyzeDefaultFileHeader(fpos_t offset, FILE* hInFile, int iMaxModuleInfos){
+	HIL_FILE_DEFAULT_HEADER_V1_0_T tDefaultHeader;
+	HIL_FILE_COMMON_HEADER_V3_0_T tCommonHeader;
+	uint8_t* abCookie=(uint8_t*)&tDefaultHeader.ulMagicCookie;
+	int i=0;
+
+	if(ReadFileData(hInFile,offset,&tDefaultHeader,sizeof(tDefaultHeader))!=sizeof(tDefaultHeader)
+			|| ReadFileData(hInFile,offset+sizeof(tDefaultHeader),&tCommonHeader,sizeof(tCommonHeader))!=sizeof(tCommonHeader)){
+		printf("error reading file header\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("\n--------------------------------------\nV3 DEFAULT HEADER ANALYSIS \n");
+	printf("check offset:   0x%05x\n",(int)offset);
+	printf("--------------------------------------\n");
+	printf("Cookie:          0x%08x - ",tDefaultHeader.ulMagicCookie);
+	printf("%s [%c%c%c%c]\n",LookupCode(tDefaultHeader.ulMagicCookie),(char)abCookie[0],(char)abCookie[1],(char)abCookie[2],(char)abCookie[3]);
+	for(i=0;i<15;i++){
+		if(tDefaultHeader.aulReserved[i]){
+			printf("Reserved:        not zero\n");
+			break;
+		}
+	}
+	if(tCommonHeader.bNumModuleInfos>iMaxModuleInfos)
+		printf("Module Infos:    %d, the header layout holds %d\n",tCommonHeader.bNumModuleInfos,iMaxModuleInfos);
+
+	offset+=sizeof(HIL_FILE_DEFAULT_HEADER_V1_0_T);
+	AnalyzeFHV3CommonHeader(offset,hInFile,iMaxModuleInfos);
 	offset+=sizeof(HIL_FILE_COMMON_HEADER_V3_0_T);
 	AnalyzeFHV3DeviceInfo(offset,hInFile);
+	offset+=sizeof(HIL_FILE_DEVICE_INFO_V1_0_T);
+	AnalyzeFHV3ModuleInfo(offset,hInFile,HIL_MIN(tCommonHeader.bNumModuleInfos,iMaxModuleInfos));
 
 	return 0;
 }
@@ -480,13 +864,12 @@ int AnalyzeFDL(fpos_t offset, FILE* hInFile){
 
 	HIL_PRODUCT_DATA_LABEL_T* ptFDL=0;
 
-	abBuffer=malloc(size);
+	abBuffer=FileScratch(size);
 	if(abBuffer==NULL){
 		printf("error malloc\n");
 		return EXIT_FAILURE;
 	}
-	fsetpos(hInFile,&offset);
-	fread(abBuffer,sizeof(uint8_t),size,hInFile);
+	ReadFileData(hInFile,offset,abBuffer,size);
 	ptFDL=(HIL_PRODUCT_DATA_LABEL_T*)abBuffer;
 
 	printf("\n--------------------------------------\nFDL ANALYSIS\n");
@@ -558,7 +941,6 @@ int AnalyzeFDL(fpos_t offset, FILE* hInFile){
 	}
 
 
-	free(abBuffer);
 
 	return 0;
 }
@@ -582,7 +964,7 @@ int CreateFDL(char* szFileName, int iUseCase){
 
 	HIL_PRODUCT_DATA_LABEL_T* ptFDL=0;
 
-	abBuffer=malloc(size);
+	abBuffer=FileScratch(size);
 	if(abBuffer==NULL){
 		printf("error malloc\n");
 		return EXIT_FAILURE;
@@ -749,7 +1131,6 @@ int CreateFDL(char* szFileName, int iUseCase){
 	}
 	fclose(hOutFile);
 
-	free(abBuffer);
 	return EXIT_SUCCESS;
 
 }
@@ -776,17 +1157,51 @@ int CreateFDL(char* szFileName, int iUseCase){
 int main(int argc, char *argv[])
 {
 	FILE *hInFile=NULL;
+	uint8_t* pabFileData=0;
+	size_t ulFileDataSize=0;
 	char *szFilename=NULL;
 	int i;
 	int iRes=0;
 	int iUseCase=0;
 	FILE_TYPE_E eFileType=FILETYPE_UNKNOWN;
 	char szInFileSuffix[5]={0};
+	char *szDiffRefFilename=NULL;
+	char *szGoldenFilename=NULL;
+	char *szMerkleRefFilename=NULL;
+	char *szCacheFilename=NULL;
+	char *szIndexFilename=NULL;
+	char *szQuery=NULL;
+	char *szMatrixFilename=NULL;
+	char **aszBatchFiles=NULL;
+	int iNumBatchFiles=0;
+	int iNumThreads=0;
+	uint32_t ulMemoryMB=0;
+	long lHeapAllocs=0;
 
 
 	bool bSplitFlashImage=false;
 	bool bCreateFDL=false;
-
+	bool bFillLevel=false;
+	bool bCreateMerkle=false;
+	bool bBatchSummary=false;
+	bool bAudit=false;
+	bool bCompat=false;
+	bool bHBoot=false;
+	bool bMd5=false;
+	bool bPair=false;
+	bool bHwc=false;
+	bool bSqiDump=false;
+	bool bDevice=false;
+	char *aszChipFiles[3]={NULL,NULL,NULL};
+	bool bExportTags=false;
+	bool bAppDump=false;
+	bool bTriage=false;
+	const FILE_FORMAT_T* ptFormat=NULL;
+	char *szTagRefFilename=NULL;
+
+
+	/* the analyzer scratch is reset after each file or area and freed once at exit */
+	atexit(FileScratchFree);
 
 	if( argc == 1 )
 	{
@@ -797,11 +1212,127 @@ int main(int argc, char *argv[])
 		for(i=1;i<(argc-1);i++){
 			if(!strcmp(argv[i],"-s")){
 				bSplitFlashImage=true;
-				break;
+				continue;
 			}
 			if(!strcmp(argv[i],"-fdl")){
 				bCreateFDL=true;
-				break;
+				continue;
+			}
+			if(!strcmp(argv[i],"-fill")){
+				bFillLevel=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-merkle")){
+				bCreateMerkle=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-batch")){
+				bBatchSummary=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-cache") && i+1<(argc-1)){
+				szCacheFilename=argv[++i];
+				bBatchSummary=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-compat")){
+				bCompat=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-matrix") && i+1<(argc-1)){
+				szMatrixFilename=argv[++i];
+				bCompat=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-hboot")){
+				bHBoot=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-pair")){
+				bPair=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-md5")){
+				bMd5=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-hwc")){
+				bHwc=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-sqi")){
+				bSqiDump=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-device")){
+				bDevice=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-chip1") && i+1<(argc-1)){
+				aszChipFiles[1]=argv[++i];
+				bDevice=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-chip2") && i+1<(argc-1)){
+				aszChipFiles[2]=argv[++i];
+				bDevice=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-app")){
+				bAppDump=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-triage")){
+				bTriage=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-physical")){
+				BatchReadSetPhysicalOrder(true);
+				continue;
+			}
+			if(!strcmp(argv[i],"-direct")){
+				BatchReadSetDirect(true);
+				continue;
+			}
+			if(!strcmp(argv[i],"-tags")){
+				bExportTags=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-tagdiff") && i+1<(argc-1)){
+				szTagRefFilename=argv[++i];
+				continue;
+			}
+			if(!strcmp(argv[i],"-audit")){
+				bAudit=true;
+				continue;
+			}
+			if(!strcmp(argv[i],"-mem") && i+1<(argc-1)){
+				ulMemoryMB=(uint32_t)atoi(argv[++i]);
+				continue;
+			}
+			if(!strcmp(argv[i],"-index") && i+1<(argc-1)){
+				szIndexFilename=argv[++i];
+				continue;
+			}
+			if(!strcmp(argv[i],"-query") && i+1<(argc-1)){
+				szQuery=argv[++i];
+				continue;
+			}
+			if(!strcmp(argv[i],"-mdiff") && i+1<(argc-1)){
+				szMerkleRefFilename=argv[++i];
+				continue;
+			}
+			if(!strcmp(argv[i],"-diff") && i+1<(argc-1)){
+				szDiffRefFilename=argv[++i];
+				continue;
+			}
+			if(!strcmp(argv[i],"-comply") && i+1<(argc-1)){
+				szGoldenFilename=argv[++i];
+				continue;
+			}
+			if(!strcmp(argv[i],"-j") && i+1<(argc-1)){
+				iNumThreads=atoi(argv[++i]);
+				continue;
 			}
 			if(!strcmp(argv[i],"-u")){
 				switch (argv[++i][0]){
@@ -819,7 +1350,7 @@ int main(int argc, char *argv[])
 					printHelp(argv[0]);
 					return EXIT_FAILURE;
 				}
-				break;
+				continue;
 			}
 			if(!strcmp(argv[i],"-h")){
 				printHelp(argv[0]);
@@ -838,61 +1369,177 @@ int main(int argc, char *argv[])
 		}
 
 
-		if(strcmp(szInFileSuffix,".bin")==0 || strcmp(szInFileSuffix,".BIN")==0){
-			eFileType=FILETYPE_FLASHDUMP;
+		ptFormat=GetFileFormat(szFilename);
+		eFileType=ptFormat!=NULL ? ptFormat->eType : FILETYPE_UNKNOWN;
+
+		if(eFileType==FILETYPE_UNKNOWN) {
+			printf("Error: unknown file extension %s\n",szInFileSuffix);
+			return EXIT_FAILURE;
 		}
-		if(strcmp(szInFileSuffix,".fdl")==0 || strcmp(szInFileSuffix,".FDL")==0){
-			eFileType=FILETYPE_FDL;
+
+	}
+
+
+
+	if(bCreateFDL){
+		iRes=CreateFDL(szFilename, iUseCase);
+		if(iRes){
+			printf("Error: FDL creation failed: 0x%08x\n",iRes);
+			return EXIT_FAILURE;
 		}
-		if(strcmp(szInFileSuffix,".nxi")==0 || strcmp(szInFileSuffix,".NXI")==0){
-			eFileType=FILETYPE_NXI;
+		else {
+			printf("OK: FDL created\n");
+			return EXIT_SUCCESS;
 		}
-		if(strcmp(szInFileSuffix,".mxf")==0 || strcmp(szInFileSuffix,".MXF")==0){
-			eFileType=FILETYPE_MXF;
+	}
+
+
+	if(szGoldenFilename!=NULL){
+		if(eFileType==FILETYPE_LIST){
+			aszBatchFiles=BatchLoadList(szFilename,&iNumBatchFiles);
+			if(aszBatchFiles==NULL){
+				return EXIT_FAILURE;
+			}
 		}
-		if(strcmp(szInFileSuffix,".hwc")==0 || strcmp(szInFileSuffix,".HWC")==0){
-			eFileType=FILETYPE_HWC;
+		else if(eFileType==FILETYPE_FLASHDUMP){
+			aszBatchFiles=&szFilename;
+			iNumBatchFiles=1;
 		}
-		if(strcmp(szInFileSuffix,".mwc")==0 || strcmp(szInFileSuffix,".MWC")==0){
-			eFileType=FILETYPE_MWC;
+		else {
+			printf("Error: compliance check requires flash dump files *.bin or a list file *.lst\n");
+			return EXIT_FAILURE;
 		}
-		if(strcmp(szInFileSuffix,".rdt")==0 || strcmp(szInFileSuffix,".RDT")==0){
-			eFileType=FILETYPE_RDT;
+		iRes=CheckCompliance(szGoldenFilename, aszBatchFiles, iNumBatchFiles, iUseCase, iNumThreads);
+		if(eFileType==FILETYPE_LIST){
+			BatchFreeList(aszBatchFiles,iNumBatchFiles);
 		}
-		if(strcmp(szInFileSuffix,".mng")==0 || strcmp(szInFileSuffix,".MNG")==0){
-			eFileType=FILETYPE_MNG;
+		return iRes ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	if(szQuery!=NULL){
+		if(eFileType!=FILETYPE_INDEX){
+			printf("Error: query requires a fleet index file *.idx\n");
+			return EXIT_FAILURE;
 		}
-		if(strcmp(szInFileSuffix,".upd")==0 || strcmp(szInFileSuffix,".UPD")==0){
-			eFileType=FILETYPE_UPD;
+		iRes=QueryFleetIndex(szFilename, szQuery);
+		return iRes ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	if(eFileType==FILETYPE_INDEX){
+		printf("Error: fleet index files are supported by -query only\n");
+		return EXIT_FAILURE;
+	}
+
+	if(bBatchSummary || bTriage || bAudit || bCompat || bHBoot || bMd5 || bPair || bHwc || szTagRefFilename!=NULL || szIndexFilename!=NULL || (bAppDump && eFileType==FILETYPE_LIST)){
+		if(eFileType==FILETYPE_LIST){
+			aszBatchFiles=BatchLoadList(szFilename,&iNumBatchFiles);
+			if(aszBatchFiles==NULL){
+				return EXIT_FAILURE;
+			}
 		}
-		if(strcmp(szInFileSuffix,".nai")==0 || strcmp(szInFileSuffix,".NAI")==0){
-			eFileType=FILETYPE_NAI;
+		else {
+			aszBatchFiles=&szFilename;
+			iNumBatchFiles=1;
+		}
+		lHeapAllocs=MemHeapAllocs();
+		if(bAppDump){
+			iRes=AnalyzeAppDumps(aszBatchFiles, iNumBatchFiles, iNumThreads);
+		}
+		else if(bHBoot){
+			iRes=VerifyHBootHashes(aszBatchFiles, iNumBatchFiles, iNumThreads);
+		}
+		else if(bPair){
+			iRes=CheckFirmwarePairs(aszBatchFiles, iNumBatchFiles, iNumThreads);
+		}
+		else if(bMd5){
+			iRes=VerifyFirmwareMd5(aszBatchFiles, iNumBatchFiles, iNumThreads);
+		}
+		else if(bHwc){
+			iRes=GroupHardwareConfigs(aszBatchFiles, iNumBatchFiles, iUseCase, iNumThreads);
+		}
+		else if(szTagRefFilename!=NULL){
+			iRes=DiffTagLists(szTagRefFilename, aszBatchFiles, iNumBatchFiles, iNumThreads);
+		}
+		else if(bCompat){
+			iRes=CheckCompatibility(aszBatchFiles, iNumBatchFiles, iUseCase, iNumThreads, szCacheFilename, szMatrixFilename);
+		}
+		else if(bAudit){
+			iRes=AuditUniqueness(aszBatchFiles, iNumBatchFiles, iUseCase, iNumThreads, szCacheFilename, ulMemoryMB, szFilename);
 		}
+		else if(szIndexFilename!=NULL){
+			iRes=CreateFleetIndex(szIndexFilename, aszBatchFiles, iNumBatchFiles, iUseCase, iNumThreads, szCacheFilename);
+		}
+		else if(bTriage){
+			iRes=TriageBatch(aszBatchFiles, iNumBatchFiles, iUseCase, iNumThreads);
+		}
+		else {
+			iRes=AnalyzeBatch(aszBatchFiles, iNumBatchFiles, iUseCase, iNumThreads, szCacheFilename);
+		}
+		/* a batch without heap allocations per file shows the same count for any number of files */
+		printf("\nheap allocs:    %ld [%d files]\n",MemHeapAllocs()-lHeapAllocs,iNumBatchFiles);
 
-		if(strcmp(szInFileSuffix,".nxf")==0 || strcmp(szInFileSuffix,".NXF")==0){
-			eFileType=FILETYPE_NXF;
+		if(eFileType==FILETYPE_LIST){
+			BatchFreeList(aszBatchFiles,iNumBatchFiles);
 		}
+		return iRes ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
 
+	if(eFileType==FILETYPE_LIST){
+		printf("Error: list files are supported in batch modes only\n");
+		return EXIT_FAILURE;
+	}
 
-		if(eFileType==FILETYPE_UNKNOWN) {
-			printf("Error: unknown file extension %s\n",szInFileSuffix);
-			return EXIT_FAILURE;
-		}
+	if(szMerkleRefFilename!=NULL){
+		iRes=DiffMerkle(szMerkleRefFilename, szFilename, iUseCase);
+		return iRes ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
 
+	if(eFileType==FILETYPE_MANIFEST){
+		printf("Error: manifest files are supported by -mdiff only\n");
+		return EXIT_FAILURE;
 	}
 
+	if(bCreateMerkle){
+		iRes=CreateMerkleManifest(szFilename, iUseCase);
+		return iRes ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
 
 
-	if(bCreateFDL){
-		iRes=CreateFDL(szFilename, iUseCase);
-		if(iRes){
-			printf("Error: FDL creation failed: 0x%08x\n",iRes);
+	if(bDevice){
+		if(eFileType!=FILETYPE_FLASHDUMP){
+			printf("Error: device image analysis requires a file *.bin\n");
 			return EXIT_FAILURE;
 		}
-		else {
-			printf("OK: FDL created\n");
-			return EXIT_SUCCESS;
+		aszChipFiles[0]=szFilename;
+		iRes=AnalyzeDeviceImage(aszChipFiles, iUseCase, iNumThreads);
+		return iRes ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	if(bAppDump){
+		if(eFileType!=FILETYPE_FLASHDUMP){
+			printf("Error: APP side flash dump analysis requires a file *.bin\n");
+			return EXIT_FAILURE;
 		}
+		iRes=AnalyzeAppDump(szFilename);
+		return iRes ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	if(bSqiDump){
+		if(eFileType!=FILETYPE_FLASHDUMP){
+			printf("Error: SQI flash dump analysis requires a file *.bin\n");
+			return EXIT_FAILURE;
+		}
+		iRes=AnalyzeSqiDump(szFilename, iUseCase, iNumThreads);
+		return iRes ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	if(szDiffRefFilename!=NULL){
+		if(eFileType!=FILETYPE_FLASHDUMP){
+			printf("Error: diff requires flash dump files *.bin\n");
+			return EXIT_FAILURE;
+		}
+		iRes=DiffFlashDumps(szDiffRefFilename, szFilename, iUseCase);
+		return iRes ? EXIT_FAILURE : EXIT_SUCCESS;
 	}
 
 
@@ -902,6 +1549,10 @@ int main(int argc, char *argv[])
 		return EXIT_FAILURE;
 	}
 
+	/* the file is read once, split files, header analysis and fill level work on the same buffer */
+	pabFileData=LoadFile(szFilename,&ulFileDataSize);
+	AttachFileData(hInFile,pabFileData,ulFileDataSize);
+
 	printf("\nanalyze ");
 	if(eFileType == FILETYPE_FLASHDUMP) {
 		printf("FLASH DUMP file");
@@ -929,25 +1580,24 @@ int main(int argc, char *argv[])
 	if(bSplitFlashImage==true && (eFileType == FILETYPE_FLASHDUMP)){
 
 		printf("create separate files\n");
-
-		for(i=0;i<sizeof(tFlashDumpFile[iUseCase])/sizeof(FILE_T);i++){
-			iRes=OpenOutFile(szFilename,tFlashDumpFile[iUseCase][i].szSuffix,&tFlashDumpFile[iUseCase][i].hFile);
+		if(pabFileData==NULL){
+			printf("error reading file %s, no separate files created\n",szFilename);
+			fclose(hInFile);
+			return EXIT_FAILURE;
 		}
 
-
-		WriteData(iUseCase, ".hwc", hInFile, szFilename);
-		WriteData(iUseCase, ".fdl", hInFile, szFilename);
-		WriteData(iUseCase, ".nxi", hInFile, szFilename);
-		WriteData(iUseCase, ".upd", hInFile, szFilename);
-		WriteData(iUseCase, ".mwc", hInFile, szFilename);
-		WriteData(iUseCase, ".mxf", hInFile, szFilename);
-		WriteData(iUseCase, ".rdt", hInFile, szFilename);
-		WriteData(iUseCase, ".mng", hInFile, szFilename);
-
+		/* unused entries of the use case have no length and no file */
 		for(i=0;i<sizeof(tFlashDumpFile[iUseCase])/sizeof(FILE_T);i++){
-			iRes=fclose(tFlashDumpFile[iUseCase][i].hFile);
+			FILE_T* ptArea=&tFlashDumpFile[iUseCase][i];
+
+			if(ptArea->ulLength==0)
+				continue;
+			if(OpenOutFile(szFilename,ptArea->szSuffix,&ptArea->hFile))
+				continue;
+			WriteData(ptArea,pabFileData,ulFileDataSize,szFilename);
+			iRes=fclose(ptArea->hFile);
 			if(iRes){
-				printf("error closing file %s\n",getSuffix(iUseCase, tFlashDumpFile[iUseCase][i].hFile));
+				printf("error closing file %s\n",getSuffix(iUseCase, ptArea->hFile));
 			}
 		}
 
@@ -955,55 +1605,43 @@ int main(int argc, char *argv[])
 
 
 
-	switch(eFileType){
-	case FILETYPE_FLASHDUMP:
-		printf("\n-------------------------------- Flash Device Label FDL----------------------------------\n");
-		AnalyzeFDL(getOffset(iUseCase, ".fdl"), hInFile); // FDL
-		printf("\n-------------------------------------- Firmware NXI--------------------------------------\n");
-		printf("offset: 0x%08x, areasize: 0x%08x [%dKB]\n",getOffset(iUseCase, ".nxi"),getLength(iUseCase, ".nxi"),getLength(iUseCase, ".nxi")/1024);
-		AnalyzeNxfFileHeader(getOffset(iUseCase, ".nxi"),hInFile);
-
-		if(iUseCase==USE_CASE_A || iUseCase==USE_CASE_B){
-			printf("\n-------------------------------------- Update Area --------------------------------------\n");
-			printf("offset: 0x%08x, areasize: 0x%08x [%dKB]\n",getOffset(iUseCase, ".upd"),getLength(iUseCase, ".upd"),getLength(iUseCase, ".upd")/1024);
-			AnalyzeNxfFileHeader(getOffset(iUseCase, ".upd"),hInFile);
-		}
-
-		printf("\n-------------------------------- Maintenance Firmware MXF--------------------------------\n");
-		printf("offset: 0x%08x, areasize: 0x%08x [%dKB]\n",getOffset(iUseCase, ".mxf"),getLength(iUseCase, ".mxf"),getLength(iUseCase, ".mxf")/1024);
-		AnalyzeNxfFileHeader(getOffset(iUseCase, ".mxf"),hInFile);
-		break;
-
-	case FILETYPE_FDL:
-		AnalyzeFDL(0x0000, hInFile); // FDL
-		break;
-
-	case FILETYPE_NXF:
-	case FILETYPE_NXI:
-	case FILETYPE_MXF:
-	case FILETYPE_UPD:
-		AnalyzeNxfFileHeader(0x0000,hInFile);
-		break;
+	if(ptFormat->fnAnalyze!=NULL){
+		CheckFileCookie(ptFormat,hInFile);
+		ptFormat->fnAnalyze(szFilename,hInFile,iUseCase);
+	}
+	else {
+		printf("No file analyzer for %s\n",szInFileSuffix);
+	}
 
-	case FILETYPE_NAI:
-		AnalyzeNaiFileHeader(0x0000, hInFile);
-		break;
 
+	if(bExportTags){
+		if(eFileType==FILETYPE_NXF || eFileType==FILETYPE_NXI || eFileType==FILETYPE_MXF || eFileType==FILETYPE_UPD){
+			ExportTagList(szFilename);
+		}
+		else {
+			printf("Error: tag lists are exported from firmware files only\n");
+		}
+	}
 
-	case FILETYPE_UNKNOWN:
-		printf("Error: unknown file extension\n");
-		return EXIT_FAILURE;
-		break;
+	if(bFillLevel && pabFileData!=NULL){
+		if(eFileType == FILETYPE_FLASHDUMP){
+			AnalyzeFillLevel(pabFileData,ulFileDataSize,tFlashDumpFile[iUseCase],sizeof(tFlashDumpFile[iUseCase])/sizeof(FILE_T),GetDumpBlockSize(pabFileData,ulFileDataSize,iUseCase));
+		}
+		else {
+			/* single area file, the whole file is one area */
+			FILE_T tArea={{0},0,(uint32_t)ulFileDataSize,0};
+			strcpy(tArea.szSuffix,szInFileSuffix);
+			AnalyzeFillLevel(pabFileData,ulFileDataSize,&tArea,1,FLASH_DUMP_DEFAULT_BLOCK_SIZE);
+		}
+	}
 
-	default:
-		printf("No file analyzer for %s\n",szInFileSuffix);
-		break;
 
-	}
 
 
 
 
+	AttachFileData(hInFile,NULL,0);
+	free(pabFileData);
 
 	iRes=fclose(hInFile);
 	if(iRes){
@@ -0,0 +1,324 @@
+/*
+ * netXFileCheckerApp.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  APP side flash dump analysis (tAppDumpFile)
+ *  the internal flash of the netX 90 APP CPU (INTFLASH2) holds the NAI firmware,
+ *  the Cortex-M4 vector table in the first 448 bytes, the HBOOT header and the NAI headers
+ *  behind it. The vector table is checked against the memory map of the APP CPU:
+ *  the stack pointer has to be in the APP SRAM, the handlers in the NAI image, with the
+ *  thumb bit set. The flash behind the image is reported as trailing data.
+ *  Dumps are mapped, a list of dumps is checked on the batch workers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+#include "Hil_FileHeaderV3.h"
+
+
+#define APP_FLASH_BASE     0x00100000 // INTFLASH2 in the memory map of the APP CPU
+#define APP_SRAM_START     0x000B0000 // INTRAM5..7 of the APP CPU
+#define APP_SRAM_END       0x000E0000
+#define APP_NUM_VECTORS    (HBOOT_NAI_HEADER_OFFSET/4)
+#define APP_NUM_EXCEPTIONS 16         // stack pointer and system exceptions, IRQs follow
+
+#define APP_VECTOR_OK        0
+#define APP_VECTOR_UNUSED    1 // 0 or erased
+#define APP_VECTOR_NO_THUMB  2 // bit 0 cleared
+#define APP_VECTOR_OUTSIDE   3 // handler outside of the NAI image
+#define APP_VECTOR_SP_RANGE  4 // stack pointer outside of the APP SRAM
+#define APP_VECTOR_SP_ALIGN  5 // stack pointer not 8 byte aligned
+
+static const char* s_aszAppVectorState[]={
+	"OK",
+	"-",
+	"ERROR thumb bit not set",
+	"ERROR outside of the image",
+	"ERROR outside of the APP SRAM",
+	"ERROR not 8 byte aligned",
+};
+
+/* NULL: reserved by the Cortex-M4 */
+static const char* s_aszAppException[APP_NUM_EXCEPTIONS]={
+	"Stack Pointer",
+	"Reset",
+	"NMI",
+	"HardFault",
+	"MemManage",
+	"BusFault",
+	"UsageFault",
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	"SVCall",
+	"DebugMonitor",
+	NULL,
+	"PendSV",
+	"SysTick",
+};
+
+typedef struct APP_DUMP_RESULT_Ttag {
+	uint32_t ulSize;             // dump size
+	uint32_t ulImageSize;        // NAI image up to the end given by ulAppFileSize
+	uint32_t ulCookie;           // NAI boot header cookie
+	uint16_t ausFwVersion[4];
+	uint32_t ulFwNumber;
+	uint32_t aulVector[APP_NUM_VECTORS];
+	uint8_t abVectorState[APP_NUM_VECTORS];
+	int iVectorErrors;
+	uint32_t ulTrailingEnd;      // offset behind the last programmed byte behind the image, 0 if erased
+	bool bLoadError;
+} APP_DUMP_RESULT_T;
+
+typedef struct APP_BATCH_Ttag {
+	char** aszFiles;
+	APP_DUMP_RESULT_T* atResult;
+} APP_BATCH_T;
+
+
+
+static const FILE_T* GetAppArea(char* szSuffix){
+	int i=0;
+
+	for(i=0;i<sizeof(tAppDumpFile)/sizeof(FILE_T);i++){
+		if(tAppDumpFile[i].ulLength && 0==strcmp(tAppDumpFile[i].szSuffix,szSuffix))
+			return &tAppDumpFile[i];
+	}
+	return NULL;
+}
+
+
+
+static uint8_t AppVectorState(int iVector, uint32_t ulVector, uint32_t ulImageSize){
+	if(iVector==0){
+		if(ulVector<=APP_SRAM_START || ulVector>APP_SRAM_END)
+			return APP_VECTOR_SP_RANGE;
+		if(ulVector&7)
+			return APP_VECTOR_SP_ALIGN;
+		return APP_VECTOR_OK;
+	}
+	/* the reset handler is required, other handlers may be left empty */
+	if((ulVector==0 || ulVector==0xFFFFFFFF) && iVector!=1)
+		return APP_VECTOR_UNUSED;
+	if((ulVector&1)==0)
+		return APP_VECTOR_NO_THUMB;
+	if(ulVector<APP_FLASH_BASE+HBOOT_NAI_HEADER_OFFSET || ulVector-APP_FLASH_BASE>=ulImageSize)
+		return APP_VECTOR_OUTSIDE;
+	return APP_VECTOR_OK;
+}
+
+
+
+/* checks the NAI region of a mapped dump */
+static void AppCheckDump(const uint8_t* pabDump, size_t ulDumpSize, APP_DUMP_RESULT_T* ptResult){
+	const FILE_T* ptNai=GetAppArea(".nai");
+	uint32_t ulNaiOffset=HBOOT_NAI_HEADER_OFFSET+sizeof(HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T);
+	HIL_FILE_NAI_HEADER_V3_0_T tNaiHeader;
+	const uint8_t* pabNai=0;
+	uint32_t ulAreaSize=0;
+	uint32_t ulImageStart=0;
+	int i=0;
+
+	memset(ptResult,0,sizeof(APP_DUMP_RESULT_T));
+	ptResult->ulSize=(uint32_t)ulDumpSize;
+	if(ptNai->ulOffset+ulNaiOffset+sizeof(tNaiHeader)>ulDumpSize){
+		ptResult->bLoadError=true;
+		return;
+	}
+	pabNai=pabDump+ptNai->ulOffset;
+	ulAreaSize=(uint32_t)HIL_MIN(ptNai->ulLength,ulDumpSize-ptNai->ulOffset);
+
+	memcpy(&tNaiHeader,pabNai+ulNaiOffset,sizeof(tNaiHeader));
+	ptResult->ulCookie=tNaiHeader.tBootHeader.ulMagicCookie;
+	memcpy(ptResult->ausFwVersion,tNaiHeader.tDeviceInfo.ausFwVersion,sizeof(ptResult->ausFwVersion));
+	ptResult->ulFwNumber=tNaiHeader.tDeviceInfo.ulFwNumber;
+	/* ulAppFileSize counts the DWORDs behind the NAI boot header */
+	ulImageStart=ulNaiOffset+sizeof(HIL_FILE_BOOT_HEADER_NAI_NAE_V1_0_T);
+	if(tNaiHeader.tBootHeader.ulAppFileSize>(ulAreaSize-ulImageStart)/4)
+		ptResult->ulImageSize=ulAreaSize;
+	else
+		ptResult->ulImageSize=ulImageStart+tNaiHeader.tBootHeader.ulAppFileSize*4;
+
+	memcpy(ptResult->aulVector,pabNai,sizeof(ptResult->aulVector));
+	for(i=0;i<APP_NUM_VECTORS;i++){
+		if(i<APP_NUM_EXCEPTIONS && i>0 && s_aszAppException[i]==NULL){
+			ptResult->abVectorState[i]=APP_VECTOR_UNUSED;
+			continue;
+		}
+		ptResult->abVectorState[i]=AppVectorState(i,ptResult->aulVector[i],ptResult->ulImageSize);
+		if(ptResult->abVectorState[i]>APP_VECTOR_UNUSED)
+			ptResult->iVectorErrors++;
+	}
+
+	if(ptResult->ulImageSize<ulAreaSize){
+		uint32_t ulWritten=BlockWrittenEnd(pabNai+ptResult->ulImageSize,ulAreaSize-ptResult->ulImageSize);
+		if(ulWritten)
+			ptResult->ulTrailingEnd=ptResult->ulImageSize+ulWritten;
+	}
+}
+
+
+
+static void PrintAppVectors(const APP_DUMP_RESULT_T* ptResult){
+	int aiIrqCount[APP_VECTOR_SP_RANGE]={0}; // IRQ handlers have no stack pointer states
+	int i=0;
+
+	printf("\n--------------------------------------\nAPP VECTOR TABLE\n");
+	printf("check offset:   0x%05x\n",GetAppArea(".nai")->ulOffset);
+	printf("vectors:        %d\n",APP_NUM_VECTORS);
+	printf("--------------------------------------\n");
+	for(i=0;i<APP_NUM_EXCEPTIONS;i++){
+		if(s_aszAppException[i]==NULL)
+			continue;
+		printf("%-15s 0x%08x  %s\n",s_aszAppException[i],ptResult->aulVector[i],s_aszAppVectorState[ptResult->abVectorState[i]]);
+	}
+	for(i=APP_NUM_EXCEPTIONS;i<APP_NUM_VECTORS;i++){
+		aiIrqCount[ptResult->abVectorState[i]]++;
+	}
+	printf("IRQ 0..%-7d %d used, %d unused",APP_NUM_VECTORS-APP_NUM_EXCEPTIONS-1,aiIrqCount[APP_VECTOR_OK],aiIrqCount[APP_VECTOR_UNUSED]);
+	if(aiIrqCount[APP_VECTOR_NO_THUMB] || aiIrqCount[APP_VECTOR_OUTSIDE])
+		printf(", ERROR %d without thumb bit, %d outside of the image",aiIrqCount[APP_VECTOR_NO_THUMB],aiIrqCount[APP_VECTOR_OUTSIDE]);
+	printf("\n");
+	for(i=APP_NUM_EXCEPTIONS;i<APP_NUM_VECTORS;i++){
+		if(ptResult->abVectorState[i]>APP_VECTOR_UNUSED)
+			printf("IRQ %-11d 0x%08x  %s\n",i-APP_NUM_EXCEPTIONS,ptResult->aulVector[i],s_aszAppVectorState[ptResult->abVectorState[i]]);
+	}
+}
+
+
+
+static void PrintAppTrailing(const APP_DUMP_RESULT_T* ptResult){
+	const FILE_T* ptNai=GetAppArea(".nai");
+	uint32_t ulAreaSize=HIL_MIN(ptNai->ulLength,ptResult->ulSize-ptNai->ulOffset);
+
+	printf("\n--------------------------------------\nAPP TRAILING DATA\n");
+	printf("check offset:   0x%05x\n",ptNai->ulOffset+ptResult->ulImageSize);
+	printf("image size:     0x%05x [%dKB]\n",ptResult->ulImageSize,ptResult->ulImageSize/1024);
+	printf("trailing:       0x%05x [%dKB]\n",ulAreaSize-ptResult->ulImageSize,(ulAreaSize-ptResult->ulImageSize)/1024);
+	printf("--------------------------------------\n");
+	if(ptResult->ulTrailingEnd)
+		printf("programmed up to 0x%05x, %d bytes behind the image\n",ptNai->ulOffset+ptResult->ulTrailingEnd,ptResult->ulTrailingEnd-ptResult->ulImageSize);
+	else
+		printf("erased\n");
+}
+
+
+
+/* analysis of one APP side flash dump */
+int AnalyzeAppDump(char* szFilename){
+	const FILE_T* ptNai=GetAppArea(".nai");
+	APP_DUMP_RESULT_T* ptResult=0;
+	BATCH_MAP_T tMap;
+	FILE* hFile=NULL;
+	int iRes=0;
+
+	if(BatchMapFile(szFilename,&tMap)){
+		printf("\nError opening file %s\n",szFilename);
+		return EXIT_FAILURE;
+	}
+	hFile=fopen(szFilename,"rb");
+	ptResult=MemAlloc(sizeof(APP_DUMP_RESULT_T));
+	if(hFile==NULL || ptResult==NULL){
+		printf("\nError opening file %s\n",szFilename);
+		if(hFile!=NULL)
+			fclose(hFile);
+		free(ptResult);
+		BatchUnmapFile(&tMap);
+		return EXIT_FAILURE;
+	}
+
+	printf("\nanalyze APP FLASH DUMP file %s\n\n",szFilename);
+	printf("%s  offset: 0x%08x, areasize: 0x%08x [%dKB]\n",ptNai->szSuffix,ptNai->ulOffset,ptNai->ulLength,ptNai->ulLength/1024);
+
+	AppCheckDump(tMap.pabData,tMap.ulSize,ptResult);
+	if(ptResult->bLoadError){
+		printf("Error: file too short for an NAI\n");
+		iRes=EXIT_FAILURE;
+	}
+	else {
+		printf("\n-------------------------------------- Firmware NAI--------------------------------------\n");
+		PrintAppVectors(ptResult);
+		AnalyzeNaiFileHeader(ptNai->ulOffset,hFile);
+		FileScratchRelease();
+		PrintAppTrailing(ptResult);
+		if(ptResult->iVectorErrors)
+			iRes=EXIT_FAILURE;
+	}
+
+	free(ptResult);
+	fclose(hFile);
+	BatchUnmapFile(&tMap);
+	return iRes;
+}
+
+
+
+static void AppJob(int iJob, int iWorker, void* pvContext){
+	APP_BATCH_T* ptBatch=(APP_BATCH_T*)pvContext;
+	BATCH_MAP_T tMap;
+
+	if(BatchMapFile(ptBatch->aszFiles[iJob],&tMap)){
+		ptBatch->atResult[iJob].bLoadError=true;
+		return;
+	}
+	AppCheckDump(tMap.pabData,tMap.ulSize,&ptBatch->atResult[iJob]);
+	BatchUnmapFile(&tMap);
+}
+
+
+
+/* one line per APP side flash dump of the batch */
+int AnalyzeAppDumps(char** aszFiles, int iNumFiles, int iNumThreads){
+	APP_BATCH_T tBatch;
+	int iNumFailed=0;
+	int i=0;
+
+	tBatch.aszFiles=aszFiles;
+	tBatch.atResult=MemCalloc(iNumFiles,sizeof(APP_DUMP_RESULT_T));
+	if(tBatch.atResult==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+	if(iNumThreads<=0)
+		iNumThreads=BatchGetNumCpus();
+	BatchRun(iNumFiles,iNumThreads,AppJob,&tBatch);
+
+	printf("\n--------------------------------------\nAPP FLASH DUMPS\n");
+	printf("files:          %d\n",iNumFiles);
+	printf("--------------------------------------\n");
+	for(i=0;i<iNumFiles;i++){
+		const APP_DUMP_RESULT_T* ptResult=&tBatch.atResult[i];
+
+		printf("%s",aszFiles[i]);
+		if(ptResult->bLoadError){
+			printf("  error reading file\n");
+			iNumFailed++;
+			continue;
+		}
+		if(ptResult->ulCookie==HIL_FILE_HEADER_FIRMWARE_NAI_COOKIE)
+			printf("  NAI %d.%d.%d.%d #%d",ptResult->ausFwVersion[0],ptResult->ausFwVersion[1],ptResult->ausFwVersion[2],ptResult->ausFwVersion[3],ptResult->ulFwNumber);
+		else
+			printf("  NAI ?");
+		printf("  image %dKB",ptResult->ulImageSize/1024);
+		if(ptResult->iVectorErrors)
+			printf("  %d vector errors",ptResult->iVectorErrors);
+		else
+			printf("  vectors OK");
+		if(ptResult->ulTrailingEnd)
+			printf("  trailing data up to 0x%05x",ptResult->ulTrailingEnd);
+		printf("\n");
+		if(ptResult->iVectorErrors || ptResult->ulCookie!=HIL_FILE_HEADER_FIRMWARE_NAI_COOKIE)
+			iNumFailed++;
+	}
+	printf("\n%d passed, %d failed\n",iNumFiles-iNumFailed,iNumFailed);
+
+	free(tBatch.atResult);
+	return iNumFailed ? EXIT_FAILURE : 0;
+}
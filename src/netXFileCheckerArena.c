@@ -0,0 +1,170 @@
+/*
+ * netXFileCheckerArena.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  scratch memory of one file: allocations move a pointer through a block and are released
+ *  together when the arena is reset after the file. A file that needs more than the block
+ *  gets further blocks chained, the reset replaces them by one block of the size the file
+ *  needed, so the following files of that size are served without heap allocation. The
+ *  first file that fits the default block again shrinks the arena back to it. Blocks are
+ *  aligned to ARENA_ALIGN, enough for direct I/O buffers.
+ *
+ *  MemAlloc, MemCalloc and MemRealloc are the heap functions of the tool, they count every
+ *  successful heap allocation, the arena blocks included.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <malloc.h>
+#endif
+
+#include "netXFileChecker.h"
+
+
+/* the header takes the first ARENA_ALIGN bytes of the block, the data follows aligned */
+struct ARENA_BLOCK_Ttag {
+	ARENA_BLOCK_T* ptNext;       // earlier block of the same file
+	size_t ulSize;               // data bytes
+	size_t ulUsed;
+};
+
+static volatile long s_lHeapAllocs=0;
+
+
+
+static void* MemCount(void* pvData){
+	if(pvData!=NULL){
+#ifdef _WIN32
+		InterlockedIncrement(&s_lHeapAllocs);
+#else
+		__sync_fetch_and_add(&s_lHeapAllocs,1);
+#endif
+	}
+	return pvData;
+}
+
+void* MemAlloc(size_t ulSize){
+	return MemCount(malloc(ulSize));
+}
+
+void* MemCalloc(size_t ulNum, size_t ulSize){
+	return MemCount(calloc(ulNum,ulSize));
+}
+
+void* MemRealloc(void* pvData, size_t ulSize){
+	return MemCount(realloc(pvData,ulSize));
+}
+
+/* heap allocations of the tool so far, not those inside the C library (fopen) */
+long MemHeapAllocs(void){
+	return s_lHeapAllocs;
+}
+
+
+
+static size_t ArenaAlignUp(size_t ulSize, size_t ulAlign){
+	return (ulSize+ulAlign-1)&~(ulAlign-1);
+}
+
+static uint8_t* ArenaBlockData(ARENA_BLOCK_T* ptBlock){
+	return (uint8_t*)ptBlock+ARENA_ALIGN;
+}
+
+static ARENA_BLOCK_T* ArenaNewBlock(size_t ulSize){
+	ARENA_BLOCK_T* ptBlock=0;
+
+	ulSize=ArenaAlignUp(HIL_MAX(ulSize,1),ARENA_ALIGN);
+#ifdef _WIN32
+	ptBlock=MemCount(_aligned_malloc(ARENA_ALIGN+ulSize,ARENA_ALIGN));
+#else
+	{
+		void* pvBlock=0;
+		ptBlock=MemCount(posix_memalign(&pvBlock,ARENA_ALIGN,ARENA_ALIGN+ulSize) ? NULL : pvBlock);
+	}
+#endif
+	if(ptBlock!=NULL){
+		ptBlock->ptNext=NULL;
+		ptBlock->ulSize=ulSize;
+		ptBlock->ulUsed=0;
+	}
+	return ptBlock;
+}
+
+static void ArenaFreeBlocks(ARENA_BLOCK_T* ptBlock){
+	while(ptBlock!=NULL){
+		ARENA_BLOCK_T* ptNext=ptBlock->ptNext;
+#ifdef _WIN32
+		_aligned_free(ptBlock);
+#else
+		free(ptBlock);
+#endif
+		ptBlock=ptNext;
+	}
+}
+
+
+
+/* the first block is allocated with the first allocation */
+void ArenaInit(FILE_ARENA_T* ptArena, size_t ulBlockSize){
+	memset(ptArena,0,sizeof(FILE_ARENA_T));
+	ptArena->ulBlockSize=ulBlockSize;
+	ptArena->ulDefaultSize=ulBlockSize;
+}
+
+
+
+/* ulAlign is a power of two up to ARENA_ALIGN, NULL if the heap is exhausted */
+void* ArenaAlloc(FILE_ARENA_T* ptArena, size_t ulSize, size_t ulAlign){
+	ARENA_BLOCK_T* ptBlock=ptArena->ptBlock;
+	size_t ulOffset=0;
+
+	if(ulAlign==0)
+		ulAlign=sizeof(void*);
+	if(ptBlock!=NULL)
+		ulOffset=ArenaAlignUp(ptBlock->ulUsed,ulAlign);
+	if(ptBlock==NULL || ulOffset+ulSize>ptBlock->ulSize){
+		ptBlock=ArenaNewBlock(HIL_MAX(ulSize,ptArena->ulBlockSize));
+		if(ptBlock==NULL)
+			return NULL;
+		ptBlock->ptNext=ptArena->ptBlock;
+		ptArena->ptBlock=ptBlock;
+		ulOffset=0;
+	}
+	/* worst case padding, the merged block has to hold the file whatever the block boundaries were */
+	ptArena->ulUsed+=ulSize+ulAlign-1;
+	ptBlock->ulUsed=ulOffset+ulSize;
+	return ArenaBlockData(ptBlock)+ulOffset;
+}
+
+
+
+/* releases all allocations, blocks chained for a large file are merged into one,
+ * a block larger than the default is dropped after a file that fits the default */
+void ArenaReset(FILE_ARENA_T* ptArena){
+	ARENA_BLOCK_T* ptBlock=ptArena->ptBlock;
+	bool bOversized=ptBlock!=NULL && ptBlock->ulSize>ArenaAlignUp(ptArena->ulDefaultSize,ARENA_ALIGN);
+
+	if(ptBlock!=NULL && (ptBlock->ptNext!=NULL || (bOversized && ptArena->ulUsed<=ptArena->ulDefaultSize))){
+		ArenaFreeBlocks(ptBlock);
+		ptArena->ptBlock=NULL;
+		ptArena->ulBlockSize=HIL_MAX(ptArena->ulDefaultSize,ptArena->ulUsed);
+	}
+	if(ptArena->ptBlock!=NULL)
+		ptArena->ptBlock->ulUsed=0;
+	ptArena->ulUsed=0;
+}
+
+
+
+void ArenaFree(FILE_ARENA_T* ptArena){
+	ArenaFreeBlocks(ptArena->ptBlock);
+	ptArena->ptBlock=NULL;
+	ptArena->ulUsed=0;
+}
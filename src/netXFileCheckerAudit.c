@@ -0,0 +1,456 @@
+/*
+ * netXFileCheckerAudit.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  fleet wide uniqueness audit of FDL MAC addresses and device/serial numbers
+ *  workers insert the keys of each file into a sharded set, a shard is selected by the key hash
+ *  and has its own lock. Full shard buffers are spilled to a shard file, so memory stays bounded.
+ *  Each shard is checked on its own afterwards: sorted, equal keys are duplicates.
+ *  MAC ranges are kept in the shards of the 256 MAC blocks they touch, an overlap is reported
+ *  in the block holding its first MAC only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "netXFileChecker.h"
+
+
+#define AUDIT_KEY_MAC       0    // one MAC address
+#define AUDIT_KEY_SERIAL    1    // device number and serial number
+#define AUDIT_KEY_RANGE     2    // MAC range of one side (COM or APP), key is the first MAC
+
+#define AUDIT_RANGE_MAX     64   // longer ranges are not contiguous allocations, not checked as range
+#define AUDIT_BLOCK_SHIFT   8    // MAC block size for range sharding
+#define AUDIT_MAX_LISTED    8    // files listed per collision
+
+typedef struct AUDIT_ENTRY_Ttag {
+	uint64_t ullKey;
+	uint32_t ulFile;
+	uint8_t bType;               // AUDIT_KEY_xxx
+	uint8_t bLength;             // AUDIT_KEY_RANGE: number of MACs
+	uint16_t usBlock;            // AUDIT_KEY_RANGE: MAC block index relative to the first MAC
+} AUDIT_ENTRY_T;
+
+typedef struct AUDIT_SHARD_Ttag {
+	void* pvLock;
+	AUDIT_ENTRY_T* atEntry;
+	uint32_t ulNumEntries;
+	FILE* hSpill;
+	uint64_t ullSpilled;
+	char szSpillFile[BATCH_MAX_PATH+16];
+} AUDIT_SHARD_T;
+
+typedef struct AUDIT_CONTEXT_Ttag {
+	char** aszFiles;
+	int iUseCase;
+	RESULT_CACHE_T* ptCache;
+	AUDIT_SHARD_T* atShard;
+	uint32_t ulNumShards;        // power of two
+	uint32_t ulShardEntries;     // buffer size of a shard
+	char* szSpillPrefix;
+	volatile long lFdls;
+	volatile long lMacs;
+	volatile long lErrors;
+	volatile long lSpillError;
+} AUDIT_CONTEXT_T;
+
+typedef struct AUDIT_RESULT_Ttag {
+	uint32_t ulDuplicateMacs;
+	uint32_t ulDuplicateSerials;
+	uint32_t ulRangeOverlaps;
+} AUDIT_RESULT_T;
+
+
+
+static void AuditAtomicAdd(volatile long* plValue, long lAdd){
+#ifdef _WIN32
+	InterlockedExchangeAdd(plValue,lAdd);
+#else
+	__sync_fetch_and_add(plValue,lAdd);
+#endif
+}
+
+
+
+static uint32_t AuditShardOf(const AUDIT_CONTEXT_T* ptCtx, uint8_t bType, uint64_t ullKey){
+	uint64_t ullHash=0;
+
+	if(bType==AUDIT_KEY_RANGE)
+		ullKey>>=AUDIT_BLOCK_SHIFT;
+	/* MACs and serials are allocated in sequence, mix the bits before taking the shard */
+	ullHash=(ullKey^((uint64_t)bType<<56))*0x9E3779B97F4A7C15ULL;
+	return (uint32_t)(ullHash>>40)&(ptCtx->ulNumShards-1);
+}
+
+
+
+static void AuditInsert(AUDIT_CONTEXT_T* ptCtx, const AUDIT_ENTRY_T* ptEntry, uint64_t ullShardKey){
+	AUDIT_SHARD_T* ptShard=&ptCtx->atShard[AuditShardOf(ptCtx,ptEntry->bType,ullShardKey)];
+
+	BatchLock(ptShard->pvLock);
+	if(ptShard->ulNumEntries==ptCtx->ulShardEntries){
+		if(ptShard->hSpill==NULL){
+			snprintf(ptShard->szSpillFile,sizeof(ptShard->szSpillFile),"%s.%04d.tmp",ptCtx->szSpillPrefix,(int)(ptShard-ptCtx->atShard));
+			ptShard->hSpill=fopen(ptShard->szSpillFile,"w+b");
+		}
+		if(ptShard->hSpill==NULL || fwrite(ptShard->atEntry,sizeof(AUDIT_ENTRY_T),ptShard->ulNumEntries,ptShard->hSpill)!=ptShard->ulNumEntries){
+			ptCtx->lSpillError=1;
+		}
+		ptShard->ullSpilled+=ptShard->ulNumEntries;
+		ptShard->ulNumEntries=0;
+	}
+	ptShard->atEntry[ptShard->ulNumEntries++]=*ptEntry;
+	BatchUnlock(ptShard->pvLock);
+}
+
+
+
+static uint64_t MacToKey(const uint8_t* abMac){
+	return ((uint64_t)abMac[0]<<40)|((uint64_t)abMac[1]<<32)|((uint64_t)abMac[2]<<24)|((uint64_t)abMac[3]<<16)|((uint64_t)abMac[4]<<8)|abMac[5];
+}
+
+static bool MacValid(uint64_t ullMac){
+	return ullMac!=0 && ullMac!=0xFFFFFFFFFFFFULL;
+}
+
+
+
+/* all MACs of one side, and the range from the lowest to the highest MAC */
+static int AuditMacs(AUDIT_CONTEXT_T* ptCtx, uint32_t ulFile, const HIL_PRODUCT_DATA_MAC_ADDRESS_T* atMAC, int iNumMacs){
+	AUDIT_ENTRY_T tEntry;
+	uint64_t ullLow=0xFFFFFFFFFFFFFFFFULL;
+	uint64_t ullHigh=0;
+	uint64_t ullBlock=0;
+	int iNumValid=0;
+	int i=0;
+
+	memset(&tEntry,0,sizeof(tEntry));
+	tEntry.ulFile=ulFile;
+	tEntry.bType=AUDIT_KEY_MAC;
+	for(i=0;i<iNumMacs;i++){
+		tEntry.ullKey=MacToKey(atMAC[i].abMacAddress);
+		if(!MacValid(tEntry.ullKey))
+			continue;
+		AuditInsert(ptCtx,&tEntry,tEntry.ullKey);
+		ullLow=HIL_MIN(ullLow,tEntry.ullKey);
+		ullHigh=HIL_MAX(ullHigh,tEntry.ullKey);
+		iNumValid++;
+	}
+
+	if(iNumValid>1 && ullHigh-ullLow<AUDIT_RANGE_MAX){
+		tEntry.bType=AUDIT_KEY_RANGE;
+		tEntry.ullKey=ullLow;
+		tEntry.bLength=(uint8_t)(ullHigh-ullLow+1);
+		for(ullBlock=ullLow>>AUDIT_BLOCK_SHIFT;ullBlock<=ullHigh>>AUDIT_BLOCK_SHIFT;ullBlock++){
+			tEntry.usBlock=(uint16_t)(ullBlock-(ullLow>>AUDIT_BLOCK_SHIFT));
+			AuditInsert(ptCtx,&tEntry,ullBlock<<AUDIT_BLOCK_SHIFT);
+		}
+	}
+	return iNumValid;
+}
+
+
+
+static void AuditRecord(AUDIT_CONTEXT_T* ptCtx, int iJob, const NETX_RECORD_T* ptRecord){
+	NETX_RECORD_T tRecord=*ptRecord;
+	AUDIT_ENTRY_T tEntry;
+	int iNumMacs=0;
+
+	if(tRecord.ulFlags&RECORD_FLAG_LOAD_ERROR){
+		AuditAtomicAdd(&ptCtx->lErrors,1);
+		return;
+	}
+	if(0==(tRecord.ulFlags&RECORD_FLAG_FDL_VALID)){
+		return;
+	}
+	AuditAtomicAdd(&ptCtx->lFdls,1);
+
+	memset(&tEntry,0,sizeof(tEntry));
+	tEntry.ulFile=iJob;
+	tEntry.bType=AUDIT_KEY_SERIAL;
+	tEntry.ullKey=((uint64_t)tRecord.tBasicDeviceData.ulDeviceNumber<<32)|tRecord.tBasicDeviceData.ulSerialNumber;
+	AuditInsert(ptCtx,&tEntry,tEntry.ullKey);
+
+	iNumMacs+=AuditMacs(ptCtx,iJob,tRecord.tMACAddressesCom.atMAC,HIL_PRODUCT_NUMBER_OF_MAC_ADDRESSES_COM);
+	iNumMacs+=AuditMacs(ptCtx,iJob,tRecord.tMACAddressesApp.atMAC,HIL_PRODUCT_NUMBER_OF_MAC_ADDRESSES_APP);
+	AuditAtomicAdd(&ptCtx->lMacs,iNumMacs);
+}
+
+
+
+static void AuditJob(int iJob, int iWorker, void* pvContext){
+	AUDIT_CONTEXT_T* ptCtx=(AUDIT_CONTEXT_T*)pvContext;
+	NETX_RECORD_T tRecord;
+
+	(void)iWorker;
+	RecordFile(ptCtx->ptCache,ptCtx->aszFiles[iJob],ptCtx->iUseCase,&tRecord);
+	AuditRecord(ptCtx,iJob,&tRecord);
+}
+
+
+
+/* file read by the batch reader, used without cache */
+static void AuditParse(int iJob, int iWorker, const uint8_t* pabData, size_t ulSize, void* pvContext){
+	AUDIT_CONTEXT_T* ptCtx=(AUDIT_CONTEXT_T*)pvContext;
+	NETX_RECORD_T tRecord;
+
+	(void)iWorker;
+	if(pabData==NULL){
+		memset(&tRecord,0xFF,sizeof(NETX_RECORD_T));
+		tRecord.ulFlags=RECORD_FLAG_LOAD_ERROR;
+	}
+	else {
+		BuildRecord(pabData,ulSize,GetFileType(ptCtx->aszFiles[iJob]),ptCtx->iUseCase,&tRecord);
+	}
+	AuditRecord(ptCtx,iJob,&tRecord);
+}
+
+
+
+static int CompareAuditEntry(const void* pvA, const void* pvB){
+	const AUDIT_ENTRY_T* ptA=(const AUDIT_ENTRY_T*)pvA;
+	const AUDIT_ENTRY_T* ptB=(const AUDIT_ENTRY_T*)pvB;
+
+	if(ptA->bType!=ptB->bType)
+		return ptA->bType<ptB->bType ? -1 : 1;
+	if(ptA->ullKey!=ptB->ullKey)
+		return ptA->ullKey<ptB->ullKey ? -1 : 1;
+	if(ptA->bLength!=ptB->bLength)
+		return ptA->bLength<ptB->bLength ? -1 : 1;
+	if(ptA->usBlock!=ptB->usBlock)
+		return ptA->usBlock<ptB->usBlock ? -1 : 1;
+	if(ptA->ulFile!=ptB->ulFile)
+		return ptA->ulFile<ptB->ulFile ? -1 : 1;
+	return 0;
+}
+
+
+
+static void PrintAuditKey(const AUDIT_ENTRY_T* ptEntry){
+	uint64_t ullKey=ptEntry->ullKey;
+
+	switch(ptEntry->bType){
+	case AUDIT_KEY_SERIAL:
+		printf("device/serial %d/%d",(uint32_t)(ullKey>>32),(uint32_t)ullKey);
+		break;
+	default:
+		printf("%02x:%02x:%02x:%02x:%02x:%02x",(int)(ullKey>>40)&0xFF,(int)(ullKey>>32)&0xFF,(int)(ullKey>>24)&0xFF
+				,(int)(ullKey>>16)&0xFF,(int)(ullKey>>8)&0xFF,(int)ullKey&0xFF);
+		break;
+	}
+}
+
+
+
+/* equal keys in atEntry[ulFirst..ulEnd-1] */
+static void PrintDuplicate(char** aszFiles, const AUDIT_ENTRY_T* atEntry, uint32_t ulFirst, uint32_t ulEnd){
+	uint32_t i=0;
+
+	printf("duplicate ");
+	if(atEntry[ulFirst].bType==AUDIT_KEY_MAC)
+		printf("MAC ");
+	PrintAuditKey(&atEntry[ulFirst]);
+	printf(" used %d times\n",ulEnd-ulFirst);
+	for(i=ulFirst;i<ulEnd && i<ulFirst+AUDIT_MAX_LISTED;i++){
+		printf("    %s\n",aszFiles[atEntry[i].ulFile]);
+	}
+	if(ulEnd-ulFirst>AUDIT_MAX_LISTED)
+		printf("    ... %d more\n",ulEnd-ulFirst-AUDIT_MAX_LISTED);
+}
+
+
+
+/* ranges are sorted by first MAC, an overlap is reported in the block of the first common MAC.
+ * Identical ranges are reported as duplicate MACs already, only the first of them is kept. */
+static uint32_t CheckRangeOverlaps(char** aszFiles, AUDIT_ENTRY_T* atEntry, uint32_t ulFirst, uint32_t ulEnd){
+	uint32_t ulOverlaps=0;
+	uint32_t ulListed=0;
+	uint32_t i=0;
+	uint32_t j=0;
+
+	for(i=ulFirst+1,j=ulFirst+1;i<ulEnd;i++){
+		if(atEntry[i].ullKey!=atEntry[j-1].ullKey || atEntry[i].bLength!=atEntry[j-1].bLength || atEntry[i].usBlock!=atEntry[j-1].usBlock)
+			atEntry[j++]=atEntry[i];
+	}
+	ulEnd=HIL_MIN(j,ulEnd);
+
+	for(i=ulFirst;i<ulEnd;i++){
+		const AUDIT_ENTRY_T* ptA=&atEntry[i];
+		uint64_t ullBlock=(ptA->ullKey>>AUDIT_BLOCK_SHIFT)+ptA->usBlock;
+		ulListed=0;
+		for(j=i+1;j<ulEnd && atEntry[j].ullKey<ptA->ullKey+ptA->bLength;j++){
+			const AUDIT_ENTRY_T* ptB=&atEntry[j];
+			/* ptB starts inside ptA, the first common MAC is the first MAC of ptB */
+			if(ptB->usBlock!=0 || ptB->ullKey>>AUDIT_BLOCK_SHIFT!=ullBlock)
+				continue;
+			if(ptA->ulFile==ptB->ulFile)
+				continue;
+			if(ulListed==0){
+				printf("overlapping MAC range ");
+				PrintAuditKey(ptA);
+				printf(" +%d\n    %s\n",ptA->bLength,aszFiles[ptA->ulFile]);
+				ulOverlaps++;
+			}
+			if(ulListed<AUDIT_MAX_LISTED){
+				printf("    %s ",aszFiles[ptB->ulFile]);
+				PrintAuditKey(ptB);
+				printf(" +%d\n",ptB->bLength);
+			}
+			ulListed++;
+		}
+		if(ulListed>AUDIT_MAX_LISTED)
+			printf("    ... %d more\n",ulListed-AUDIT_MAX_LISTED);
+	}
+	return ulOverlaps;
+}
+
+
+
+static int CheckShard(AUDIT_CONTEXT_T* ptCtx, AUDIT_SHARD_T* ptShard, AUDIT_RESULT_T* ptResult){
+	AUDIT_ENTRY_T* atEntry=ptShard->atEntry;
+	uint32_t ulNumEntries=ptShard->ulNumEntries;
+	uint32_t ulFirst=0;
+	uint32_t ulEnd=0;
+
+	if(ptShard->hSpill){
+		uint64_t ullTotal=ptShard->ullSpilled+ptShard->ulNumEntries;
+		atEntry=MemAlloc((size_t)ullTotal*sizeof(AUDIT_ENTRY_T));
+		if(atEntry==NULL){
+			printf("error malloc\n");
+			return EXIT_FAILURE;
+		}
+		fseek(ptShard->hSpill,0,SEEK_SET);
+		if(fread(atEntry,sizeof(AUDIT_ENTRY_T),(size_t)ptShard->ullSpilled,ptShard->hSpill)!=ptShard->ullSpilled){
+			printf("error reading file %s\n",ptShard->szSpillFile);
+			free(atEntry);
+			return EXIT_FAILURE;
+		}
+		memcpy(&atEntry[ptShard->ullSpilled],ptShard->atEntry,ptShard->ulNumEntries*sizeof(AUDIT_ENTRY_T));
+		ulNumEntries=(uint32_t)ullTotal;
+	}
+
+	qsort(atEntry,ulNumEntries,sizeof(AUDIT_ENTRY_T),CompareAuditEntry);
+
+	for(ulFirst=0;ulFirst<ulNumEntries;ulFirst=ulEnd){
+		if(atEntry[ulFirst].bType==AUDIT_KEY_RANGE){
+			ptResult->ulRangeOverlaps+=CheckRangeOverlaps(ptCtx->aszFiles,atEntry,ulFirst,ulNumEntries);
+			break;
+		}
+		for(ulEnd=ulFirst+1;ulEnd<ulNumEntries && atEntry[ulEnd].bType==atEntry[ulFirst].bType && atEntry[ulEnd].ullKey==atEntry[ulFirst].ullKey;ulEnd++){
+		}
+		if(ulEnd-ulFirst>1){
+			PrintDuplicate(ptCtx->aszFiles,atEntry,ulFirst,ulEnd);
+			if(atEntry[ulFirst].bType==AUDIT_KEY_MAC)
+				ptResult->ulDuplicateMacs++;
+			else
+				ptResult->ulDuplicateSerials++;
+		}
+	}
+
+	if(atEntry!=ptShard->atEntry)
+		free(atEntry);
+	return 0;
+}
+
+
+
+/* ulMemoryMB bounds the key memory, shards are sized so that one spilled shard can be checked within it */
+int AuditUniqueness(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads, char* szCacheFilename, uint32_t ulMemoryMB, char* szSpillPrefix){
+	AUDIT_CONTEXT_T tCtx;
+	AUDIT_RESULT_T tResult;
+	uint64_t ullBudget=0;
+	uint64_t ullEstimate=0;
+	uint32_t i=0;
+	int iRes=0;
+
+	memset(&tCtx,0,sizeof(tCtx));
+	memset(&tResult,0,sizeof(tResult));
+	tCtx.aszFiles=aszFiles;
+	tCtx.iUseCase=iUseCase;
+	tCtx.szSpillPrefix=szSpillPrefix;
+
+	if(ulMemoryMB==0)
+		ulMemoryMB=256;
+	ullBudget=(uint64_t)ulMemoryMB<<20;
+
+	/* serial, 12 MACs and up to 4 range entries per file, buffers use half of the budget */
+	ullEstimate=(uint64_t)iNumFiles*17*sizeof(AUDIT_ENTRY_T);
+	tCtx.ulNumShards=16;
+	while(tCtx.ulNumShards<4096 && ullEstimate/tCtx.ulNumShards>ullBudget/2){
+		tCtx.ulNumShards<<=1;
+	}
+	tCtx.ulShardEntries=(uint32_t)HIL_MIN(ullBudget/2/tCtx.ulNumShards/sizeof(AUDIT_ENTRY_T),ullEstimate/tCtx.ulNumShards/sizeof(AUDIT_ENTRY_T)+64);
+
+	tCtx.atShard=MemCalloc(tCtx.ulNumShards,sizeof(AUDIT_SHARD_T));
+	if(tCtx.atShard==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+	for(i=0;i<tCtx.ulNumShards && iRes==0;i++){
+		tCtx.atShard[i].pvLock=BatchLockCreate();
+		tCtx.atShard[i].atEntry=MemAlloc(tCtx.ulShardEntries*sizeof(AUDIT_ENTRY_T));
+		if(tCtx.atShard[i].pvLock==NULL || tCtx.atShard[i].atEntry==NULL){
+			printf("error malloc\n");
+			iRes=EXIT_FAILURE;
+		}
+	}
+
+	if(iRes==0 && szCacheFilename!=NULL){
+		tCtx.ptCache=CacheOpen(szCacheFilename);
+		if(tCtx.ptCache==NULL)
+			iRes=EXIT_FAILURE;
+	}
+
+	if(iRes==0){
+		if(iNumThreads<1)
+			iNumThreads=BatchGetNumCpus();
+		if(tCtx.ptCache!=NULL)
+			BatchRun(iNumFiles,iNumThreads,AuditJob,&tCtx);
+		else
+			BatchReadFiles(aszFiles,iNumFiles,iNumThreads,AuditParse,&tCtx);
+		CacheClose(tCtx.ptCache);
+
+		if(tCtx.lSpillError){
+			printf("error writing shard files %s.*.tmp\n",szSpillPrefix);
+			iRes=EXIT_FAILURE;
+		}
+	}
+
+	if(iRes==0){
+		printf("\n--------------------------------------\nMAC / SERIAL NUMBER AUDIT\n");
+		printf("files:          %d\n",iNumFiles);
+		printf("valid FDLs:     %d\n",(int)tCtx.lFdls);
+		printf("MAC addresses:  %d\n",(int)tCtx.lMacs);
+		printf("--------------------------------------\n");
+
+		for(i=0;i<tCtx.ulNumShards && iRes==0;i++){
+			iRes=CheckShard(&tCtx,&tCtx.atShard[i],&tResult);
+		}
+
+		printf("\n%d duplicate MACs, %d overlapping MAC ranges, %d duplicate serial numbers, %d files without FDL, %d read errors\n"
+				,tResult.ulDuplicateMacs,tResult.ulRangeOverlaps,tResult.ulDuplicateSerials
+				,iNumFiles-(int)tCtx.lFdls-(int)tCtx.lErrors,(int)tCtx.lErrors);
+		if(tResult.ulDuplicateMacs || tResult.ulRangeOverlaps || tResult.ulDuplicateSerials || tCtx.lErrors)
+			iRes=EXIT_FAILURE;
+	}
+
+	for(i=0;i<tCtx.ulNumShards;i++){
+		if(tCtx.atShard[i].hSpill){
+			fclose(tCtx.atShard[i].hSpill);
+			remove(tCtx.atShard[i].szSpillFile);
+		}
+		BatchLockDestroy(tCtx.atShard[i].pvLock);
+		free(tCtx.atShard[i].atEntry);
+	}
+	free(tCtx.atShard);
+	return iRes;
+}
@@ -0,0 +1,487 @@
+/*
+ * netXFileCheckerBatch.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  batch processing: file lists and a simple worker pool
+ *  workers pull the next file index until the list is exhausted,
+ *  results are stored per index so they can be printed in list order
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <linux/fiemap.h>
+#endif
+
+#include "netXFileChecker.h"
+
+
+typedef struct BATCH_POOL_Ttag {
+	BATCH_JOB_FN fnJob;
+	void* pvContext;
+	int iNumJobs;
+	volatile long lNextJob;
+} BATCH_POOL_T;
+
+typedef struct BATCH_WORKER_Ttag {
+	BATCH_POOL_T* ptPool;
+	int iWorker;
+} BATCH_WORKER_T;
+
+typedef struct BATCH_FILE_SIZE_Ttag {
+	uint64_t ullSize;
+	int iFile;
+} BATCH_FILE_SIZE_T;
+
+typedef struct BATCH_FILE_POS_Ttag {
+	uint64_t ullDevice;
+	uint64_t ullInode;
+	uint64_t ullPhysical;        // first extent on the device
+	int iFile;
+} BATCH_FILE_POS_T;
+
+
+
+int BatchGetNumCpus(void){
+#ifdef _WIN32
+	SYSTEM_INFO tInfo;
+	GetSystemInfo(&tInfo);
+	return tInfo.dwNumberOfProcessors>0 ? (int)tInfo.dwNumberOfProcessors : 1;
+#else
+	long lNum=sysconf(_SC_NPROCESSORS_ONLN);
+	return lNum>0 ? (int)lNum : 1;
+#endif
+}
+
+
+
+/* reads a list file, one file name per line, empty lines and lines starting with # are skipped */
+char** BatchLoadList(char* szListFile, int* piNumFiles){
+	FILE* hFile=NULL;
+	char szLine[BATCH_MAX_PATH];
+	char** aszFiles=0;
+	char** aszNew=0;
+	int iNumFiles=0;
+	int iMaxFiles=0;
+
+	hFile=fopen(szListFile,"r");
+	if(hFile==NULL){
+		printf("\nError opening file %s\n",szListFile);
+		return NULL;
+	}
+
+	while(fgets(szLine,sizeof(szLine),hFile)){
+		size_t ulLen=strlen(szLine);
+		while(ulLen && (szLine[ulLen-1]=='\n' || szLine[ulLen-1]=='\r' || szLine[ulLen-1]==' ' || szLine[ulLen-1]=='\t')){
+			szLine[--ulLen]=0;
+		}
+		if(ulLen==0 || szLine[0]=='#')
+			continue;
+
+		if(iNumFiles==iMaxFiles){
+			iMaxFiles=iMaxFiles ? iMaxFiles*2 : 64;
+			aszNew=MemRealloc(aszFiles,iMaxFiles*sizeof(char*));
+			if(aszNew==NULL){
+				printf("error malloc\n");
+				break;
+			}
+			aszFiles=aszNew;
+		}
+		aszFiles[iNumFiles]=MemAlloc(ulLen+1);
+		if(aszFiles[iNumFiles]==NULL){
+			printf("error malloc\n");
+			break;
+		}
+		memcpy(aszFiles[iNumFiles],szLine,ulLen+1);
+		iNumFiles++;
+	}
+	fclose(hFile);
+
+	if(iNumFiles==0){
+		printf("Error: no files listed in %s\n",szListFile);
+		free(aszFiles);
+		return NULL;
+	}
+
+	*piNumFiles=iNumFiles;
+	return aszFiles;
+}
+
+
+
+void BatchFreeList(char** aszFiles, int iNumFiles){
+	int i=0;
+
+	if(aszFiles==NULL)
+		return;
+	for(i=0;i<iNumFiles;i++){
+		free(aszFiles[i]);
+	}
+	free(aszFiles);
+}
+
+
+
+static long BatchNextJob(BATCH_POOL_T* ptPool){
+#ifdef _WIN32
+	return InterlockedIncrement(&ptPool->lNextJob)-1;
+#else
+	return __sync_fetch_and_add(&ptPool->lNextJob,1);
+#endif
+}
+
+
+
+#ifdef _WIN32
+static DWORD WINAPI BatchWorker(LPVOID pvArg){
+#else
+static void* BatchWorker(void* pvArg){
+#endif
+	BATCH_WORKER_T* ptWorker=(BATCH_WORKER_T*)pvArg;
+	BATCH_POOL_T* ptPool=ptWorker->ptPool;
+	long lJob=0;
+
+	while((lJob=BatchNextJob(ptPool))<ptPool->iNumJobs){
+		ptPool->fnJob((int)lJob,ptWorker->iWorker,ptPool->pvContext);
+	}
+
+#ifdef _WIN32
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+
+
+/* runs fnJob for job indexes 0..iNumJobs-1 on iNumThreads workers, returns when all jobs are done */
+int BatchRun(int iNumJobs, int iNumThreads, BATCH_JOB_FN fnJob, void* pvContext){
+	int i=0;
+	int iStarted=0;
+	BATCH_POOL_T tPool;
+	BATCH_WORKER_T* atWorker=0;
+#ifdef _WIN32
+	HANDLE* ahThread=0;
+#else
+	pthread_t* atThread=0;
+#endif
+
+	tPool.fnJob=fnJob;
+	tPool.pvContext=pvContext;
+	tPool.iNumJobs=iNumJobs;
+	tPool.lNextJob=0;
+
+	if(iNumThreads<1)
+		iNumThreads=1;
+	if(iNumThreads>iNumJobs)
+		iNumThreads=iNumJobs>0 ? iNumJobs : 1;
+
+	atWorker=MemAlloc(iNumThreads*sizeof(BATCH_WORKER_T));
+#ifdef _WIN32
+	ahThread=MemAlloc(iNumThreads*sizeof(HANDLE));
+	if(atWorker==NULL || ahThread==NULL){
+		printf("error malloc\n");
+		free(atWorker);
+		free(ahThread);
+		return EXIT_FAILURE;
+	}
+#else
+	atThread=MemAlloc(iNumThreads*sizeof(pthread_t));
+	if(atWorker==NULL || atThread==NULL){
+		printf("error malloc\n");
+		free(atWorker);
+		free(atThread);
+		return EXIT_FAILURE;
+	}
+#endif
+
+	/* worker 0 is the calling thread */
+	for(i=1;i<iNumThreads;i++){
+		atWorker[i].ptPool=&tPool;
+		atWorker[i].iWorker=i;
+#ifdef _WIN32
+		ahThread[i]=CreateThread(NULL,0,BatchWorker,&atWorker[i],0,NULL);
+		if(ahThread[i]==NULL)
+			break;
+#else
+		if(pthread_create(&atThread[i],NULL,BatchWorker,&atWorker[i]))
+			break;
+#endif
+		iStarted=i;
+	}
+
+	atWorker[0].ptPool=&tPool;
+	atWorker[0].iWorker=0;
+	BatchWorker(&atWorker[0]);
+
+	for(i=1;i<=iStarted;i++){
+#ifdef _WIN32
+		WaitForSingleObject(ahThread[i],INFINITE);
+		CloseHandle(ahThread[i]);
+#else
+		pthread_join(atThread[i],NULL);
+#endif
+	}
+
+#ifdef _WIN32
+	free(ahThread);
+#else
+	free(atThread);
+#endif
+	free(atWorker);
+	return 0;
+}
+
+
+
+/* mutex for data shared between workers */
+void* BatchLockCreate(void){
+#ifdef _WIN32
+	CRITICAL_SECTION* ptLock=MemAlloc(sizeof(CRITICAL_SECTION));
+	if(ptLock)
+		InitializeCriticalSection(ptLock);
+#else
+	pthread_mutex_t* ptLock=MemAlloc(sizeof(pthread_mutex_t));
+	if(ptLock)
+		pthread_mutex_init(ptLock,NULL);
+#endif
+	return ptLock;
+}
+
+void BatchLock(void* pvLock){
+#ifdef _WIN32
+	EnterCriticalSection((CRITICAL_SECTION*)pvLock);
+#else
+	pthread_mutex_lock((pthread_mutex_t*)pvLock);
+#endif
+}
+
+void BatchUnlock(void* pvLock){
+#ifdef _WIN32
+	LeaveCriticalSection((CRITICAL_SECTION*)pvLock);
+#else
+	pthread_mutex_unlock((pthread_mutex_t*)pvLock);
+#endif
+}
+
+void BatchLockDestroy(void* pvLock){
+	if(pvLock==NULL)
+		return;
+#ifdef _WIN32
+	DeleteCriticalSection((CRITICAL_SECTION*)pvLock);
+#else
+	pthread_mutex_destroy((pthread_mutex_t*)pvLock);
+#endif
+	free(pvLock);
+}
+
+
+
+/* read only mapping of a whole file, the data is used in place */
+int BatchMapFile(char* szFilename, BATCH_MAP_T* ptMap){
+	memset(ptMap,0,sizeof(BATCH_MAP_T));
+#ifdef _WIN32
+	{
+		LARGE_INTEGER tSize;
+		ptMap->hFile=CreateFileA(szFilename,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+		if(ptMap->hFile==INVALID_HANDLE_VALUE)
+			return EXIT_FAILURE;
+		if(!GetFileSizeEx(ptMap->hFile,&tSize) || tSize.QuadPart==0){
+			CloseHandle(ptMap->hFile);
+			return EXIT_FAILURE;
+		}
+		ptMap->ulSize=(size_t)tSize.QuadPart;
+		ptMap->hMapping=CreateFileMappingA(ptMap->hFile,NULL,PAGE_READONLY,0,0,NULL);
+		if(ptMap->hMapping==NULL){
+			CloseHandle(ptMap->hFile);
+			return EXIT_FAILURE;
+		}
+		ptMap->pabData=MapViewOfFile(ptMap->hMapping,FILE_MAP_READ,0,0,0);
+		if(ptMap->pabData==NULL){
+			CloseHandle(ptMap->hMapping);
+			CloseHandle(ptMap->hFile);
+			return EXIT_FAILURE;
+		}
+	}
+#else
+	{
+		struct stat tStat;
+		void* pvData=0;
+		int iFd=open(szFilename,O_RDONLY);
+		if(iFd<0)
+			return EXIT_FAILURE;
+		if(fstat(iFd,&tStat) || tStat.st_size==0){
+			close(iFd);
+			return EXIT_FAILURE;
+		}
+		ptMap->ulSize=tStat.st_size;
+		pvData=mmap(NULL,ptMap->ulSize,PROT_READ,MAP_SHARED,iFd,0);
+		close(iFd);
+		if(pvData==MAP_FAILED)
+			return EXIT_FAILURE;
+		ptMap->pabData=pvData;
+	}
+#endif
+	return 0;
+}
+
+void BatchUnmapFile(BATCH_MAP_T* ptMap){
+#ifdef _WIN32
+	UnmapViewOfFile(ptMap->pabData);
+	CloseHandle(ptMap->hMapping);
+	CloseHandle(ptMap->hFile);
+#else
+	munmap((void*)ptMap->pabData,ptMap->ulSize);
+#endif
+}
+
+
+
+static int BatchCompareSize(const void* pvA, const void* pvB){
+	const BATCH_FILE_SIZE_T* ptA=(const BATCH_FILE_SIZE_T*)pvA;
+	const BATCH_FILE_SIZE_T* ptB=(const BATCH_FILE_SIZE_T*)pvB;
+
+	if(ptA->ullSize!=ptB->ullSize)
+		return ptA->ullSize<ptB->ullSize ? -1 : 1;
+	return ptA->iFile-ptB->iFile;
+}
+
+
+
+/* file indexes sorted by file size, for jobs hashing several files in the lanes of one engine,
+ * files that can't be accessed are sorted first, the caller frees the array */
+int* BatchOrderBySize(char** aszFiles, int iNumFiles){
+	BATCH_FILE_SIZE_T* atSize=0;
+	int* aiOrder=0;
+	int i=0;
+
+	atSize=MemAlloc(iNumFiles*sizeof(BATCH_FILE_SIZE_T));
+	aiOrder=MemAlloc(iNumFiles*sizeof(int));
+	if(atSize==NULL || aiOrder==NULL){
+		printf("error malloc\n");
+		free(atSize);
+		free(aiOrder);
+		return NULL;
+	}
+
+	for(i=0;i<iNumFiles;i++){
+		struct stat tStat;
+		atSize[i].iFile=i;
+		atSize[i].ullSize=stat(aszFiles[i],&tStat)==0 ? (uint64_t)tStat.st_size : 0;
+	}
+	qsort(atSize,iNumFiles,sizeof(BATCH_FILE_SIZE_T),BatchCompareSize);
+	for(i=0;i<iNumFiles;i++){
+		aiOrder[i]=atSize[i].iFile;
+	}
+
+	free(atSize);
+	return aiOrder;
+}
+
+
+
+/* physical byte offset of the first extent of the file, files without extents (empty, inline data)
+ * are at 0, returns false if the file system can't map extents */
+static bool BatchFirstExtent(const char* szFilename, uint64_t* pullPhysical){
+#ifdef __linux__
+	uint64_t aullMap[(sizeof(struct fiemap)+sizeof(struct fiemap_extent))/sizeof(uint64_t)+1];
+	struct fiemap* ptMap=(struct fiemap*)aullMap;
+	int iFd=open(szFilename,O_RDONLY);
+	int iRes=0;
+
+	*pullPhysical=0;
+	if(iFd<0)
+		return true;
+	memset(aullMap,0,sizeof(aullMap));
+	ptMap->fm_start=0;
+	ptMap->fm_length=FIEMAP_MAX_OFFSET;
+	ptMap->fm_extent_count=1;
+	iRes=ioctl(iFd,FS_IOC_FIEMAP,ptMap);
+	close(iFd);
+	if(iRes)
+		return false;
+	if(ptMap->fm_mapped_extents && !(ptMap->fm_extents[0].fe_flags&FIEMAP_EXTENT_UNKNOWN))
+		*pullPhysical=ptMap->fm_extents[0].fe_physical;
+	return true;
+#else
+	(void)szFilename;
+	*pullPhysical=0;
+	return false;
+#endif
+}
+
+
+
+static int BatchComparePosition(const void* pvA, const void* pvB){
+	const BATCH_FILE_POS_T* ptA=(const BATCH_FILE_POS_T*)pvA;
+	const BATCH_FILE_POS_T* ptB=(const BATCH_FILE_POS_T*)pvB;
+
+	if(ptA->ullDevice!=ptB->ullDevice)
+		return ptA->ullDevice<ptB->ullDevice ? -1 : 1;
+	if(ptA->ullPhysical!=ptB->ullPhysical)
+		return ptA->ullPhysical<ptB->ullPhysical ? -1 : 1;
+	if(ptA->ullInode!=ptB->ullInode)
+		return ptA->ullInode<ptB->ullInode ? -1 : 1;
+	return ptA->iFile-ptB->iFile;
+}
+
+
+
+/* file indexes in the order of their data on the disk: by the first extent (FIEMAP), or by
+ * inode number if any file system of the batch can't map extents. *pbExtents tells which.
+ * files that can't be accessed are sorted first, the caller frees the array */
+int* BatchOrderByPosition(char** aszFiles, int iNumFiles, bool* pbExtents){
+	BATCH_FILE_POS_T* atPos=0;
+	int* aiOrder=0;
+	int i=0;
+
+	*pbExtents=true;
+	atPos=MemCalloc(iNumFiles,sizeof(BATCH_FILE_POS_T));
+	aiOrder=MemAlloc(iNumFiles*sizeof(int));
+	if(atPos==NULL || aiOrder==NULL){
+		printf("error malloc\n");
+		free(atPos);
+		free(aiOrder);
+		return NULL;
+	}
+
+	for(i=0;i<iNumFiles;i++){
+		FILE_ID_T tId;
+
+		atPos[i].iFile=i;
+		if(GetFileId(aszFiles[i],&tId))
+			continue;
+		atPos[i].ullDevice=tId.ullDevice;
+		atPos[i].ullInode=tId.ullInode;
+		if(*pbExtents && !BatchFirstExtent(aszFiles[i],&atPos[i].ullPhysical))
+			*pbExtents=false;
+	}
+	if(!*pbExtents){
+		for(i=0;i<iNumFiles;i++){
+			atPos[i].ullPhysical=0;
+		}
+	}
+	qsort(atPos,iNumFiles,sizeof(BATCH_FILE_POS_T),BatchComparePosition);
+	for(i=0;i<iNumFiles;i++){
+		aiOrder[i]=atPos[i].iFile;
+	}
+
+	free(atPos);
+	return aiOrder;
+}
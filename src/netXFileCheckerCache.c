@@ -0,0 +1,515 @@
+/*
+ * netXFileCheckerCache.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  persistent result cache for batch runs
+ *  entries are found by file identity (device, inode, size, mtime) without reading the file,
+ *  or by the SHA-256 content hash when the identity changed (copied or touched files).
+ *  Entries of files modified shortly before they were cached are not trusted by identity,
+ *  the content hash decides. The content key includes file type, use case and record version,
+ *  the same bytes analyzed differently are different entries. Entries not used for
+ *  CACHE_PRUNE_NS and entries of older record versions are dropped.
+ *  The cache file is replaced atomically under a lock file, entries written by other
+ *  processes in the meantime are merged.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "netXFileChecker.h"
+
+
+#define CACHE_MAGIC    0x48434E4E // "NNCH"
+#define CACHE_VERSION  0x00020000
+#define CACHE_RACY_NS  (2*1000000000LL) // mtime granularity margin
+#define CACHE_DAY_NS   (24*3600*1000000000LL)
+#define CACHE_PRUNE_NS (90*CACHE_DAY_NS) // entries unused for this long are dropped
+#define CACHE_TOUCH_NS CACHE_DAY_NS      // the last use is updated at most once per day
+
+typedef struct CACHE_FILE_HEADER_Ttag {
+	uint32_t ulMagic;
+	uint32_t ulVersion;
+	uint32_t ulEntrySize;
+	uint32_t ulNumEntries;
+} CACHE_FILE_HEADER_T;
+
+/* content key, the same bytes as another file type or use case have another record */
+typedef struct CACHE_KEY_Ttag {
+	uint8_t abSha256[SHA256_DIGEST_SIZE];
+	uint32_t ulFileType;
+	uint32_t ulUseCase;
+	uint32_t ulRecordVersion;    // RECORD_VERSION of the analyzer that built the record
+} CACHE_KEY_T;
+
+typedef struct CACHE_ENTRY_Ttag {
+	FILE_ID_T tId;
+	int64_t llCachedAt;          // time the record was created, same clock as the mtime
+	int64_t llUsedAt;            // last hit, entries are pruned by it
+	CACHE_KEY_T tKey;
+	NETX_RECORD_T tRecord;
+} CACHE_ENTRY_T;
+
+struct RESULT_CACHE_Ttag {
+	char szFilename[BATCH_MAX_PATH];
+	void* pvLock;
+	CACHE_ENTRY_T* atEntry;
+	uint32_t ulNumEntries;
+	uint32_t ulMaxEntries;
+	uint32_t* aulIdIndex;        // open addressing, entry index + 1, 0 = empty
+	uint32_t* aulHashIndex;
+	uint32_t ulIndexSize;        // power of two
+	bool bModified;
+	uint32_t ulHitsId;
+	uint32_t ulHitsHash;
+	uint32_t ulMisses;
+	uint32_t ulPruned;
+};
+
+
+
+static int64_t CacheNow(void){
+#ifdef _WIN32
+	FILETIME tTime;
+	GetSystemTimeAsFileTime(&tTime);
+	return (((int64_t)tTime.dwHighDateTime<<32)|tTime.dwLowDateTime)*100;
+#else
+	struct timespec tTime;
+	clock_gettime(CLOCK_REALTIME,&tTime);
+	return (int64_t)tTime.tv_sec*1000000000LL+tTime.tv_nsec;
+#endif
+}
+
+
+
+int GetFileId(const char* szFilename, FILE_ID_T* ptId){
+	memset(ptId,0,sizeof(FILE_ID_T));
+#ifdef _WIN32
+	{
+		BY_HANDLE_FILE_INFORMATION tInfo;
+		HANDLE hFile=CreateFileA(szFilename,FILE_READ_ATTRIBUTES,FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,NULL,OPEN_EXISTING,FILE_FLAG_BACKUP_SEMANTICS,NULL);
+		if(hFile==INVALID_HANDLE_VALUE)
+			return EXIT_FAILURE;
+		if(!GetFileInformationByHandle(hFile,&tInfo)){
+			CloseHandle(hFile);
+			return EXIT_FAILURE;
+		}
+		CloseHandle(hFile);
+		ptId->ullDevice=tInfo.dwVolumeSerialNumber;
+		ptId->ullInode=((uint64_t)tInfo.nFileIndexHigh<<32)|tInfo.nFileIndexLow;
+		ptId->ullSize=((uint64_t)tInfo.nFileSizeHigh<<32)|tInfo.nFileSizeLow;
+		ptId->llMTime=(((int64_t)tInfo.ftLastWriteTime.dwHighDateTime<<32)|tInfo.ftLastWriteTime.dwLowDateTime)*100;
+	}
+#else
+	{
+		struct stat tStat;
+		if(stat(szFilename,&tStat))
+			return EXIT_FAILURE;
+		ptId->ullDevice=tStat.st_dev;
+		ptId->ullInode=tStat.st_ino;
+		ptId->ullSize=tStat.st_size;
+#if defined(__APPLE__)
+		ptId->llMTime=(int64_t)tStat.st_mtimespec.tv_sec*1000000000LL+tStat.st_mtimespec.tv_nsec;
+#else
+		ptId->llMTime=(int64_t)tStat.st_mtim.tv_sec*1000000000LL+tStat.st_mtim.tv_nsec;
+#endif
+	}
+#endif
+	return 0;
+}
+
+
+
+static uint32_t CacheHashBytes(const void* pvData, size_t ulSize){
+	const uint8_t* pabData=(const uint8_t*)pvData;
+	uint32_t ulHash=0x811C9DC5; // FNV-1a
+	size_t i=0;
+
+	for(i=0;i<ulSize;i++){
+		ulHash=(ulHash^pabData[i])*0x01000193;
+	}
+	return ulHash;
+}
+
+
+
+static uint32_t* CacheIndexSlot(uint32_t* aulIndex, uint32_t ulIndexSize, uint32_t ulHash, const CACHE_ENTRY_T* atEntry, const void* pvKey, size_t ulKeyOffset, size_t ulKeySize){
+	uint32_t ulSlot=ulHash&(ulIndexSize-1);
+
+	while(aulIndex[ulSlot]){
+		if(0==memcmp((const uint8_t*)&atEntry[aulIndex[ulSlot]-1]+ulKeyOffset,pvKey,ulKeySize))
+			break;
+		ulSlot=(ulSlot+1)&(ulIndexSize-1);
+	}
+	return &aulIndex[ulSlot];
+}
+
+#define ID_KEY_OFFSET   ((size_t)&((CACHE_ENTRY_T*)0)->tId)
+#define HASH_KEY_OFFSET ((size_t)&((CACHE_ENTRY_T*)0)->tKey)
+
+static uint32_t* CacheIdSlot(RESULT_CACHE_T* ptCache, const FILE_ID_T* ptId){
+	return CacheIndexSlot(ptCache->aulIdIndex,ptCache->ulIndexSize,CacheHashBytes(ptId,sizeof(FILE_ID_T)),ptCache->atEntry,ptId,ID_KEY_OFFSET,sizeof(FILE_ID_T));
+}
+
+static uint32_t* CacheHashSlot(RESULT_CACHE_T* ptCache, const CACHE_KEY_T* ptKey){
+	return CacheIndexSlot(ptCache->aulHashIndex,ptCache->ulIndexSize,CacheHashBytes(ptKey,sizeof(CACHE_KEY_T)),ptCache->atEntry,ptKey,HASH_KEY_OFFSET,sizeof(CACHE_KEY_T));
+}
+
+static void CacheSetKey(CACHE_KEY_T* ptKey, const uint8_t* abSha256, FILE_TYPE_E eFileType, int iUseCase){
+	memset(ptKey,0,sizeof(CACHE_KEY_T));
+	memcpy(ptKey->abSha256,abSha256,SHA256_DIGEST_SIZE);
+	ptKey->ulFileType=eFileType;
+	ptKey->ulUseCase=iUseCase;
+	ptKey->ulRecordVersion=RECORD_VERSION;
+}
+
+/* a hit keeps the entry alive, the file is rewritten for it at most once per CACHE_TOUCH_NS */
+static void CacheTouch(RESULT_CACHE_T* ptCache, CACHE_ENTRY_T* ptEntry){
+	int64_t llNow=CacheNow();
+
+	if(ptEntry->llUsedAt+CACHE_TOUCH_NS<llNow){
+		ptEntry->llUsedAt=llNow;
+		ptCache->bModified=true;
+	}
+}
+
+
+
+/* rebuilds both indexes, the index is kept at most half full */
+static int CacheReindex(RESULT_CACHE_T* ptCache){
+	uint32_t ulSize=1024;
+	uint32_t i=0;
+
+	while(ulSize<2*ptCache->ulNumEntries+2){
+		ulSize<<=1;
+	}
+	free(ptCache->aulIdIndex);
+	free(ptCache->aulHashIndex);
+	ptCache->aulIdIndex=MemCalloc(ulSize,sizeof(uint32_t));
+	ptCache->aulHashIndex=MemCalloc(ulSize,sizeof(uint32_t));
+	if(ptCache->aulIdIndex==NULL || ptCache->aulHashIndex==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+	ptCache->ulIndexSize=ulSize;
+
+	for(i=0;i<ptCache->ulNumEntries;i++){
+		*CacheIdSlot(ptCache,&ptCache->atEntry[i].tId)=i+1;
+		*CacheHashSlot(ptCache,&ptCache->atEntry[i].tKey)=i+1;
+	}
+	return 0;
+}
+
+
+
+/* adds or replaces the entry with the same identity */
+static int CacheAddEntry(RESULT_CACHE_T* ptCache, const CACHE_ENTRY_T* ptEntry, bool bReplace){
+	uint32_t* pulSlot=CacheIdSlot(ptCache,&ptEntry->tId);
+
+	if(*pulSlot){
+		if(bReplace){
+			ptCache->atEntry[*pulSlot-1]=*ptEntry;
+			*CacheHashSlot(ptCache,&ptEntry->tKey)=*pulSlot;
+		}
+		return 0;
+	}
+
+	if(ptCache->ulNumEntries==ptCache->ulMaxEntries){
+		uint32_t ulMax=ptCache->ulMaxEntries ? 2*ptCache->ulMaxEntries : 1024;
+		CACHE_ENTRY_T* atNew=MemRealloc(ptCache->atEntry,ulMax*sizeof(CACHE_ENTRY_T));
+		if(atNew==NULL){
+			printf("error malloc\n");
+			return EXIT_FAILURE;
+		}
+		ptCache->atEntry=atNew;
+		ptCache->ulMaxEntries=ulMax;
+	}
+	ptCache->atEntry[ptCache->ulNumEntries++]=*ptEntry;
+
+	if(2*ptCache->ulNumEntries+2>ptCache->ulIndexSize){
+		return CacheReindex(ptCache);
+	}
+	*CacheIdSlot(ptCache,&ptEntry->tId)=ptCache->ulNumEntries;
+	*CacheHashSlot(ptCache,&ptEntry->tKey)=ptCache->ulNumEntries;
+	return 0;
+}
+
+
+
+/* inter process lock, held while the cache file is read or replaced */
+#ifdef _WIN32
+typedef HANDLE CACHE_FILE_LOCK_T;
+#else
+typedef int CACHE_FILE_LOCK_T;
+#endif
+
+static bool CacheFileLock(const char* szCacheFilename, CACHE_FILE_LOCK_T* ptLock){
+	char szLockFile[BATCH_MAX_PATH+8];
+
+	snprintf(szLockFile,sizeof(szLockFile),"%s.lock",szCacheFilename);
+#ifdef _WIN32
+	{
+		OVERLAPPED tOverlapped;
+		memset(&tOverlapped,0,sizeof(tOverlapped));
+		*ptLock=CreateFileA(szLockFile,GENERIC_READ|GENERIC_WRITE,FILE_SHARE_READ|FILE_SHARE_WRITE,NULL,OPEN_ALWAYS,FILE_ATTRIBUTE_NORMAL,NULL);
+		if(*ptLock==INVALID_HANDLE_VALUE)
+			return false;
+		if(!LockFileEx(*ptLock,LOCKFILE_EXCLUSIVE_LOCK,0,1,0,&tOverlapped)){
+			CloseHandle(*ptLock);
+			return false;
+		}
+	}
+#else
+	{
+		struct flock tLock;
+		*ptLock=open(szLockFile,O_RDWR|O_CREAT,0644);
+		if(*ptLock<0)
+			return false;
+		memset(&tLock,0,sizeof(tLock));
+		tLock.l_type=F_WRLCK;
+		tLock.l_whence=SEEK_SET;
+		if(fcntl(*ptLock,F_SETLKW,&tLock)){
+			close(*ptLock);
+			return false;
+		}
+	}
+#endif
+	return true;
+}
+
+static void CacheFileUnlock(CACHE_FILE_LOCK_T tLock){
+#ifdef _WIN32
+	CloseHandle(tLock);
+#else
+	close(tLock);
+#endif
+}
+
+
+
+/* reads the cache file and adds entries not known yet, a missing or outdated file is ignored,
+ * unused entries and entries of another record version are pruned */
+static int CacheReadFile(RESULT_CACHE_T* ptCache, bool bReplace){
+	FILE* hFile=NULL;
+	CACHE_FILE_HEADER_T tHeader;
+	CACHE_ENTRY_T tEntry;
+	int64_t llNow=CacheNow();
+	uint32_t i=0;
+
+	hFile=fopen(ptCache->szFilename,"rb");
+	if(hFile==NULL)
+		return 0;
+
+	if(fread(&tHeader,sizeof(tHeader),1,hFile)!=1 || tHeader.ulMagic!=CACHE_MAGIC
+			|| tHeader.ulVersion!=CACHE_VERSION || tHeader.ulEntrySize!=sizeof(CACHE_ENTRY_T)){
+		printf("cache %s outdated, rebuilding\n",ptCache->szFilename);
+		fclose(hFile);
+		return 0;
+	}
+	for(i=0;i<tHeader.ulNumEntries;i++){
+		if(fread(&tEntry,sizeof(tEntry),1,hFile)!=1)
+			break;
+		if(tEntry.tKey.ulRecordVersion!=RECORD_VERSION || tEntry.llUsedAt+CACHE_PRUNE_NS<llNow){
+			if(bReplace)
+				ptCache->ulPruned++;
+			ptCache->bModified=true;
+			continue;
+		}
+		if(CacheAddEntry(ptCache,&tEntry,bReplace))
+			break;
+	}
+	fclose(hFile);
+	return 0;
+}
+
+
+
+RESULT_CACHE_T* CacheOpen(char* szCacheFilename){
+	RESULT_CACHE_T* ptCache=0;
+	CACHE_FILE_LOCK_T tLock;
+
+	if(strlen(szCacheFilename)>=BATCH_MAX_PATH){
+		printf("Error: filename too long\n");
+		return NULL;
+	}
+
+	ptCache=MemCalloc(1,sizeof(RESULT_CACHE_T));
+	if(ptCache==NULL){
+		printf("error malloc\n");
+		return NULL;
+	}
+	strcpy(ptCache->szFilename,szCacheFilename);
+	ptCache->pvLock=BatchLockCreate();
+	if(ptCache->pvLock==NULL || CacheReindex(ptCache)){
+		CacheClose(ptCache);
+		return NULL;
+	}
+
+	if(!CacheFileLock(szCacheFilename,&tLock)){
+		printf("error locking cache %s\n",szCacheFilename);
+		CacheClose(ptCache);
+		return NULL;
+	}
+	CacheReadFile(ptCache,true);
+	CacheFileUnlock(tLock);
+
+	return ptCache;
+}
+
+
+
+/* identity hit, the file does not need to be read */
+bool CacheLookupId(RESULT_CACHE_T* ptCache, const FILE_ID_T* ptId, FILE_TYPE_E eFileType, int iUseCase, NETX_RECORD_T* ptRecord){
+	bool bHit=false;
+	uint32_t ulEntry=0;
+
+	BatchLock(ptCache->pvLock);
+	ulEntry=*CacheIdSlot(ptCache,ptId);
+	if(ulEntry){
+		CACHE_ENTRY_T* ptEntry=&ptCache->atEntry[ulEntry-1];
+		/* a file written within the mtime granularity before caching may have changed unnoticed,
+		 * a renamed file keeps its identity but may have another type */
+		if(ptEntry->tKey.ulFileType==(uint32_t)eFileType && ptEntry->tKey.ulUseCase==(uint32_t)iUseCase
+				&& ptEntry->tId.llMTime+CACHE_RACY_NS<ptEntry->llCachedAt){
+			*ptRecord=ptEntry->tRecord;
+			CacheTouch(ptCache,ptEntry);
+			ptCache->ulHitsId++;
+			bHit=true;
+		}
+	}
+	BatchUnlock(ptCache->pvLock);
+	return bHit;
+}
+
+
+
+/* content hit, the file was read and hashed but does not need to be analyzed */
+bool CacheLookupHash(RESULT_CACHE_T* ptCache, const uint8_t* abSha256, FILE_TYPE_E eFileType, int iUseCase, NETX_RECORD_T* ptRecord){
+	CACHE_KEY_T tKey;
+	bool bHit=false;
+	uint32_t ulEntry=0;
+
+	CacheSetKey(&tKey,abSha256,eFileType,iUseCase);
+	BatchLock(ptCache->pvLock);
+	ulEntry=*CacheHashSlot(ptCache,&tKey);
+	if(ulEntry){
+		*ptRecord=ptCache->atEntry[ulEntry-1].tRecord;
+		CacheTouch(ptCache,&ptCache->atEntry[ulEntry-1]);
+		ptCache->ulHitsHash++;
+		bHit=true;
+	}
+	else {
+		ptCache->ulMisses++;
+	}
+	BatchUnlock(ptCache->pvLock);
+	return bHit;
+}
+
+
+
+void CacheInsert(RESULT_CACHE_T* ptCache, const FILE_ID_T* ptId, const NETX_RECORD_T* ptRecord){
+	CACHE_ENTRY_T tEntry;
+
+	memset(&tEntry,0,sizeof(tEntry));
+	tEntry.tId=*ptId;
+	tEntry.llCachedAt=CacheNow();
+	tEntry.llUsedAt=tEntry.llCachedAt;
+	CacheSetKey(&tEntry.tKey,ptRecord->abSha256,(FILE_TYPE_E)ptRecord->ulFileType,(int)ptRecord->ulUseCase);
+	tEntry.tRecord=*ptRecord;
+
+	BatchLock(ptCache->pvLock);
+	if(0==CacheAddEntry(ptCache,&tEntry,true)){
+		ptCache->bModified=true;
+	}
+	BatchUnlock(ptCache->pvLock);
+}
+
+
+
+/* merges entries written by other processes meanwhile and replaces the cache file */
+static int CacheWriteFile(RESULT_CACHE_T* ptCache){
+	char szTmpFile[BATCH_MAX_PATH+8];
+	FILE* hFile=NULL;
+	CACHE_FILE_HEADER_T tHeader;
+	CACHE_FILE_LOCK_T tLock;
+	int iRes=0;
+
+	if(!CacheFileLock(ptCache->szFilename,&tLock)){
+		printf("error locking cache %s\n",ptCache->szFilename);
+		return EXIT_FAILURE;
+	}
+	CacheReadFile(ptCache,false);
+
+	snprintf(szTmpFile,sizeof(szTmpFile),"%s.tmp",ptCache->szFilename);
+	hFile=fopen(szTmpFile,"wb");
+	if(hFile==NULL){
+		printf("error opening file %s\n",szTmpFile);
+		CacheFileUnlock(tLock);
+		return EXIT_FAILURE;
+	}
+	tHeader.ulMagic=CACHE_MAGIC;
+	tHeader.ulVersion=CACHE_VERSION;
+	tHeader.ulEntrySize=sizeof(CACHE_ENTRY_T);
+	tHeader.ulNumEntries=ptCache->ulNumEntries;
+	if(fwrite(&tHeader,sizeof(tHeader),1,hFile)!=1
+			|| fwrite(ptCache->atEntry,sizeof(CACHE_ENTRY_T),ptCache->ulNumEntries,hFile)!=ptCache->ulNumEntries){
+		iRes=EXIT_FAILURE;
+	}
+	if(fclose(hFile)){
+		iRes=EXIT_FAILURE;
+	}
+
+	if(iRes==0){
+#ifdef _WIN32
+		if(!MoveFileExA(szTmpFile,ptCache->szFilename,MOVEFILE_REPLACE_EXISTING))
+			iRes=EXIT_FAILURE;
+#else
+		if(rename(szTmpFile,ptCache->szFilename))
+			iRes=EXIT_FAILURE;
+#endif
+	}
+	if(iRes){
+		printf("error writing cache %s\n",ptCache->szFilename);
+		remove(szTmpFile);
+	}
+
+	CacheFileUnlock(tLock);
+	return iRes;
+}
+
+
+
+int CacheClose(RESULT_CACHE_T* ptCache){
+	int iRes=0;
+
+	if(ptCache==NULL)
+		return 0;
+
+	if(ptCache->bModified){
+		iRes=CacheWriteFile(ptCache);
+	}
+	if(ptCache->ulHitsId+ptCache->ulHitsHash+ptCache->ulMisses){
+		printf("cache: %d unchanged, %d identical content, %d analyzed, %d entries, %d pruned\n"
+				,ptCache->ulHitsId,ptCache->ulHitsHash,ptCache->ulMisses,ptCache->ulNumEntries,ptCache->ulPruned);
+	}
+
+	BatchLockDestroy(ptCache->pvLock);
+	free(ptCache->aulIdIndex);
+	free(ptCache->aulHashIndex);
+	free(ptCache->atEntry);
+	free(ptCache);
+	return iRes;
+}
@@ -0,0 +1,492 @@
+/*
+ * netXFileCheckerCompat.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  firmware to hardware compatibility check of flash dumps
+ *  the device info of each firmware (NXI, UPD, MXF) is checked against the FDL of the dump,
+ *  optionally the combination is checked against a compatibility matrix file.
+ *  Rules are tables of field offsets into NETX_RECORD_T, the matrix is compiled into the same
+ *  form when it is loaded, so a check is a loop over the tables without any parsing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "netXFileChecker.h"
+#include "Hil_SharedDefines.h"
+
+
+#define COMPAT_SIZE_VERSION  8   // packed ausFwVersion
+
+typedef struct COMPAT_RULE_Ttag {
+	const char* szName;
+	uint16_t usFdlOffset;        // field in the FDL part of NETX_RECORD_T
+	uint16_t usFwOffset;         // field in NETX_FW_RECORD_T
+	uint8_t bSize;
+	bool bHasAny;
+	uint32_t ulAny;              // firmware value accepted for every device
+} COMPAT_RULE_T;
+
+#define FDL_FIELD(f) (uint16_t)offsetof(NETX_RECORD_T,tBasicDeviceData.f)
+#define FW_FIELD(f)  (uint16_t)offsetof(NETX_FW_RECORD_T,f)
+
+/* firmware device info against FDL basic device data */
+static const COMPAT_RULE_T s_atCompatRules[]={
+	{"manufacturer",     FDL_FIELD(usManufacturer),   FW_FIELD(usManufacturer),   2, true,  HIL_MANUFACTURER_UNDEFINED},
+	{"device class",     FDL_FIELD(usDeviceClass),    FW_FIELD(usDeviceClass),    2, true,  HIL_HW_DEV_CLASS_UNDEFINED},
+	{"hw compatibility", FDL_FIELD(bHwCompatibility), FW_FIELD(bHwCompatibility), 1, false, 0},
+	{"device number",    FDL_FIELD(ulDeviceNumber),   FW_FIELD(ulDeviceNumber),   4, true,  0},
+	{"serial number",    FDL_FIELD(ulSerialNumber),   FW_FIELD(ulSerialNumber),   4, true,  0},
+};
+
+typedef struct COMPAT_SLOT_Ttag {
+	const char* szName;
+	int iSlot;
+} COMPAT_SLOT_T;
+
+static const COMPAT_SLOT_T s_atCompatSlots[]={
+	{"nxi",RECORD_FW_COM},
+	{"upd",RECORD_FW_UPD},
+	{"mxf",RECORD_FW_MXF},
+	{"nai",RECORD_FW_NAI},
+};
+
+#define SLOT_OFFSET(iSlot) (uint16_t)(offsetof(NETX_RECORD_T,atFw)+(iSlot)*sizeof(NETX_FW_RECORD_T))
+
+
+
+/* compatibility matrix, one combination per line, all terms of a line must match
+ *   FDL terms select the devices a line applies to:
+ *     manufacturer= class= device= serial= hwcomp= hw= date=         value or lo-hi
+ *   firmware terms, prefixed by the area nxi. upd. mxf. nai.:
+ *     fw=2.3.x fwnum= class= hwcomp= chip= device= manufacturer= lic1= lic2= licid= licflags=  value or lo-hi
+ *     hwopt=      one of the four hardware options
+ * a device passes if a line selecting it has all firmware terms fulfilled
+ */
+#define COMPAT_TERM_RANGE    0
+#define COMPAT_TERM_VERSION  1   // ullLow value, ullHigh mask
+#define COMPAT_TERM_HWOPT    2
+#define COMPAT_TERM_PRESENT  3   // firmware area not erased
+
+typedef struct COMPAT_TERM_Ttag {
+	uint16_t usOffset;           // in NETX_RECORD_T
+	uint8_t bSize;
+	uint8_t bType;
+	uint64_t ullLow;
+	uint64_t ullHigh;
+} COMPAT_TERM_T;
+
+typedef struct COMPAT_LINE_Ttag {
+	uint32_t ulFirstSelect;
+	uint32_t ulNumSelect;
+	uint32_t ulFirstRequire;
+	uint32_t ulNumRequire;
+	int iLine;                   // line number in the matrix file
+} COMPAT_LINE_T;
+
+struct COMPAT_MATRIX_Ttag {
+	COMPAT_TERM_T* atTerm;
+	uint32_t ulNumTerms;
+	uint32_t ulMaxTerms;
+	COMPAT_LINE_T* atLine;
+	uint32_t ulNumLines;
+};
+
+typedef struct COMPAT_FIELD_Ttag {
+	const char* szName;
+	uint16_t usOffset;
+	uint8_t bSize;
+	uint8_t bType;
+} COMPAT_FIELD_T;
+
+static const COMPAT_FIELD_T s_atFdlFields[]={
+	{"manufacturer", FDL_FIELD(usManufacturer),   2, COMPAT_TERM_RANGE},
+	{"class",        FDL_FIELD(usDeviceClass),    2, COMPAT_TERM_RANGE},
+	{"device",       FDL_FIELD(ulDeviceNumber),   4, COMPAT_TERM_RANGE},
+	{"serial",       FDL_FIELD(ulSerialNumber),   4, COMPAT_TERM_RANGE},
+	{"hwcomp",       FDL_FIELD(bHwCompatibility), 1, COMPAT_TERM_RANGE},
+	{"hw",           FDL_FIELD(bHwRevision),      1, COMPAT_TERM_RANGE},
+	{"date",         FDL_FIELD(usProductionDate), 2, COMPAT_TERM_RANGE},
+};
+
+static const COMPAT_FIELD_T s_atFwFields[]={
+	{"fw",           FW_FIELD(ausFwVersion),       COMPAT_SIZE_VERSION, COMPAT_TERM_VERSION},
+	{"fwnum",        FW_FIELD(ulFwNumber),         4, COMPAT_TERM_RANGE},
+	{"class",        FW_FIELD(usDeviceClass),      2, COMPAT_TERM_RANGE},
+	{"hwcomp",       FW_FIELD(bHwCompatibility),   1, COMPAT_TERM_RANGE},
+	{"chip",         FW_FIELD(bChipType),          1, COMPAT_TERM_RANGE},
+	{"device",       FW_FIELD(ulDeviceNumber),     4, COMPAT_TERM_RANGE},
+	{"manufacturer", FW_FIELD(usManufacturer),     2, COMPAT_TERM_RANGE},
+	{"lic1",         FW_FIELD(ulLicenseFlags1),    4, COMPAT_TERM_RANGE},
+	{"lic2",         FW_FIELD(ulLicenseFlags2),    4, COMPAT_TERM_RANGE},
+	{"licid",        FW_FIELD(usNetXLicenseID),    2, COMPAT_TERM_RANGE},
+	{"licflags",     FW_FIELD(usNetXLicenseFlags), 2, COMPAT_TERM_RANGE},
+	{"hwopt",        FW_FIELD(ausHwOptions),       2, COMPAT_TERM_HWOPT},
+};
+
+
+
+static uint64_t LoadField(const NETX_RECORD_T* ptRecord, uint16_t usOffset, uint8_t bSize){
+	const uint8_t* pabField=(const uint8_t*)ptRecord+usOffset;
+	uint16_t usValue=0;
+	uint32_t ulValue=0;
+
+	switch(bSize){
+	case 1:
+		return *pabField;
+	case 2:
+		memcpy(&usValue,pabField,2);
+		return usValue;
+	case 4:
+		memcpy(&ulValue,pabField,4);
+		return ulValue;
+	default:
+		return PackFwVersion((const uint16_t*)pabField);
+	}
+}
+
+
+
+static bool EvalTerm(const NETX_RECORD_T* ptRecord, const COMPAT_TERM_T* ptTerm){
+	uint64_t ullValue=0;
+	int i=0;
+
+	switch(ptTerm->bType){
+	case COMPAT_TERM_VERSION:
+		ullValue=LoadField(ptRecord,ptTerm->usOffset,ptTerm->bSize);
+		return ((ullValue^ptTerm->ullLow)&ptTerm->ullHigh)==0;
+	case COMPAT_TERM_HWOPT:
+		for(i=0;i<4;i++){
+			ullValue=LoadField(ptRecord,(uint16_t)(ptTerm->usOffset+2*i),2);
+			if(ullValue>=ptTerm->ullLow && ullValue<=ptTerm->ullHigh)
+				return true;
+		}
+		return false;
+	case COMPAT_TERM_PRESENT:
+		return LoadField(ptRecord,ptTerm->usOffset,4)!=0xFFFFFFFF;
+	default:
+		ullValue=LoadField(ptRecord,ptTerm->usOffset,ptTerm->bSize);
+		return ullValue>=ptTerm->ullLow && ullValue<=ptTerm->ullHigh;
+	}
+}
+
+
+
+static COMPAT_TERM_T* AddTerm(COMPAT_MATRIX_T* ptMatrix){
+	if(ptMatrix->ulNumTerms==ptMatrix->ulMaxTerms){
+		uint32_t ulMax=ptMatrix->ulMaxTerms ? 2*ptMatrix->ulMaxTerms : 64;
+		COMPAT_TERM_T* atNew=MemRealloc(ptMatrix->atTerm,ulMax*sizeof(COMPAT_TERM_T));
+		if(atNew==NULL){
+			printf("error malloc\n");
+			return NULL;
+		}
+		ptMatrix->atTerm=atNew;
+		ptMatrix->ulMaxTerms=ulMax;
+	}
+	memset(&ptMatrix->atTerm[ptMatrix->ulNumTerms],0,sizeof(COMPAT_TERM_T));
+	return &ptMatrix->atTerm[ptMatrix->ulNumTerms++];
+}
+
+
+
+static int CompileValue(char* szValue, COMPAT_TERM_T* ptTerm){
+	char* szEnd=0;
+
+	if(ptTerm->bType==COMPAT_TERM_VERSION)
+		return ParseVersionPattern(szValue,&ptTerm->ullLow,&ptTerm->ullHigh);
+
+	ptTerm->ullLow=strtoull(szValue,&szEnd,0);
+	if(szEnd==szValue)
+		return EXIT_FAILURE;
+	ptTerm->ullHigh=ptTerm->ullLow;
+	if(*szEnd=='-'){
+		szValue=szEnd+1;
+		ptTerm->ullHigh=strtoull(szValue,&szEnd,0);
+		if(szEnd==szValue)
+			return EXIT_FAILURE;
+	}
+	return (*szEnd || ptTerm->ullHigh<ptTerm->ullLow) ? EXIT_FAILURE : 0;
+}
+
+
+
+/* one matrix line into select terms (FDL) followed by require terms (firmware) */
+static int CompileLine(COMPAT_MATRIX_T* ptMatrix, char* szLine, COMPAT_LINE_T* ptLine){
+	char* szTerm=0;
+	bool abSlotUsed[RECORD_FW_NUM]={false};
+	COMPAT_TERM_T* ptTerm=0;
+	int iPass=0;
+	int i=0;
+
+	/* pass 0 compiles the FDL terms, pass 1 the firmware terms, so both are contiguous */
+	ptLine->ulFirstSelect=ptMatrix->ulNumTerms;
+	for(iPass=0;iPass<2;iPass++){
+		if(iPass==1)
+			ptLine->ulFirstRequire=ptMatrix->ulNumTerms;
+
+		for(szTerm=szLine;*szTerm;szTerm+=strlen(szTerm)+1){
+			char szName[32];
+			char* szValue=strchr(szTerm,'=');
+			char* szDot=strchr(szTerm,'.');
+			const COMPAT_FIELD_T* atField=s_atFdlFields;
+			int iNumFields=sizeof(s_atFdlFields)/sizeof(s_atFdlFields[0]);
+			uint16_t usBase=0;
+			int iSlot=-1;
+
+			if(szValue==NULL || szValue-szTerm>=(int)sizeof(szName)){
+				printf("invalid term \"%s\"",szTerm);
+				return EXIT_FAILURE;
+			}
+			memcpy(szName,szTerm,szValue-szTerm);
+			szName[szValue-szTerm]=0;
+			szValue++;
+
+			if(szDot!=NULL && szDot<szValue){
+				szName[szDot-szTerm]=0;
+				for(i=0;i<(int)(sizeof(s_atCompatSlots)/sizeof(s_atCompatSlots[0]));i++){
+					if(0==strcmp(szName,s_atCompatSlots[i].szName))
+						iSlot=s_atCompatSlots[i].iSlot;
+				}
+				if(iSlot<0){
+					printf("unknown firmware area \"%s\"",szName);
+					return EXIT_FAILURE;
+				}
+				memmove(szName,&szName[szDot-szTerm+1],strlen(&szName[szDot-szTerm+1])+1);
+				atField=s_atFwFields;
+				iNumFields=sizeof(s_atFwFields)/sizeof(s_atFwFields[0]);
+				usBase=SLOT_OFFSET(iSlot);
+			}
+			if((iSlot<0)!=(iPass==0))
+				continue;
+
+			for(i=0;i<iNumFields;i++){
+				if(0==strcmp(szName,atField[i].szName))
+					break;
+			}
+			if(i==iNumFields){
+				printf("unknown field \"%s\"",szName);
+				return EXIT_FAILURE;
+			}
+
+			if(iSlot>=0 && !abSlotUsed[iSlot]){
+				abSlotUsed[iSlot]=true;
+				ptTerm=AddTerm(ptMatrix);
+				if(ptTerm==NULL)
+					return EXIT_FAILURE;
+				ptTerm->usOffset=(uint16_t)(usBase+offsetof(NETX_FW_RECORD_T,ulCookie));
+				ptTerm->bSize=4;
+				ptTerm->bType=COMPAT_TERM_PRESENT;
+			}
+
+			ptTerm=AddTerm(ptMatrix);
+			if(ptTerm==NULL)
+				return EXIT_FAILURE;
+			ptTerm->usOffset=(uint16_t)(usBase+atField[i].usOffset);
+			ptTerm->bSize=atField[i].bSize;
+			ptTerm->bType=atField[i].bType;
+			if(CompileValue(szValue,ptTerm)){
+				printf("invalid value \"%s\"",szValue);
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	ptLine->ulNumSelect=ptLine->ulFirstRequire-ptLine->ulFirstSelect;
+	ptLine->ulNumRequire=ptMatrix->ulNumTerms-ptLine->ulFirstRequire;
+	return 0;
+}
+
+
+
+COMPAT_MATRIX_T* LoadCompatMatrix(char* szMatrixFile){
+	COMPAT_MATRIX_T* ptMatrix=0;
+	FILE* hFile=NULL;
+	char szLine[1024];
+	int iLine=0;
+	int iRes=0;
+
+	hFile=fopen(szMatrixFile,"r");
+	if(hFile==NULL){
+		printf("\nError opening file %s\n",szMatrixFile);
+		return NULL;
+	}
+	ptMatrix=MemCalloc(1,sizeof(COMPAT_MATRIX_T));
+	if(ptMatrix==NULL){
+		printf("error malloc\n");
+		fclose(hFile);
+		return NULL;
+	}
+
+	while(iRes==0 && fgets(szLine,sizeof(szLine)-1,hFile)){
+		char* szSrc=szLine;
+		char* szDst=szLine;
+		COMPAT_LINE_T* atNew=0;
+
+		iLine++;
+		/* terms separated by blanks, stored as a sequence of strings ending with an empty one */
+		while(*szSrc && *szSrc!='#' && *szSrc!='\n' && *szSrc!='\r'){
+			if(*szSrc==' ' || *szSrc=='\t' || *szSrc==','){
+				if(szDst>szLine && szDst[-1])
+					*szDst++=0;
+				szSrc++;
+			}
+			else {
+				*szDst++=*szSrc++;
+			}
+		}
+		if(szDst==szLine)
+			continue;
+		if(szDst[-1])
+			*szDst++=0;
+		*szDst=0;
+
+		atNew=MemRealloc(ptMatrix->atLine,(ptMatrix->ulNumLines+1)*sizeof(COMPAT_LINE_T));
+		if(atNew==NULL){
+			printf("error malloc\n");
+			iRes=EXIT_FAILURE;
+			break;
+		}
+		ptMatrix->atLine=atNew;
+		ptMatrix->atLine[ptMatrix->ulNumLines].iLine=iLine;
+		iRes=CompileLine(ptMatrix,szLine,&ptMatrix->atLine[ptMatrix->ulNumLines]);
+		if(iRes)
+			printf(" in %s line %d\n",szMatrixFile,iLine);
+		else
+			ptMatrix->ulNumLines++;
+	}
+	fclose(hFile);
+
+	if(iRes==0 && ptMatrix->ulNumLines==0){
+		printf("Error: no entries in %s\n",szMatrixFile);
+		iRes=EXIT_FAILURE;
+	}
+	if(iRes){
+		FreeCompatMatrix(ptMatrix);
+		return NULL;
+	}
+	return ptMatrix;
+}
+
+
+
+void FreeCompatMatrix(COMPAT_MATRIX_T* ptMatrix){
+	if(ptMatrix==NULL)
+		return;
+	free(ptMatrix->atTerm);
+	free(ptMatrix->atLine);
+	free(ptMatrix);
+}
+
+
+
+/* checks one record, prints the violations after the file name, returns the number of violations */
+int CheckCompatRecord(const NETX_RECORD_T* ptRecord, const COMPAT_MATRIX_T* ptMatrix){
+	int iViolations=0;
+	int iSlot=0;
+	uint32_t i=0;
+	uint32_t j=0;
+
+	if(ptRecord->ulFlags&RECORD_FLAG_LOAD_ERROR){
+		printf("  error reading file");
+		return 1;
+	}
+	if(0==(ptRecord->ulFlags&RECORD_FLAG_FDL_VALID)){
+		printf("  no valid FDL");
+		return 1;
+	}
+
+	for(iSlot=0;iSlot<(int)(sizeof(s_atCompatSlots)/sizeof(s_atCompatSlots[0]));iSlot++){
+		uint16_t usBase=SLOT_OFFSET(s_atCompatSlots[iSlot].iSlot);
+		if(LoadField(ptRecord,(uint16_t)(usBase+offsetof(NETX_FW_RECORD_T,ulCookie)),4)==0xFFFFFFFF)
+			continue;
+		for(i=0;i<sizeof(s_atCompatRules)/sizeof(s_atCompatRules[0]);i++){
+			const COMPAT_RULE_T* ptRule=&s_atCompatRules[i];
+			uint64_t ullFdl=LoadField(ptRecord,ptRule->usFdlOffset,ptRule->bSize);
+			uint64_t ullFw=LoadField(ptRecord,(uint16_t)(usBase+ptRule->usFwOffset),ptRule->bSize);
+			if(ullFw!=ullFdl && !(ptRule->bHasAny && ullFw==ptRule->ulAny)){
+				printf("  %s %s 0x%x, FDL 0x%x",s_atCompatSlots[iSlot].szName,ptRule->szName,(uint32_t)ullFw,(uint32_t)ullFdl);
+				iViolations++;
+			}
+		}
+	}
+
+	if(ptMatrix!=NULL){
+		bool bSelected=false;
+		bool bPassed=false;
+		for(i=0;i<ptMatrix->ulNumLines && !bPassed;i++){
+			const COMPAT_LINE_T* ptLine=&ptMatrix->atLine[i];
+			for(j=0;j<ptLine->ulNumSelect;j++){
+				if(!EvalTerm(ptRecord,&ptMatrix->atTerm[ptLine->ulFirstSelect+j]))
+					break;
+			}
+			if(j<ptLine->ulNumSelect)
+				continue;
+			bSelected=true;
+			for(j=0;j<ptLine->ulNumRequire;j++){
+				if(!EvalTerm(ptRecord,&ptMatrix->atTerm[ptLine->ulFirstRequire+j]))
+					break;
+			}
+			bPassed=(j==ptLine->ulNumRequire);
+		}
+		if(!bSelected){
+			printf("  matrix: no entry for device %d hw 0x%02x",ptRecord->tBasicDeviceData.ulDeviceNumber,ptRecord->tBasicDeviceData.bHwRevision);
+			iViolations++;
+		}
+		else if(!bPassed){
+			printf("  matrix: firmware combination not allowed");
+			iViolations++;
+		}
+	}
+	return iViolations;
+}
+
+
+
+int CheckCompatibility(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads, char* szCacheFilename, char* szMatrixFile){
+	NETX_RECORD_T* atRecord=0;
+	COMPAT_MATRIX_T* ptMatrix=0;
+	int iFailed=0;
+	int i=0;
+
+	if(szMatrixFile!=NULL){
+		ptMatrix=LoadCompatMatrix(szMatrixFile);
+		if(ptMatrix==NULL)
+			return EXIT_FAILURE;
+	}
+
+	atRecord=MemCalloc(iNumFiles,sizeof(NETX_RECORD_T));
+	if(atRecord==NULL){
+		printf("error malloc\n");
+		FreeCompatMatrix(ptMatrix);
+		return EXIT_FAILURE;
+	}
+	if(CollectRecords(aszFiles,iNumFiles,iUseCase,iNumThreads,szCacheFilename,atRecord,NULL)){
+		free(atRecord);
+		FreeCompatMatrix(ptMatrix);
+		return EXIT_FAILURE;
+	}
+
+	printf("\n--------------------------------------\nFIRMWARE / HARDWARE COMPATIBILITY\n");
+	printf("files:          %d\n",iNumFiles);
+	printf("matrix:         %s\n",szMatrixFile ? szMatrixFile : "-");
+	printf("--------------------------------------\n");
+	for(i=0;i<iNumFiles;i++){
+		printf("%s",aszFiles[i]);
+		if(CheckCompatRecord(&atRecord[i],ptMatrix)){
+			printf("  FAIL\n");
+			iFailed++;
+		}
+		else {
+			printf("  OK\n");
+		}
+	}
+	printf("\n%d passed, %d failed\n",iNumFiles-iFailed,iFailed);
+
+	free(atRecord);
+	FreeCompatMatrix(ptMatrix);
+	return iFailed ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,198 @@
+/*
+ * netXFileCheckerComply.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  golden image compliance check for a batch of flash dumps
+ *  device specific areas (FDL, remanent, management, update area) are masked,
+ *  all other areas of the layout must match the golden image byte by byte
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+
+
+/* areas holding per device data, never compared */
+static const char* s_aszVolatileAreas[]={
+		".fdl",
+		".rdt",
+		".mng",
+		".upd",
+};
+
+typedef struct COMPLY_RESULT_Ttag {
+	int iResult;
+	uint32_t ulMismatchOffset;
+	const char* szArea;
+} COMPLY_RESULT_T;
+
+typedef struct COMPLY_CONTEXT_Ttag {
+	int iUseCase;
+	char** aszFiles;
+	const uint8_t* pabGolden;
+	size_t ulGoldenSize;
+	uint8_t** apabBuffer; /* one region buffer per worker */
+	COMPLY_RESULT_T* atResult;
+} COMPLY_CONTEXT_T;
+
+#define COMPLY_PASS        0
+#define COMPLY_FAIL        1
+#define COMPLY_ERROR_OPEN  2
+#define COMPLY_ERROR_SIZE  3
+
+
+
+bool IsVolatileArea(const char* szSuffix){
+	int i=0;
+
+	for(i=0;i<sizeof(s_aszVolatileAreas)/sizeof(s_aszVolatileAreas[0]);i++){
+		if(0==strcmp(szSuffix,s_aszVolatileAreas[i]))
+			return true;
+	}
+	return false;
+}
+
+
+
+/* compares the unmasked areas in layout order, stops at the first mismatch */
+static void ComplyJob(int iJob, int iWorker, void* pvContext){
+	COMPLY_CONTEXT_T* ptCtx=(COMPLY_CONTEXT_T*)pvContext;
+	COMPLY_RESULT_T* ptResult=&ptCtx->atResult[iJob];
+	uint8_t* pabBuffer=ptCtx->apabBuffer[iWorker];
+	FILE* hFile=NULL;
+	int i=0;
+
+	ptResult->iResult=COMPLY_PASS;
+
+	hFile=fopen(ptCtx->aszFiles[iJob],"rb");
+	if(hFile==NULL){
+		ptResult->iResult=COMPLY_ERROR_OPEN;
+		return;
+	}
+
+	for(i=0;i<sizeof(tFlashDumpFile[ptCtx->iUseCase])/sizeof(FILE_T);i++){
+		const FILE_T* ptRegion=&tFlashDumpFile[ptCtx->iUseCase][i];
+		uint32_t ulPos=0;
+
+		if(ptRegion->ulLength==0 || IsVolatileArea(ptRegion->szSuffix))
+			continue;
+
+		if(fseek(hFile,ptRegion->ulOffset,SEEK_SET) || fread(pabBuffer,sizeof(uint8_t),ptRegion->ulLength,hFile)!=ptRegion->ulLength){
+			ptResult->iResult=COMPLY_ERROR_SIZE;
+			ptResult->szArea=ptRegion->szSuffix;
+			break;
+		}
+
+		ulPos=BlockFirstMismatch(&ptCtx->pabGolden[ptRegion->ulOffset],pabBuffer,ptRegion->ulLength);
+		if(ulPos<ptRegion->ulLength){
+			ptResult->iResult=COMPLY_FAIL;
+			ptResult->ulMismatchOffset=ptRegion->ulOffset+ulPos;
+			ptResult->szArea=ptRegion->szSuffix;
+			break;
+		}
+	}
+
+	fclose(hFile);
+}
+
+
+
+int CheckCompliance(char* szGoldenFilename, char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads){
+	int i=0;
+	int iPassed=0;
+	int iFailed=0;
+	uint32_t ulMaxLength=0;
+	COMPLY_CONTEXT_T tCtx;
+
+	memset(&tCtx,0,sizeof(tCtx));
+	tCtx.iUseCase=iUseCase;
+	tCtx.aszFiles=aszFiles;
+
+	tCtx.pabGolden=LoadFile(szGoldenFilename,&tCtx.ulGoldenSize);
+	if(tCtx.pabGolden==NULL){
+		return EXIT_FAILURE;
+	}
+
+	for(i=0;i<sizeof(tFlashDumpFile[iUseCase])/sizeof(FILE_T);i++){
+		const FILE_T* ptRegion=&tFlashDumpFile[iUseCase][i];
+		if(ptRegion->ulLength==0 || IsVolatileArea(ptRegion->szSuffix))
+			continue;
+		if(ptRegion->ulOffset+ptRegion->ulLength>tCtx.ulGoldenSize){
+			printf("Error: golden image %s too small for area %s\n",szGoldenFilename,ptRegion->szSuffix);
+			free((void*)tCtx.pabGolden);
+			return EXIT_FAILURE;
+		}
+		ulMaxLength=HIL_MAX(ulMaxLength,ptRegion->ulLength);
+	}
+
+	if(iNumThreads<1)
+		iNumThreads=BatchGetNumCpus();
+	iNumThreads=HIL_MIN(iNumThreads,iNumFiles);
+
+	tCtx.atResult=MemCalloc(iNumFiles,sizeof(COMPLY_RESULT_T));
+	tCtx.apabBuffer=MemCalloc(iNumThreads,sizeof(uint8_t*));
+	if(tCtx.atResult==NULL || tCtx.apabBuffer==NULL){
+		printf("error malloc\n");
+		iNumThreads=0;
+		iFailed=1;
+	}
+	for(i=0;i<iNumThreads;i++){
+		tCtx.apabBuffer[i]=MemAlloc(ulMaxLength);
+		if(tCtx.apabBuffer[i]==NULL){
+			printf("error malloc\n");
+			iFailed=1;
+		}
+	}
+
+	if(iFailed==0){
+		printf("\n--------------------------------------\nGOLDEN IMAGE COMPLIANCE\n");
+		printf("golden image:   %s\n",szGoldenFilename);
+		printf("files:          %d\n",iNumFiles);
+		printf("masked areas:  ");
+		for(i=0;i<sizeof(s_aszVolatileAreas)/sizeof(s_aszVolatileAreas[0]);i++){
+			printf(" %s",s_aszVolatileAreas[i]);
+		}
+		printf("\n--------------------------------------\n");
+
+		BatchRun(iNumFiles,iNumThreads,ComplyJob,&tCtx);
+
+		for(i=0;i<iNumFiles;i++){
+			COMPLY_RESULT_T* ptResult=&tCtx.atResult[i];
+			switch(ptResult->iResult){
+			case COMPLY_PASS:
+				printf("PASS  %s\n",aszFiles[i]);
+				iPassed++;
+				break;
+			case COMPLY_FAIL:
+				printf("FAIL  %s  first mismatch 0x%05x [%s]\n",aszFiles[i],ptResult->ulMismatchOffset,ptResult->szArea);
+				iFailed++;
+				break;
+			case COMPLY_ERROR_OPEN:
+				printf("FAIL  %s  error opening file\n",aszFiles[i]);
+				iFailed++;
+				break;
+			default:
+				printf("FAIL  %s  file too small for area %s\n",aszFiles[i],ptResult->szArea);
+				iFailed++;
+				break;
+			}
+		}
+		printf("\n%d passed, %d failed\n",iPassed,iFailed);
+	}
+
+	if(tCtx.apabBuffer){
+		for(i=0;i<iNumThreads;i++){
+			free(tCtx.apabBuffer[i]);
+		}
+	}
+	free(tCtx.apabBuffer);
+	free(tCtx.atResult);
+	free((void*)tCtx.pabGolden);
+
+	return iFailed ? EXIT_FAILURE : 0;
+}
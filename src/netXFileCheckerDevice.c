@@ -0,0 +1,410 @@
+/*
+ * netXFileCheckerDevice.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  device image of a netX 90: the flash chips of the FDL chip table
+ *  chip 0 INTFLASH0, chip 1 INTFLASH1, chip 2 serial flash at the SQI interface.
+ *  The chips are given as one file each, or as one container holding the chips in this
+ *  order, the chip sizes are taken from the FDL chip table (default 512KB per internal flash,
+ *  the rest of the container is the SQI flash).
+ *  Every area of the FDL flash layout is resolved onto its chip, area start addresses are
+ *  taken as address in the memory map (INTFLASH0 0x00100000, INTFLASH1 0x00180000,
+ *  SQI 0x64000000) or as offset in the chip. Without a valid FDL the areas of the use case
+ *  (tFlashDumpFile, tSQIDumpFile) are used, an FDL without SQI areas is completed by tSQIDumpFile.
+ *  All areas are analyzed in one pass, scheduled in chip and offset order.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+#include "Hil_DeviceProductionData.h"
+
+
+#define DEVICE_NUM_CHIPS         3
+#define DEVICE_MAX_AREAS         16
+#define DEVICE_INTFLASH_SIZE     0x00080000
+#define DEVICE_FDL_OFFSET        0x00002000 // in INTFLASH0
+
+#define DEVICE_AREA_OK           0
+#define DEVICE_AREA_NO_CHIP      1 // chip not part of the device image
+#define DEVICE_AREA_OUTSIDE      2 // area exceeds the chip
+#define DEVICE_AREA_OVERLAP      3 // area overlaps the area before
+
+static const char* s_aszDeviceAreaState[]={
+	"OK",
+	"ERROR chip not available",
+	"ERROR outside the chip",
+	"ERROR overlaps the area before",
+};
+
+static const uint32_t s_aulChipBase[DEVICE_NUM_CHIPS]={
+	0x00100000,
+	0x00180000,
+	0x64000000,
+};
+
+static const char* s_aszChipName[DEVICE_NUM_CHIPS]={
+	"INTFLASH0",
+	"INTFLASH1",
+	"SQI",
+};
+
+typedef struct DEVICE_CHIP_Ttag {
+	char* szFilename;
+	FILE* hFile;
+	uint32_t ulFileOffset;       // of the chip in the file
+	uint32_t ulSize;
+} DEVICE_CHIP_T;
+
+typedef struct DEVICE_AREA_Ttag {
+	char szName[17];
+	uint32_t ulContentType;
+	uint32_t ulChip;
+	uint32_t ulAreaStart;        // as given by the layout
+	uint32_t ulOffset;           // in the chip
+	uint32_t ulSize;
+	int iState;
+} DEVICE_AREA_T;
+
+typedef struct DEVICE_IMAGE_Ttag {
+	DEVICE_CHIP_T atChip[DEVICE_NUM_CHIPS];
+	DEVICE_AREA_T atArea[DEVICE_MAX_AREAS];
+	int iNumAreas;
+	bool bFdlValid;
+	int iNumThreads;
+} DEVICE_IMAGE_T;
+
+typedef int (*DEVICE_ANALYZER_FN)(DEVICE_IMAGE_T* ptDevice, const DEVICE_AREA_T* ptArea);
+
+typedef struct DEVICE_CONTENT_Ttag {
+	uint32_t ulContentType;
+	const char* szType;
+	const char* szSuffix;        // area of the use case layouts
+	DEVICE_ANALYZER_FN fnAnalyze;
+} DEVICE_CONTENT_T;
+
+
+
+static uint32_t DeviceFileOffset(const DEVICE_IMAGE_T* ptDevice, const DEVICE_AREA_T* ptArea){
+	return ptDevice->atChip[ptArea->ulChip].ulFileOffset+ptArea->ulOffset;
+}
+
+static FILE* DeviceFile(const DEVICE_IMAGE_T* ptDevice, const DEVICE_AREA_T* ptArea){
+	return ptDevice->atChip[ptArea->ulChip].hFile;
+}
+
+
+
+static int DeviceAnalyzeHwc(DEVICE_IMAGE_T* ptDevice, const DEVICE_AREA_T* ptArea){
+	return AnalyzeHwcFile(DeviceFileOffset(ptDevice,ptArea),DeviceFile(ptDevice,ptArea),ptArea->ulSize);
+}
+
+static int DeviceAnalyzeFdl(DEVICE_IMAGE_T* ptDevice, const DEVICE_AREA_T* ptArea){
+	return AnalyzeFDL(DeviceFileOffset(ptDevice,ptArea),DeviceFile(ptDevice,ptArea));
+}
+
+static int DeviceAnalyzeNxf(DEVICE_IMAGE_T* ptDevice, const DEVICE_AREA_T* ptArea){
+	return AnalyzeNxfFileHeader(DeviceFileOffset(ptDevice,ptArea),DeviceFile(ptDevice,ptArea));
+}
+
+static int DeviceAnalyzeNai(DEVICE_IMAGE_T* ptDevice, const DEVICE_AREA_T* ptArea){
+	return AnalyzeNaiFileHeader(DeviceFileOffset(ptDevice,ptArea),DeviceFile(ptDevice,ptArea));
+}
+
+static int DeviceAnalyzeNae(DEVICE_IMAGE_T* ptDevice, const DEVICE_AREA_T* ptArea){
+	return AnalyzeNaeFileHeader(DeviceFileOffset(ptDevice,ptArea),DeviceFile(ptDevice,ptArea));
+}
+
+static int DeviceAnalyzeFat(DEVICE_IMAGE_T* ptDevice, const DEVICE_AREA_T* ptArea){
+	const DEVICE_CHIP_T* ptChip=&ptDevice->atChip[ptArea->ulChip];
+	return AnalyzeFatArea(ptChip->szFilename,ptChip->hFile,DeviceFileOffset(ptDevice,ptArea),ptArea->ulSize,ptDevice->iNumThreads);
+}
+
+
+
+/* analyzers per content type, remanent data and management area are not analyzed (libstorage layout not in the Hil headers) */
+static const DEVICE_CONTENT_T s_atDeviceContent[]={
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_HWCONFIG,     "HWCONFIG",     ".hwc", DeviceAnalyzeHwc},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_FDL,          "FDL",          ".fdl", DeviceAnalyzeFdl},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_FW,           "FW",           ".nxi", DeviceAnalyzeNxf},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_FW_CONT,      "FW_CONT",      ".nxe", DeviceAnalyzeNxf},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_CONFIG,       "CONFIG",       NULL,   NULL},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_REMANENT,     "REMANENT",     ".rdt", NULL},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_MANAGEMENT,   "MANAGEMENT",   ".mng", NULL},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_APP_CONT,     "APP_CONT",     ".nae", DeviceAnalyzeNae},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_MFW,          "MFW",          ".mxf", DeviceAnalyzeNxf},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_FILESYSTEM,   "FILESYSTEM",   ".fat", DeviceAnalyzeFat},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_FWUPDATE,     "FWUPDATE",     ".upd", DeviceAnalyzeNxf},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_MFW_HWCONFIG, "MFW_HWCONFIG", ".mwc", DeviceAnalyzeHwc},
+	{HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_APP,          "APP",          ".nai", DeviceAnalyzeNai},
+};
+
+static const DEVICE_CONTENT_T* DeviceContent(uint32_t ulContentType){
+	int i=0;
+
+	for(i=0;i<sizeof(s_atDeviceContent)/sizeof(DEVICE_CONTENT_T);i++){
+		if(s_atDeviceContent[i].ulContentType==ulContentType)
+			return &s_atDeviceContent[i];
+	}
+	return NULL;
+}
+
+static const DEVICE_CONTENT_T* DeviceContentBySuffix(const char* szSuffix){
+	int i=0;
+
+	for(i=0;i<sizeof(s_atDeviceContent)/sizeof(DEVICE_CONTENT_T);i++){
+		if(s_atDeviceContent[i].szSuffix!=NULL && 0==strcmp(s_atDeviceContent[i].szSuffix,szSuffix))
+			return &s_atDeviceContent[i];
+	}
+	return NULL;
+}
+
+
+
+static bool DeviceOpenChip(DEVICE_CHIP_T* ptChip, char* szFilename, uint32_t ulFileOffset, uint32_t ulSize){
+	ptChip->hFile=fopen(szFilename,"rb");
+	if(ptChip->hFile==NULL){
+		printf("\nError opening file %s\n",szFilename);
+		return false;
+	}
+	ptChip->szFilename=szFilename;
+	ptChip->ulFileOffset=ulFileOffset;
+	ptChip->ulSize=ulSize;
+	return true;
+}
+
+static uint32_t DeviceFileSize(char* szFilename){
+	FILE* hFile=fopen(szFilename,"rb");
+	long lSize=0;
+
+	if(hFile==NULL)
+		return 0;
+	fseek(hFile,0,SEEK_END);
+	lSize=ftell(hFile);
+	fclose(hFile);
+	return lSize>0 ? (uint32_t)lSize : 0;
+}
+
+
+
+/* chips of the container or the single chip files, the FDL is read from INTFLASH0 */
+static bool DeviceOpen(DEVICE_IMAGE_T* ptDevice, char** aszChipFiles, HIL_PRODUCT_DATA_LABEL_T* ptFDL){
+	uint32_t aulChipSize[DEVICE_NUM_CHIPS]={DEVICE_INTFLASH_SIZE,DEVICE_INTFLASH_SIZE,0};
+	uint32_t ulContainerSize=DeviceFileSize(aszChipFiles[0]);
+	uint32_t ulOffset=0;
+	FILE* hFile=NULL;
+	int i=0;
+
+	hFile=fopen(aszChipFiles[0],"rb");
+	if(hFile==NULL){
+		printf("\nError opening file %s\n",aszChipFiles[0]);
+		return false;
+	}
+	memset(ptFDL,0,sizeof(HIL_PRODUCT_DATA_LABEL_T));
+	if(fseek(hFile,DEVICE_FDL_OFFSET,SEEK_SET)==0 && fread(ptFDL,sizeof(HIL_PRODUCT_DATA_LABEL_T),1,hFile)==1
+			&& 0==memcmp(ptFDL->tHeader.abStartToken,HIL_PRODUCT_DATA_START_TOKEN,sizeof(ptFDL->tHeader.abStartToken))
+			&& 0==memcmp(ptFDL->tFooter.abEndToken,HIL_PRODUCT_DATA_END_TOKEN,sizeof(ptFDL->tFooter.abEndToken))){
+		ptDevice->bFdlValid=true;
+		for(i=0;i<4;i++){
+			const HIL_PRODUCT_DATA_FLASH_LAYOUT_CHIPS_T* ptChip=&ptFDL->tProductData.tFlashLayout.atChip[i];
+			if(ptChip->ulChipNumber<DEVICE_NUM_CHIPS && ptChip->ulFlashSize)
+				aulChipSize[ptChip->ulChipNumber]=ptChip->ulFlashSize;
+		}
+	}
+	fclose(hFile);
+
+	/* the container holds the chips in order, a chip file replaces its part of the container */
+	for(i=0;i<DEVICE_NUM_CHIPS;i++){
+		if(aszChipFiles[i]!=NULL && i>0){
+			if(!DeviceOpenChip(&ptDevice->atChip[i],aszChipFiles[i],0,DeviceFileSize(aszChipFiles[i])))
+				return false;
+			ulOffset+=aulChipSize[i];
+			continue;
+		}
+		if(ulOffset>=ulContainerSize)
+			break;
+		if(aulChipSize[i]==0 || ulOffset+aulChipSize[i]>ulContainerSize)
+			aulChipSize[i]=ulContainerSize-ulOffset;
+		if(!DeviceOpenChip(&ptDevice->atChip[i],aszChipFiles[0],ulOffset,aulChipSize[i]))
+			return false;
+		ulOffset+=aulChipSize[i];
+	}
+	return true;
+}
+
+
+
+static void DeviceAddArea(DEVICE_IMAGE_T* ptDevice, const char* szName, uint32_t ulContentType, uint32_t ulChip, uint32_t ulAreaStart, uint32_t ulSize){
+	DEVICE_AREA_T* ptArea=&ptDevice->atArea[ptDevice->iNumAreas];
+	const DEVICE_CHIP_T* ptChip=0;
+
+	if(ptDevice->iNumAreas==DEVICE_MAX_AREAS)
+		return;
+	ptDevice->iNumAreas++;
+	memset(ptArea,0,sizeof(DEVICE_AREA_T));
+	strncpy(ptArea->szName,szName,sizeof(ptArea->szName)-1);
+	ptArea->ulContentType=ulContentType;
+	ptArea->ulChip=ulChip;
+	ptArea->ulAreaStart=ulAreaStart;
+	ptArea->ulSize=ulSize;
+
+	if(ulChip>=DEVICE_NUM_CHIPS || ptDevice->atChip[ulChip].hFile==NULL){
+		ptArea->iState=DEVICE_AREA_NO_CHIP;
+		return;
+	}
+	ptChip=&ptDevice->atChip[ulChip];
+	if(ulAreaStart>=s_aulChipBase[ulChip] && ulAreaStart-s_aulChipBase[ulChip]<ptChip->ulSize)
+		ptArea->ulOffset=ulAreaStart-s_aulChipBase[ulChip];
+	else
+		ptArea->ulOffset=ulAreaStart;
+	if((uint64_t)ptArea->ulOffset+ptArea->ulSize>ptChip->ulSize)
+		ptArea->iState=DEVICE_AREA_OUTSIDE;
+}
+
+
+
+/* areas of the use case layouts, the internal dump covers INTFLASH0 and INTFLASH1 */
+static void DeviceAddUseCaseAreas(DEVICE_IMAGE_T* ptDevice, int iUseCase, bool bInternal){
+	int i=0;
+
+	for(i=0;bInternal && i<sizeof(tFlashDumpFile[iUseCase])/sizeof(FILE_T);i++){
+		const FILE_T* ptRegion=&tFlashDumpFile[iUseCase][i];
+		const DEVICE_CONTENT_T* ptContent=DeviceContentBySuffix(ptRegion->szSuffix);
+		uint32_t ulChip=ptRegion->ulOffset>=DEVICE_INTFLASH_SIZE ? 1 : 0;
+
+		if(ptContent!=NULL && ptRegion->ulLength)
+			DeviceAddArea(ptDevice,ptRegion->szSuffix,ptContent->ulContentType,ulChip,ptRegion->ulOffset-ulChip*DEVICE_INTFLASH_SIZE,ptRegion->ulLength);
+	}
+	for(i=0;i<sizeof(tSQIDumpFile[iUseCase])/sizeof(FILE_T);i++){
+		const FILE_T* ptRegion=&tSQIDumpFile[iUseCase][i];
+		const DEVICE_CONTENT_T* ptContent=DeviceContentBySuffix(ptRegion->szSuffix);
+
+		if(ptContent!=NULL && ptRegion->ulLength && ptDevice->atChip[2].hFile!=NULL)
+			DeviceAddArea(ptDevice,ptRegion->szSuffix,ptContent->ulContentType,2,ptRegion->ulOffset,ptRegion->ulLength);
+	}
+}
+
+
+
+static bool DeviceHasChipAreas(const DEVICE_IMAGE_T* ptDevice, uint32_t ulChip){
+	int i=0;
+
+	for(i=0;i<ptDevice->iNumAreas;i++){
+		if(ptDevice->atArea[i].ulChip==ulChip)
+			return true;
+	}
+	return false;
+}
+
+
+
+/* chip and offset order */
+static int CompareDeviceArea(const void* pvA, const void* pvB){
+	const DEVICE_AREA_T* ptA=(const DEVICE_AREA_T*)pvA;
+	const DEVICE_AREA_T* ptB=(const DEVICE_AREA_T*)pvB;
+
+	if(ptA->ulChip!=ptB->ulChip)
+		return ptA->ulChip<ptB->ulChip ? -1 : 1;
+	if(ptA->ulOffset!=ptB->ulOffset)
+		return ptA->ulOffset<ptB->ulOffset ? -1 : 1;
+	return 0;
+}
+
+
+
+/* device image of one file per chip or a container, aszChipFiles[0] is INTFLASH0 or the container */
+int AnalyzeDeviceImage(char** aszChipFiles, int iUseCase, int iNumThreads){
+	DEVICE_IMAGE_T* ptDevice=0;
+	HIL_PRODUCT_DATA_LABEL_T tFDL;
+	int iAnalyzed=0;
+	int iErrors=0;
+	int i=0;
+
+	ptDevice=MemCalloc(1,sizeof(DEVICE_IMAGE_T));
+	if(ptDevice==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+	ptDevice->iNumThreads=iNumThreads;
+
+	if(DeviceOpen(ptDevice,aszChipFiles,&tFDL)){
+		if(ptDevice->bFdlValid){
+			for(i=0;i<10;i++){
+				const HIL_PRODUCT_DATA_FLASH_LAYOUT_AREAS_T* ptArea=&tFDL.tProductData.tFlashLayout.atArea[i];
+				char szName[17];
+
+				if(ptArea->ulContentType==HIL_PRODUCT_DATA_FLASH_LAYOUT_CONTENT_TYPE_EMPTY || ptArea->ulAreaSize==0)
+					continue;
+				memcpy(szName,ptArea->szName,16);
+				szName[16]='\0';
+				DeviceAddArea(ptDevice,szName,ptArea->ulContentType,ptArea->ulChipNumber,ptArea->ulAreaStart,ptArea->ulAreaSize);
+			}
+		}
+		else {
+			DeviceAddUseCaseAreas(ptDevice,iUseCase,true);
+		}
+		/* an FDL without SQI areas, the SQI flash is analyzed with the use case layout */
+		if(ptDevice->bFdlValid && ptDevice->atChip[2].hFile!=NULL && !DeviceHasChipAreas(ptDevice,2))
+			DeviceAddUseCaseAreas(ptDevice,iUseCase,false);
+
+		/* schedule: chip by chip in ascending offsets, so each file is read front to back */
+		qsort(ptDevice->atArea,ptDevice->iNumAreas,sizeof(DEVICE_AREA_T),CompareDeviceArea);
+		for(i=1;i<ptDevice->iNumAreas;i++){
+			DEVICE_AREA_T* ptArea=&ptDevice->atArea[i];
+			const DEVICE_AREA_T* ptBefore=&ptDevice->atArea[i-1];
+			if(ptArea->iState==DEVICE_AREA_OK && ptArea->ulChip==ptBefore->ulChip && ptArea->ulOffset<ptBefore->ulOffset+ptBefore->ulSize)
+				ptArea->iState=DEVICE_AREA_OVERLAP;
+		}
+
+		printf("\n--------------------------------------\nDEVICE IMAGE\n");
+		printf("flash layout:   %s\n",ptDevice->bFdlValid ? "FDL" : "use case");
+		printf("use case:       %c\n",'A'+iUseCase);
+		for(i=0;i<DEVICE_NUM_CHIPS;i++){
+			const DEVICE_CHIP_T* ptChip=&ptDevice->atChip[i];
+			printf("chip %d %-9s ",i,s_aszChipName[i]);
+			if(ptChip->hFile!=NULL)
+				printf("%s at 0x%06x [%dKB]\n",ptChip->szFilename,ptChip->ulFileOffset,ptChip->ulSize/1024);
+			else
+				printf("-\n");
+		}
+		printf("--------------------------------------\n");
+		printf("%-16s %-12s chip  start       offset    size      state\n","area","type");
+		for(i=0;i<ptDevice->iNumAreas;i++){
+			const DEVICE_AREA_T* ptArea=&ptDevice->atArea[i];
+			const DEVICE_CONTENT_T* ptContent=DeviceContent(ptArea->ulContentType);
+			printf("%-16s %-12s %-4u  0x%08x  0x%06x  0x%06x  %s\n",ptArea->szName,ptContent!=NULL ? ptContent->szType : "?",
+					ptArea->ulChip,ptArea->ulAreaStart,ptArea->ulOffset,ptArea->ulSize,s_aszDeviceAreaState[ptArea->iState]);
+			if(ptArea->iState!=DEVICE_AREA_OK)
+				iErrors++;
+		}
+
+		for(i=0;i<ptDevice->iNumAreas;i++){
+			const DEVICE_AREA_T* ptArea=&ptDevice->atArea[i];
+			const DEVICE_CONTENT_T* ptContent=DeviceContent(ptArea->ulContentType);
+
+			if(ptArea->iState!=DEVICE_AREA_OK || ptContent==NULL || ptContent->fnAnalyze==NULL)
+				continue;
+			printf("\n-------------------------------------- %s (chip %u, 0x%06x) --------------------------------------\n",ptArea->szName,ptArea->ulChip,ptArea->ulOffset);
+			if(ptContent->fnAnalyze(ptDevice,ptArea))
+				iErrors++;
+			FileScratchRelease();
+			iAnalyzed++;
+		}
+		printf("\n%d areas, %d analyzed, %d errors\n",ptDevice->iNumAreas,iAnalyzed,iErrors);
+	}
+	else {
+		iErrors++;
+	}
+
+	for(i=0;i<DEVICE_NUM_CHIPS;i++){
+		if(ptDevice->atChip[i].hFile!=NULL)
+			fclose(ptDevice->atChip[i].hFile);
+	}
+	free(ptDevice);
+	return iErrors ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * netXFileCheckerDiff.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  sector level diff of two flash dumps, e.g. a field return against a golden image
+ *  the compare granularity is the erase block size taken from the FDL chip table,
+ *  the compare tells on the way which equal sectors are erased in both dumps
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+#include "Hil_DeviceProductionData.h"
+
+
+
+/* erase block size of the dump, smallest block size of all chips listed in the FDL */
+uint32_t GetDumpBlockSize(const uint8_t* pabDump, size_t ulDumpSize, int iUseCase){
+	int i=0;
+	uint32_t ulBlockSize=0;
+	uint32_t ulFdlOffset=getOffset(iUseCase,".fdl");
+	const HIL_PRODUCT_DATA_LABEL_T* ptFDL=0;
+
+	if(ulDumpSize<ulFdlOffset+sizeof(HIL_PRODUCT_DATA_LABEL_T)){
+		return FLASH_DUMP_DEFAULT_BLOCK_SIZE;
+	}
+	ptFDL=(const HIL_PRODUCT_DATA_LABEL_T*)&pabDump[ulFdlOffset];
+	if(memcmp(ptFDL->tHeader.abStartToken,HIL_PRODUCT_DATA_START_TOKEN,sizeof(ptFDL->tHeader.abStartToken))){
+		return FLASH_DUMP_DEFAULT_BLOCK_SIZE;
+	}
+
+	for(i=0;i<4;i++){
+		uint32_t ulChipBlockSize=ptFDL->tProductData.tFlashLayout.atChip[i].ulBlockSize;
+		if(ptFDL->tProductData.tFlashLayout.atChip[i].ulFlashSize==0)
+			break;
+		/* only power of two block sizes are plausible */
+		if(ulChipBlockSize==0 || (ulChipBlockSize&(ulChipBlockSize-1)))
+			continue;
+		if(ulBlockSize==0 || ulChipBlockSize<ulBlockSize)
+			ulBlockSize=ulChipBlockSize;
+	}
+
+	return ulBlockSize ? ulBlockSize : FLASH_DUMP_DEFAULT_BLOCK_SIZE;
+}
+
+
+
+/* compares one region sector by sector, abChanged receives one flag per sector,
+ * pulErased counts the sectors erased in both dumps */
+static uint32_t DiffRegion(const FILE_T* ptRegion, const uint8_t* pabRef, size_t ulRefSize, const uint8_t* pabCmp, size_t ulCmpSize, uint32_t ulBlockSize,
+		uint8_t* abChanged, uint32_t* pulErased){
+	uint32_t ulSector=0;
+	uint32_t ulNumSectors=(ptRegion->ulLength+ulBlockSize-1)/ulBlockSize;
+	uint32_t ulChanged=0;
+
+	for(ulSector=0;ulSector<ulNumSectors;ulSector++){
+		uint32_t ulOffset=ptRegion->ulOffset+ulSector*ulBlockSize;
+		uint32_t ulSize=HIL_MIN(ulBlockSize,ptRegion->ulOffset+ptRegion->ulLength-ulOffset);
+		bool bEqual;
+		bool bErased=false;
+
+		if(ulOffset+ulSize>ulRefSize || ulOffset+ulSize>ulCmpSize){
+			/* sector not contained in both dumps, the part both have is compared, a different cut is a change */
+			size_t ulRefPart=ulRefSize>ulOffset ? HIL_MIN(ulSize,ulRefSize-ulOffset) : 0;
+			size_t ulCmpPart=ulCmpSize>ulOffset ? HIL_MIN(ulSize,ulCmpSize-ulOffset) : 0;
+			bEqual=ulRefPart==ulCmpPart && (ulRefPart==0 || BlockEqual(&pabRef[ulOffset],&pabCmp[ulOffset],(uint32_t)ulRefPart));
+		}
+		else {
+			bEqual=BlockEqualErased(&pabRef[ulOffset],&pabCmp[ulOffset],ulSize,&bErased);
+			if(bErased)
+				(*pulErased)++;
+		}
+		abChanged[ulSector]=!bEqual;
+		if(!bEqual)
+			ulChanged++;
+	}
+
+	return ulChanged;
+}
+
+
+
+/* prints the changed sectors of a region as coalesced address ranges */
+void PrintChangedRanges(const FILE_T* ptRegion, uint32_t ulBlockSize, const uint8_t* abChanged){
+	uint32_t ulNumSectors=(ptRegion->ulLength+ulBlockSize-1)/ulBlockSize;
+	uint32_t ulSector=0;
+	uint32_t ulFirst=0;
+
+	while(ulSector<ulNumSectors){
+		if(!abChanged[ulSector]){
+			ulSector++;
+			continue;
+		}
+		ulFirst=ulSector;
+		while(ulSector<ulNumSectors && abChanged[ulSector])
+			ulSector++;
+		printf("        0x%05x-0x%05x  %d sector%s\n",ptRegion->ulOffset+ulFirst*ulBlockSize
+				,HIL_MIN(ptRegion->ulOffset+ulSector*ulBlockSize,ptRegion->ulOffset+ptRegion->ulLength)-1
+				,ulSector-ulFirst,(ulSector-ulFirst)==1?"":"s");
+	}
+}
+
+
+
+int DiffFlashDumps(char* szRefFilename, char* szFilename, int iUseCase){
+	int i=0;
+	uint8_t* pabRef=0;
+	uint8_t* pabCmp=0;
+	size_t ulRefSize=0;
+	size_t ulCmpSize=0;
+	uint32_t ulBlockSize=0;
+	uint32_t ulChangedTotal=0;
+	uint32_t ulErasedTotal=0;
+	uint8_t* abChanged=0;
+
+	pabRef=LoadFile(szRefFilename,&ulRefSize);
+	if(pabRef==NULL){
+		return EXIT_FAILURE;
+	}
+	pabCmp=LoadFile(szFilename,&ulCmpSize);
+	if(pabCmp==NULL){
+		free(pabRef);
+		return EXIT_FAILURE;
+	}
+
+	ulBlockSize=GetDumpBlockSize(pabRef,ulRefSize,iUseCase);
+
+	printf("\n--------------------------------------\nFLASH DUMP DIFF\n");
+	printf("reference:      %s [%dKB]\n",szRefFilename,(int)(ulRefSize/1024));
+	printf("compare:        %s [%dKB]\n",szFilename,(int)(ulCmpSize/1024));
+	printf("block size:     0x%05x\n",ulBlockSize);
+	printf("--------------------------------------\n");
+
+	if(ulRefSize!=ulCmpSize){
+		printf("Warning: dump sizes differ\n");
+	}
+
+	for(i=0;i<sizeof(tFlashDumpFile[iUseCase])/sizeof(FILE_T);i++){
+		const FILE_T* ptRegion=&tFlashDumpFile[iUseCase][i];
+		uint32_t ulNumSectors=(ptRegion->ulLength+ulBlockSize-1)/ulBlockSize;
+		uint32_t ulChanged=0;
+
+		if(ptRegion->ulLength==0)
+			continue;
+
+		abChanged=MemAlloc(ulNumSectors);
+		if(abChanged==NULL){
+			printf("error malloc\n");
+			break;
+		}
+
+		printf(" %s 0x%05x 0x%05x [%4dKB]",ptRegion->szSuffix,ptRegion->ulOffset,ptRegion->ulLength,ptRegion->ulLength/1024);
+		ulChanged=DiffRegion(ptRegion,pabRef,ulRefSize,pabCmp,ulCmpSize,ulBlockSize,abChanged,&ulErasedTotal);
+		if(ulChanged){
+			printf(" %d of %d sectors changed\n",ulChanged,ulNumSectors);
+			PrintChangedRanges(ptRegion,ulBlockSize,abChanged);
+		}
+		else {
+			printf(" identical\n");
+		}
+		ulChangedTotal+=ulChanged;
+		free(abChanged);
+	}
+
+	printf("\n%d sectors changed, %d sectors erased in both dumps\n",ulChangedTotal,ulErasedTotal);
+
+	free(pabCmp);
+	free(pabRef);
+	return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * netXFileCheckerFill.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  fill level analysis: erased, partially programmed and used sectors per flash area
+ *  and the highest programmed offset, the sector state map can be reused by later stages
+ *  to skip erased sectors
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+
+
+
+/* scans all sectors of one area, abState receives one SECTOR_xxx entry per sector if not NULL */
+void ScanAreaFill(const uint8_t* pabData, size_t ulDataSize, const FILE_T* ptArea, uint32_t ulBlockSize, AREA_FILL_T* ptFill, uint8_t* abState){
+	uint32_t ulSector=0;
+	uint32_t ulNumSectors=(ptArea->ulLength+ulBlockSize-1)/ulBlockSize;
+
+	memset(ptFill,0,sizeof(AREA_FILL_T));
+
+	for(ulSector=0;ulSector<ulNumSectors;ulSector++){
+		uint32_t ulOffset=ptArea->ulOffset+ulSector*ulBlockSize;
+		uint32_t ulSize=HIL_MIN(ulBlockSize,ptArea->ulOffset+ptArea->ulLength-ulOffset);
+		uint8_t bState=SECTOR_ERASED;
+		uint32_t ulEnd=0;
+
+		if(ulOffset+ulSize>ulDataSize){
+			ptFill->ulMissing++;
+			if(abState)
+				abState[ulSector]=SECTOR_ERASED;
+			continue;
+		}
+
+		ulEnd=BlockWrittenEnd(&pabData[ulOffset],ulSize);
+		if(ulEnd==0){
+			bState=SECTOR_ERASED;
+			ptFill->ulErased++;
+		}
+		else {
+			bState=(ulEnd+FLASH_WORD_SIZE>ulSize) ? SECTOR_USED : SECTOR_PARTIAL;
+			if(bState==SECTOR_USED)
+				ptFill->ulUsed++;
+			else
+				ptFill->ulPartial++;
+			ptFill->ulWrittenEnd=ulOffset+ulEnd;
+		}
+		if(abState)
+			abState[ulSector]=bState;
+	}
+}
+
+
+
+int AnalyzeFillLevel(const uint8_t* pabData, size_t ulDataSize, const FILE_T* atArea, int iNumAreas, uint32_t ulBlockSize){
+	int i=0;
+	AREA_FILL_T tFill;
+	uint32_t ulErasedTotal=0;
+	uint32_t ulSectorsTotal=0;
+
+	printf("\n--------------------------------------\nFILL LEVEL ANALYSIS\n");
+	printf("block size:     0x%05x\n",ulBlockSize);
+	printf("--------------------------------------\n");
+	printf(" area offset  size             used partial erased  highest written\n");
+
+	for(i=0;i<iNumAreas;i++){
+		const FILE_T* ptArea=&atArea[i];
+		uint32_t ulNumSectors=0;
+
+		if(ptArea->ulLength==0)
+			continue;
+
+		ulNumSectors=(ptArea->ulLength+ulBlockSize-1)/ulBlockSize;
+		ScanAreaFill(pabData,ulDataSize,ptArea,ulBlockSize,&tFill,NULL);
+
+		printf(" %s 0x%05x 0x%05x [%4dKB] %4d %7d %6d  ",ptArea->szSuffix,ptArea->ulOffset,ptArea->ulLength,ptArea->ulLength/1024
+				,tFill.ulUsed,tFill.ulPartial,tFill.ulErased);
+		if(tFill.ulWrittenEnd){
+			printf("0x%05x [%3d%%]",tFill.ulWrittenEnd-1,(int)((uint64_t)(tFill.ulWrittenEnd-ptArea->ulOffset)*100/ptArea->ulLength));
+		}
+		else {
+			printf("erased");
+		}
+		if(tFill.ulMissing){
+			printf("  %d sectors beyond end of file",tFill.ulMissing);
+		}
+		printf("\n");
+
+		ulErasedTotal+=tFill.ulErased;
+		ulSectorsTotal+=ulNumSectors;
+	}
+
+	printf("\n%d of %d sectors erased\n",ulErasedTotal,ulSectorsTotal);
+	return 0;
+}
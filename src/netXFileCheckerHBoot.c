@@ -0,0 +1,429 @@
+/*
+ * netXFileCheckerHBoot.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  HBOOT boot header chain of NAI files and verification of the image hashes aulHash
+ *  The chain starts with the header behind the vector table and follows pulNextHeader
+ *  until it is 0. Each header describes one segment: ulImageSizeDword dwords from
+ *  ulFlashOffsetBytes, without the header itself if it lies inside, loaded to
+ *  pulDestination. Offsets and next header addresses are file offsets, addresses in the
+ *  APP side internal flash are mapped to the file.
+ *  aulHash holds the first 224 bits of the SHA-384 of the segment. The segments are
+ *  independent and hashed in groups of SHA512_LANES by the multi buffer SHA-384.
+ *  In batch mode the files are sorted by size, so the lanes run over equally long images.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+
+
+#define HBOOT_MAX_SEGMENTS   64
+#define HBOOT_APP_FLASH_BASE 0x00100000 // netX 90 APP side internal flash
+
+#define HBOOT_HASH_SHA384     0 // aulHash matches the truncated SHA-384
+#define HBOOT_HASH_MISMATCH   1
+#define HBOOT_HASH_TRUNCATED  2 // segment exceeds the file
+#define HBOOT_HASH_CHECKSUM   3 // header checksum wrong
+#define HBOOT_CHAIN_CYCLE     4 // pulNextHeader points back into the chain
+#define HBOOT_CHAIN_OUTSIDE   5 // pulNextHeader outside the file or no HBOOT magic
+#define HBOOT_CHAIN_TOO_LONG  6 // more than HBOOT_MAX_SEGMENTS headers
+#define HBOOT_HASH_NO_HEADER  7 // file too short or not an *.nai
+#define HBOOT_HASH_LOAD_ERROR 8
+
+static const char* s_aszHBootHashState[]={
+	"OK (SHA-384/224)",
+	"MISMATCH",
+	"ERROR segment exceeds the file",
+	"ERROR header checksum",
+	"ERROR header chain cycle",
+	"ERROR next header outside the file",
+	"ERROR header chain too long",
+	"ERROR no HBOOT header",
+	"ERROR file not readable",
+};
+
+typedef struct HBOOT_SEGMENT_Ttag {
+	HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T tHeader;
+	uint32_t ulHeaderOffset;
+	uint32_t ulDataOffset;
+	const uint8_t* pabData;  // into the file, or pabCopy if the header lies inside the segment
+	uint8_t* pabCopy;
+	size_t ulSize;
+	int iState;
+} HBOOT_SEGMENT_T;
+
+typedef struct HBOOT_CHAIN_Ttag {
+	HBOOT_SEGMENT_T atSegment[HBOOT_MAX_SEGMENTS];
+	int iNumSegments;
+	int iEnd;                // HBOOT_HASH_SHA384 if the chain ends with pulNextHeader 0
+} HBOOT_CHAIN_T;
+
+typedef struct HBOOT_BATCH_Ttag {
+	char** aszFiles;
+	int* aiOrder;            // files sorted by size
+	int iNumFiles;
+	int* aiState;            // per file in list order
+} HBOOT_BATCH_T;
+
+
+
+bool HBootIsMagic(uint32_t ulMagic){
+	return ulMagic==HIL_HBOOT_STANDARD_COOKIE || ulMagic==HIL_HBOOT_NO_AUTO_DETECTION_SQI_FLASHES_COOKIE || ulMagic==HIL_HBOOT_ALTERNATIVE_IMAGE_COOKIE;
+}
+
+
+
+/* file offset of an offset or APP flash address, ulFileSize if it is outside the file */
+static uint64_t HBootFileOffset(uint32_t ulAddress, size_t ulFileSize){
+	if(ulAddress<ulFileSize)
+		return ulAddress;
+	if(ulAddress>=HBOOT_APP_FLASH_BASE && ulAddress-HBOOT_APP_FLASH_BASE<ulFileSize)
+		return ulAddress-HBOOT_APP_FLASH_BASE;
+	return ulFileSize;
+}
+
+
+
+static bool HBootHeaderAt(const uint8_t* pabFile, size_t ulFileSize, uint64_t ullOffset){
+	HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T tHeader;
+
+	if(ullOffset+sizeof(tHeader)>ulFileSize)
+		return false;
+	memcpy(&tHeader,pabFile+ullOffset,sizeof(tHeader));
+	return HBootIsMagic(tHeader.ulMagic);
+}
+
+
+
+/* the 16 dwords of the header sum up to 0 */
+static bool HBootChecksumOk(const HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T* ptHeader){
+	uint32_t aulHeader[sizeof(*ptHeader)/sizeof(uint32_t)];
+	uint32_t ulSum=0;
+	int i=0;
+
+	memcpy(aulHeader,ptHeader,sizeof(aulHeader));
+	for(i=0;i<(int)(sizeof(aulHeader)/sizeof(uint32_t));i++){
+		ulSum+=aulHeader[i];
+	}
+	return ulSum==0;
+}
+
+
+
+/* locates the data of the segment, HBOOT_HASH_MISMATCH means still to be hashed */
+static int HBootSegment(const uint8_t* pabFile, size_t ulFileSize, HBOOT_SEGMENT_T* ptSegment){
+	const size_t ulHeaderSize=sizeof(HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T);
+	uint64_t ullStart=HBootFileOffset(ptSegment->tHeader.ulFlashOffsetBytes,ulFileSize);
+	uint64_t ullSize=(uint64_t)ptSegment->tHeader.ulImageSizeDword*4;
+	uint64_t ullHeader=ptSegment->ulHeaderOffset;
+
+	ptSegment->ulDataOffset=(uint32_t)ullStart;
+	ptSegment->ulSize=(size_t)ullSize;
+
+	if(!HBootChecksumOk(&ptSegment->tHeader))
+		return HBOOT_HASH_CHECKSUM;
+
+	if(ullHeader>=ullStart && ullHeader<=ullStart+ullSize){
+		/* the header is not part of the segment data */
+		size_t ulBefore=(size_t)(ullHeader-ullStart);
+
+		if(ullStart+ullSize+ulHeaderSize>ulFileSize)
+			return HBOOT_HASH_TRUNCATED;
+		ptSegment->pabCopy=MemAlloc(ullSize ? (size_t)ullSize : 1);
+		if(ptSegment->pabCopy==NULL)
+			return HBOOT_HASH_LOAD_ERROR;
+		memcpy(ptSegment->pabCopy,pabFile+ullStart,ulBefore);
+		memcpy(ptSegment->pabCopy+ulBefore,pabFile+ullHeader+ulHeaderSize,(size_t)ullSize-ulBefore);
+		ptSegment->pabData=ptSegment->pabCopy;
+	}
+	else {
+		if(ullStart+ullSize>ulFileSize)
+			return HBOOT_HASH_TRUNCATED;
+		ptSegment->pabData=pabFile+ullStart;
+	}
+	return HBOOT_HASH_MISMATCH;
+}
+
+
+
+/* follows pulNextHeader from the header at ulFirstHeader,
+ * stops at a header visited before and after HBOOT_MAX_SEGMENTS headers */
+static void HBootWalkChain(const uint8_t* pabFile, size_t ulFileSize, uint32_t ulFirstHeader, HBOOT_CHAIN_T* ptChain){
+	uint64_t ullHeader=ulFirstHeader;
+	int i=0;
+
+	ptChain->iNumSegments=0;
+	ptChain->iEnd=HBOOT_HASH_SHA384;
+
+	if(!HBootHeaderAt(pabFile,ulFileSize,ullHeader)){
+		ptChain->iEnd=HBOOT_HASH_NO_HEADER;
+		return;
+	}
+
+	for(;;){
+		HBOOT_SEGMENT_T* ptSegment=&ptChain->atSegment[ptChain->iNumSegments++];
+
+		memset(ptSegment,0,sizeof(HBOOT_SEGMENT_T));
+		memcpy(&ptSegment->tHeader,pabFile+ullHeader,sizeof(ptSegment->tHeader));
+		ptSegment->ulHeaderOffset=(uint32_t)ullHeader;
+		ptSegment->iState=HBootSegment(pabFile,ulFileSize,ptSegment);
+
+		if(ptSegment->tHeader.pulNextHeader==0)
+			return;
+
+		ullHeader=HBootFileOffset(ptSegment->tHeader.pulNextHeader,ulFileSize);
+		if(!HBootHeaderAt(pabFile,ulFileSize,ullHeader)){
+			ptChain->iEnd=HBOOT_CHAIN_OUTSIDE;
+			return;
+		}
+		for(i=0;i<ptChain->iNumSegments;i++){
+			if(ptChain->atSegment[i].ulHeaderOffset==ullHeader){
+				ptChain->iEnd=HBOOT_CHAIN_CYCLE;
+				return;
+			}
+		}
+		if(ptChain->iNumSegments==HBOOT_MAX_SEGMENTS){
+			ptChain->iEnd=HBOOT_CHAIN_TOO_LONG;
+			return;
+		}
+	}
+}
+
+
+
+static void HBootFreeChain(HBOOT_CHAIN_T* ptChain){
+	int i=0;
+
+	for(i=0;i<ptChain->iNumSegments;i++){
+		free(ptChain->atSegment[i].pabCopy);
+		ptChain->atSegment[i].pabCopy=NULL;
+	}
+}
+
+
+
+/* state of the chain: the worst of the chain end and the segments */
+static int HBootChainState(const HBOOT_CHAIN_T* ptChain){
+	int iState=ptChain->iEnd;
+	int i=0;
+
+	for(i=0;i<ptChain->iNumSegments;i++){
+		iState=HIL_MAX(iState,ptChain->atSegment[i].iState);
+	}
+	return iState;
+}
+
+
+
+/* hashes up to SHA512_LANES segments with one multi buffer SHA-384 and sets their state */
+static void HBootHashSegments(HBOOT_SEGMENT_T** aptSegment, int iNumSegments){
+	const uint8_t* apabData[SHA512_LANES]={0};
+	size_t aulSize[SHA512_LANES]={0};
+	uint8_t abSha384[SHA512_LANES*SHA384_DIGEST_SIZE];
+	int i=0;
+
+	for(i=0;i<iNumSegments;i++){
+		apabData[i]=aptSegment[i]->pabData;
+		aulSize[i]=aptSegment[i]->ulSize;
+	}
+	Sha384Multi(apabData,aulSize,iNumSegments,abSha384);
+	for(i=0;i<iNumSegments;i++){
+		if(memcmp(&abSha384[i*SHA384_DIGEST_SIZE],aptSegment[i]->tHeader.aulHash,SHA224_DIGEST_SIZE)==0)
+			aptSegment[i]->iState=HBOOT_HASH_SHA384;
+		else
+			aptSegment[i]->iState=HBOOT_HASH_MISMATCH;
+	}
+}
+
+
+
+/* hashes all located segments of the chains in groups of SHA512_LANES */
+static void HBootHashChains(HBOOT_CHAIN_T** aptChain, int iNumChains){
+	HBOOT_SEGMENT_T* aptSegment[SHA512_LANES];
+	int iNumSegments=0;
+	int c=0;
+	int i=0;
+
+	for(c=0;c<iNumChains;c++){
+		if(aptChain[c]==NULL)
+			continue;
+		for(i=0;i<aptChain[c]->iNumSegments;i++){
+			if(aptChain[c]->atSegment[i].iState!=HBOOT_HASH_MISMATCH)
+				continue;
+			aptSegment[iNumSegments++]=&aptChain[c]->atSegment[i];
+			if(iNumSegments==SHA512_LANES){
+				HBootHashSegments(aptSegment,iNumSegments);
+				iNumSegments=0;
+			}
+		}
+	}
+	HBootHashSegments(aptSegment,iNumSegments);
+}
+
+
+
+/* one group of SHA512_LANES segments of a single chain */
+static void HBootSegmentJob(int iJob, int iWorker, void* pvContext){
+	HBOOT_CHAIN_T* ptChain=(HBOOT_CHAIN_T*)pvContext;
+	HBOOT_SEGMENT_T* aptSegment[SHA512_LANES];
+	int iNumSegments=0;
+	int i=0;
+
+	for(i=iJob*SHA512_LANES;i<ptChain->iNumSegments && i<(iJob+1)*SHA512_LANES;i++){
+		if(ptChain->atSegment[i].iState==HBOOT_HASH_MISMATCH)
+			aptSegment[iNumSegments++]=&ptChain->atSegment[i];
+	}
+	HBootHashSegments(aptSegment,iNumSegments);
+}
+
+
+
+/* image size, hash and header chain of the NAI file at offset, ptHeader is the first boot header read from the file */
+int AnalyzeHBootChain(fpos_t offset, FILE* hInFile, const HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T* ptHeader){
+	const uint8_t* abHash=(const uint8_t*)ptHeader->aulHash;
+	HBOOT_CHAIN_T* ptChain=0;
+	const uint8_t* pabFile=0;
+	size_t ulSize=0;
+	int iState=HBOOT_HASH_LOAD_ERROR;
+	int i=0;
+
+	printf("Image Size DW:  %u [%uKB]\n",ptHeader->ulImageSizeDword,ptHeader->ulImageSizeDword/1024*4);
+	printf("Hash:           ");
+	for(i=0;i<SHA224_DIGEST_SIZE;i++){
+		printf("%02x",abHash[i]);
+	}
+	printf("\n");
+
+	/* the chain is walked in the attached file data, read only if the file could not be loaded */
+	pabFile=AttachedFileData(hInFile,offset,&ulSize);
+	if(pabFile==NULL){
+		long lSize=GetFileDataSize(hInFile)-(long)offset;
+		uint8_t* abBuffer=0;
+
+		ulSize=lSize>0 ? (size_t)lSize : 0;
+		abBuffer=FileScratch(ulSize);
+		if(abBuffer!=NULL && ReadFileData(hInFile,offset,abBuffer,ulSize)==ulSize)
+			pabFile=abBuffer;
+	}
+	ptChain=MemAlloc(sizeof(HBOOT_CHAIN_T));
+	if(ptChain==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+	ptChain->iNumSegments=0;
+	ptChain->iEnd=HBOOT_HASH_LOAD_ERROR;
+
+	if(pabFile!=NULL && ulSize>0){
+		HBootWalkChain(pabFile,ulSize,HBOOT_NAI_HEADER_OFFSET,ptChain);
+		BatchRun((ptChain->iNumSegments+SHA512_LANES-1)/SHA512_LANES,BatchGetNumCpus(),HBootSegmentJob,ptChain);
+	}
+	iState=HBootChainState(ptChain);
+
+	printf("\n--------------------------------------\nHBOOT HEADER CHAIN\n");
+	printf("segments:       %d\n",ptChain->iNumSegments);
+	printf("--------------------------------------\n");
+	printf(" #  header    data      size      destination next header hash\n");
+	for(i=0;i<ptChain->iNumSegments;i++){
+		const HBOOT_SEGMENT_T* ptSegment=&ptChain->atSegment[i];
+		printf("%2d  0x%06x  0x%06x  0x%06x  0x%08x  0x%08x  %s\n",i,ptSegment->ulHeaderOffset,ptSegment->ulDataOffset,(uint32_t)ptSegment->ulSize,
+				ptSegment->tHeader.pulDestination,ptSegment->tHeader.pulNextHeader,s_aszHBootHashState[ptSegment->iState]);
+	}
+	if(ptChain->iEnd!=HBOOT_HASH_SHA384)
+		printf("%s\n",s_aszHBootHashState[ptChain->iEnd]);
+	printf("Hash Check:     %s\n",s_aszHBootHashState[iState]);
+
+	HBootFreeChain(ptChain);
+	free(ptChain);
+	return iState==HBOOT_HASH_SHA384 ? 0 : EXIT_FAILURE;
+}
+
+
+
+/* one group of up to SHA512_LANES files of similar size, the segments of all chains share the lanes */
+static void HBootJob(int iJob, int iWorker, void* pvContext){
+	HBOOT_BATCH_T* ptBatch=(HBOOT_BATCH_T*)pvContext;
+	HBOOT_CHAIN_T* aptChain[SHA512_LANES]={0};
+	uint8_t* apabFile[SHA512_LANES]={0};
+	int iFirst=iJob*SHA512_LANES;
+	int iNumFiles=HIL_MIN(SHA512_LANES,ptBatch->iNumFiles-iFirst);
+	int i=0;
+
+	for(i=0;i<iNumFiles;i++){
+		int iFile=ptBatch->aiOrder[iFirst+i];
+		size_t ulFileSize=0;
+
+		ptBatch->aiState[iFile]=HBOOT_HASH_NO_HEADER;
+		if(GetFileType(ptBatch->aszFiles[iFile])!=FILETYPE_NAI)
+			continue;
+
+		ptBatch->aiState[iFile]=HBOOT_HASH_LOAD_ERROR;
+		apabFile[i]=LoadFile(ptBatch->aszFiles[iFile],&ulFileSize);
+		if(apabFile[i]==NULL)
+			continue;
+		aptChain[i]=MemAlloc(sizeof(HBOOT_CHAIN_T));
+		if(aptChain[i]==NULL)
+			continue;
+		HBootWalkChain(apabFile[i],ulFileSize,HBOOT_NAI_HEADER_OFFSET,aptChain[i]);
+	}
+
+	HBootHashChains(aptChain,iNumFiles);
+
+	for(i=0;i<iNumFiles;i++){
+		if(aptChain[i]!=NULL){
+			ptBatch->aiState[ptBatch->aiOrder[iFirst+i]]=HBootChainState(aptChain[i]);
+			HBootFreeChain(aptChain[i]);
+			free(aptChain[i]);
+		}
+		free(apabFile[i]);
+	}
+}
+
+
+
+/* checks the header chain and aulHash of all segments of all *.nai files of the batch */
+int VerifyHBootHashes(char** aszFiles, int iNumFiles, int iNumThreads){
+	HBOOT_BATCH_T tBatch;
+	int aiCount[HBOOT_HASH_LOAD_ERROR+1]={0};
+	int iVerified=0;
+	int i=0;
+
+	tBatch.aszFiles=aszFiles;
+	tBatch.iNumFiles=iNumFiles;
+	tBatch.aiOrder=BatchOrderBySize(aszFiles,iNumFiles);
+	tBatch.aiState=MemCalloc(iNumFiles,sizeof(int));
+	if(tBatch.aiOrder==NULL || tBatch.aiState==NULL){
+		printf("error malloc\n");
+		free(tBatch.aiOrder);
+		free(tBatch.aiState);
+		return EXIT_FAILURE;
+	}
+
+	if(iNumThreads<=0)
+		iNumThreads=BatchGetNumCpus();
+	if(BatchRun((iNumFiles+SHA512_LANES-1)/SHA512_LANES,iNumThreads,HBootJob,&tBatch)){
+		free(tBatch.aiOrder);
+		free(tBatch.aiState);
+		return EXIT_FAILURE;
+	}
+
+	printf("\n--------------------------------------\nHBOOT IMAGE HASH\n");
+	printf("files:          %d\n",iNumFiles);
+	printf("SHA-384:        %s\n",Sha512Engine());
+	printf("--------------------------------------\n");
+	for(i=0;i<iNumFiles;i++){
+		printf("%s  %s\n",aszFiles[i],s_aszHBootHashState[tBatch.aiState[i]]);
+		aiCount[tBatch.aiState[i]]++;
+	}
+	iVerified=aiCount[HBOOT_HASH_SHA384];
+	printf("\n%d verified, %d mismatch, %d errors\n",iVerified,aiCount[HBOOT_HASH_MISMATCH],iNumFiles-iVerified-aiCount[HBOOT_HASH_MISMATCH]);
+
+	free(tBatch.aiOrder);
+	free(tBatch.aiState);
+	return iVerified==iNumFiles ? 0 : EXIT_FAILURE;
+}
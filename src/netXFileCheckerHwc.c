@@ -0,0 +1,400 @@
+/*
+ * netXFileCheckerHwc.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  hardware config (HWC, MWC) analysis
+ *  A hardware config is an HBOOT image: the 64 byte boot header, followed by the image of
+ *  ulImageSizeDword dwords, a sequence of HBOOT chunks. A chunk is a FourCC id, its length
+ *  in dwords and the data. The sequence ends at an id 0, in the erased area or at the end
+ *  of the image.
+ *  The normalized config is the stream of the header fields, without size, hash and checksum,
+ *  and the chunks without the SKIP chunks (padding). Its SHA-256 is the config fingerprint,
+ *  configs with equal fingerprints are the same config whatever the fill and padding.
+ *  -hwc groups the configs of a batch by fingerprint, flash dumps contribute HWC and MWC.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+
+
+#define HWC_MAX_CHUNKS      256
+#define HWC_MAX_LISTED      8    // files listed per group
+#define HWC_AREAS           2    // configs of a flash dump: HWC and MWC
+#define HWC_FOURCC(a,b,c,d) ((uint32_t)(a)|((uint32_t)(b)<<8)|((uint32_t)(c)<<16)|((uint32_t)(d)<<24))
+#define HWC_CHUNK_SKIP      HWC_FOURCC('S','K','I','P')
+
+#define HWC_OK              0
+#define HWC_TRUNCATED       1 // chunk or image exceeds the area
+#define HWC_TOO_MANY_CHUNKS 2
+#define HWC_ERASED          3
+#define HWC_NO_HEADER       4 // area too short or no HBOOT magic
+#define HWC_LOAD_ERROR      5
+
+static const char* s_aszHwcState[]={
+	"OK",
+	"ERROR chunk exceeds the image",
+	"ERROR too many chunks",
+	"erased",
+	"ERROR no HBOOT header",
+	"ERROR file not readable",
+};
+
+typedef struct HWC_CHUNK_Ttag {
+	uint32_t ulId;
+	uint32_t ulOffset;           // of the chunk id
+	uint32_t ulSizeDword;        // data size
+} HWC_CHUNK_T;
+
+typedef struct HWC_CONFIG_Ttag {
+	HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T tHeader;
+	HWC_CHUNK_T atChunk[HWC_MAX_CHUNKS];
+	int iNumChunks;
+	int iState;
+	uint8_t abFingerprint[SHA256_DIGEST_SIZE];
+} HWC_CONFIG_T;
+
+typedef struct HWC_ENTRY_Ttag {
+	int iFile;
+	const char* szArea;          // area of a flash dump, NULL for a single config file
+	int iState;
+	int iNumChunks;
+	uint8_t abFingerprint[SHA256_DIGEST_SIZE];
+} HWC_ENTRY_T;
+
+typedef struct HWC_BATCH_Ttag {
+	char** aszFiles;
+	int iUseCase;
+	HWC_ENTRY_T* atEntry;        // HWC_AREAS per file
+} HWC_BATCH_T;
+
+typedef struct HWC_GROUP_Ttag {
+	int iFirst;                  // first entry of the group in the sorted entries
+	int iCount;
+} HWC_GROUP_T;
+
+
+
+static uint32_t HwcReadDword(const uint8_t* pab){
+	return (uint32_t)pab[0]|((uint32_t)pab[1]<<8)|((uint32_t)pab[2]<<16)|((uint32_t)pab[3]<<24);
+}
+
+
+
+/* parses the header and chunk sequence of the config in pabData and computes its fingerprint */
+static void HwcParse(const uint8_t* pabData, size_t ulSize, HWC_CONFIG_T* ptConfig){
+	const size_t ulHeaderSize=sizeof(HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T);
+	SHA256_CTX_T tCtx;
+	uint32_t aulNormalized[6];
+	uint64_t ullEnd=ulSize;
+	uint64_t ullOffset=ulHeaderSize;
+
+	memset(ptConfig,0,sizeof(HWC_CONFIG_T));
+	ptConfig->iState=HWC_NO_HEADER;
+	if(ulSize<ulHeaderSize)
+		return;
+	if(BlockErased(pabData,(uint32_t)ulHeaderSize)){
+		ptConfig->iState=HWC_ERASED;
+		return;
+	}
+	memcpy(&ptConfig->tHeader,pabData,ulHeaderSize);
+	if(!HBootIsMagic(ptConfig->tHeader.ulMagic))
+		return;
+
+	ptConfig->iState=HWC_OK;
+	if(ptConfig->tHeader.ulImageSizeDword){
+		ullEnd=ulHeaderSize+(uint64_t)ptConfig->tHeader.ulImageSizeDword*4;
+		if(ullEnd>ulSize){
+			ullEnd=ulSize;
+			ptConfig->iState=HWC_TRUNCATED;
+		}
+	}
+
+	Sha256Init(&tCtx);
+	aulNormalized[0]=ptConfig->tHeader.ulMagic;
+	aulNormalized[1]=ptConfig->tHeader.ulFlashOffsetBytes;
+	aulNormalized[2]=ptConfig->tHeader.pulNextHeader;
+	aulNormalized[3]=ptConfig->tHeader.pulDestination;
+	aulNormalized[4]=ptConfig->tHeader.ulFlashSelection;
+	aulNormalized[5]=ptConfig->tHeader.ulSignature;
+	Sha256Update(&tCtx,aulNormalized,sizeof(aulNormalized));
+
+	while(ullOffset+sizeof(uint32_t)<=ullEnd){
+		HWC_CHUNK_T* ptChunk=&ptConfig->atChunk[ptConfig->iNumChunks];
+		uint32_t ulId=HwcReadDword(pabData+ullOffset);
+
+		if(ulId==0 || ulId==0xFFFFFFFF)
+			break;
+		if(ptConfig->iNumChunks==HWC_MAX_CHUNKS){
+			ptConfig->iState=HWC_TOO_MANY_CHUNKS;
+			break;
+		}
+		if(ullOffset+2*sizeof(uint32_t)>ullEnd){
+			ptConfig->iState=HWC_TRUNCATED;
+			break;
+		}
+		ptChunk->ulId=ulId;
+		ptChunk->ulOffset=(uint32_t)ullOffset;
+		ptChunk->ulSizeDword=HwcReadDword(pabData+ullOffset+4);
+		if(ullOffset+8+(uint64_t)ptChunk->ulSizeDword*4>ullEnd){
+			ptConfig->iState=HWC_TRUNCATED;
+			break;
+		}
+		ptConfig->iNumChunks++;
+		if(ulId!=HWC_CHUNK_SKIP){
+			Sha256Update(&tCtx,pabData+ullOffset,8+(size_t)ptChunk->ulSizeDword*4);
+		}
+		ullOffset+=8+(uint64_t)ptChunk->ulSizeDword*4;
+	}
+
+	Sha256Final(&tCtx,ptConfig->abFingerprint);
+}
+
+
+
+static void PrintHwcFourCC(uint32_t ulId){
+	int i=0;
+
+	for(i=0;i<4;i++){
+		uint8_t bChar=(uint8_t)(ulId>>(8*i));
+		if(bChar<0x20 || bChar>0x7e){
+			printf("0x%08x",ulId);
+			return;
+		}
+	}
+	printf("%c%c%c%c      ",(char)ulId,(char)(ulId>>8),(char)(ulId>>16),(char)(ulId>>24));
+}
+
+
+
+static void PrintHwcFingerprint(const uint8_t* abFingerprint, int iNumBytes){
+	int i=0;
+
+	for(i=0;i<iNumBytes;i++){
+		printf("%02x",abFingerprint[i]);
+	}
+}
+
+
+
+/* header, chunk sequence and fingerprint of the hardware config at offset */
+int AnalyzeHwcFile(fpos_t offset, FILE* hInFile, uint32_t ulLength){
+	HWC_CONFIG_T* ptConfig=0;
+	uint8_t* abBuffer=0;
+	size_t ulSize=0;
+	int i=0;
+
+	ptConfig=FileScratch(sizeof(HWC_CONFIG_T));
+	abBuffer=FileScratch(ulLength);
+	if(ptConfig==NULL || abBuffer==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+	ulSize=ReadFileData(hInFile,offset,abBuffer,ulLength);
+	HwcParse(abBuffer,ulSize,ptConfig);
+
+	printf("\n--------------------------------------\nHARDWARE CONFIG ANALYSIS\n");
+	printf("check offset:   0x%05x\n",(int)offset);
+	printf("--------------------------------------\n");
+	if(ptConfig->iState==HWC_OK || ptConfig->iState==HWC_TRUNCATED || ptConfig->iState==HWC_TOO_MANY_CHUNKS){
+		printf("Magic:          0x%08x - ",ptConfig->tHeader.ulMagic);
+		printf("%s\n",LookupCode(ptConfig->tHeader.ulMagic));
+		printf("Destination:    0x%08x\n",ptConfig->tHeader.pulDestination);
+		printf("FlashSelection: 0x%08x\n",ptConfig->tHeader.ulFlashSelection);
+		printf("Image Size DW:  %u\n",ptConfig->tHeader.ulImageSizeDword);
+		printf("Chunks:         %d\n",ptConfig->iNumChunks);
+		printf("   offset   id          size DW\n");
+		for(i=0;i<ptConfig->iNumChunks;i++){
+			printf("   0x%05x  ",ptConfig->atChunk[i].ulOffset);
+			PrintHwcFourCC(ptConfig->atChunk[i].ulId);
+			printf("  %u\n",ptConfig->atChunk[i].ulSizeDword);
+		}
+		printf("Fingerprint:    ");
+		PrintHwcFingerprint(ptConfig->abFingerprint,SHA256_DIGEST_SIZE);
+		printf("\n");
+	}
+	printf("Config Check:   %s\n",s_aszHwcState[ptConfig->iState]);
+
+	return 0;
+}
+
+
+
+static void HwcParseEntry(const uint8_t* pabData, size_t ulDataSize, uint32_t ulOffset, uint32_t ulLength, HWC_CONFIG_T* ptConfig, HWC_ENTRY_T* ptEntry){
+	if(ulOffset>ulDataSize)
+		ulOffset=(uint32_t)ulDataSize;
+	HwcParse(pabData+ulOffset,HIL_MIN(ulLength,ulDataSize-ulOffset),ptConfig);
+	ptEntry->iState=ptConfig->iState;
+	ptEntry->iNumChunks=ptConfig->iNumChunks;
+	memcpy(ptEntry->abFingerprint,ptConfig->abFingerprint,SHA256_DIGEST_SIZE);
+}
+
+
+
+static void HwcJob(int iJob, int iWorker, void* pvContext){
+	HWC_BATCH_T* ptBatch=(HWC_BATCH_T*)pvContext;
+	HWC_ENTRY_T* atEntry=&ptBatch->atEntry[iJob*HWC_AREAS];
+	HWC_CONFIG_T* ptConfig=0;
+	FILE_TYPE_E eType=GetFileType(ptBatch->aszFiles[iJob]);
+	uint8_t* pabData=0;
+	size_t ulDataSize=0;
+
+	(void)iWorker;
+
+	if(eType!=FILETYPE_HWC && eType!=FILETYPE_MWC && eType!=FILETYPE_FLASHDUMP)
+		return;
+
+	atEntry[0].iState=HWC_LOAD_ERROR;
+	pabData=LoadFile(ptBatch->aszFiles[iJob],&ulDataSize);
+	ptConfig=MemAlloc(sizeof(HWC_CONFIG_T));
+	if(pabData!=NULL && ptConfig!=NULL){
+		if(eType==FILETYPE_FLASHDUMP){
+			atEntry[0].szArea=".hwc";
+			atEntry[1].szArea=".mwc";
+			HwcParseEntry(pabData,ulDataSize,getOffset(ptBatch->iUseCase,".hwc"),getLength(ptBatch->iUseCase,".hwc"),ptConfig,&atEntry[0]);
+			HwcParseEntry(pabData,ulDataSize,getOffset(ptBatch->iUseCase,".mwc"),getLength(ptBatch->iUseCase,".mwc"),ptConfig,&atEntry[1]);
+		}
+		else {
+			HwcParseEntry(pabData,ulDataSize,0,(uint32_t)ulDataSize,ptConfig,&atEntry[0]);
+		}
+	}
+	free(ptConfig);
+	free(pabData);
+}
+
+
+
+/* valid configs first, sorted by fingerprint, then list order */
+static int CompareHwcEntry(const void* pvA, const void* pvB){
+	const HWC_ENTRY_T* ptA=(const HWC_ENTRY_T*)pvA;
+	const HWC_ENTRY_T* ptB=(const HWC_ENTRY_T*)pvB;
+	int iRes=0;
+
+	if((ptA->iState==HWC_OK)!=(ptB->iState==HWC_OK))
+		return ptA->iState==HWC_OK ? -1 : 1;
+	if(ptA->iState==HWC_OK){
+		iRes=memcmp(ptA->abFingerprint,ptB->abFingerprint,SHA256_DIGEST_SIZE);
+		if(iRes)
+			return iRes;
+	}
+	if(ptA->iFile!=ptB->iFile)
+		return ptA->iFile-ptB->iFile;
+	return ptA->szArea!=NULL && ptB->szArea!=NULL ? strcmp(ptA->szArea,ptB->szArea) : 0;
+}
+
+/* larger groups first */
+static int CompareHwcGroup(const void* pvA, const void* pvB){
+	const HWC_GROUP_T* ptA=(const HWC_GROUP_T*)pvA;
+	const HWC_GROUP_T* ptB=(const HWC_GROUP_T*)pvB;
+
+	if(ptA->iCount!=ptB->iCount)
+		return ptB->iCount-ptA->iCount;
+	return ptA->iFirst-ptB->iFirst;
+}
+
+
+
+static void PrintHwcEntry(char** aszFiles, const HWC_ENTRY_T* ptEntry){
+	printf("%s",aszFiles[ptEntry->iFile]);
+	if(ptEntry->szArea!=NULL)
+		printf(" [%s]",ptEntry->szArea);
+}
+
+
+
+/* groups the hardware configs of all HWC/MWC files and flash dumps of the batch by fingerprint */
+int GroupHardwareConfigs(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads){
+	HWC_BATCH_T tBatch;
+	HWC_GROUP_T* atGroup=0;
+	HWC_ENTRY_T* atEntry=0;
+	int iNumEntries=0;
+	int iNumValid=0;
+	int iNumGroups=0;
+	int iErased=0;
+	int iErrors=0;
+	int iSkipped=0;
+	int i=0;
+	int j=0;
+
+	atEntry=MemCalloc((size_t)iNumFiles*HWC_AREAS,sizeof(HWC_ENTRY_T));
+	atGroup=MemCalloc((size_t)iNumFiles*HWC_AREAS+1,sizeof(HWC_GROUP_T));
+	if(atEntry==NULL || atGroup==NULL){
+		printf("error malloc\n");
+		free(atEntry);
+		free(atGroup);
+		return EXIT_FAILURE;
+	}
+	for(i=0;i<iNumFiles*HWC_AREAS;i++){
+		atEntry[i].iFile=i/HWC_AREAS;
+		atEntry[i].iState=-1;
+	}
+
+	tBatch.aszFiles=aszFiles;
+	tBatch.iUseCase=iUseCase;
+	tBatch.atEntry=atEntry;
+	if(iNumThreads<=0)
+		iNumThreads=BatchGetNumCpus();
+	if(BatchRun(iNumFiles,iNumThreads,HwcJob,&tBatch)){
+		free(atEntry);
+		free(atGroup);
+		return EXIT_FAILURE;
+	}
+
+	/* drop the unused slots, a file without any config is skipped */
+	for(i=0;i<iNumFiles*HWC_AREAS;i++){
+		if(atEntry[i].iState>=0)
+			atEntry[iNumEntries++]=atEntry[i];
+		else if(i%HWC_AREAS==0)
+			iSkipped++;
+	}
+	qsort(atEntry,iNumEntries,sizeof(HWC_ENTRY_T),CompareHwcEntry);
+	for(i=0;i<iNumEntries && atEntry[i].iState==HWC_OK;i++){
+		if(i==0 || memcmp(atEntry[i].abFingerprint,atEntry[i-1].abFingerprint,SHA256_DIGEST_SIZE)){
+			atGroup[iNumGroups].iFirst=i;
+			iNumGroups++;
+		}
+		atGroup[iNumGroups-1].iCount++;
+	}
+	iNumValid=i;
+	qsort(atGroup,iNumGroups,sizeof(HWC_GROUP_T),CompareHwcGroup);
+
+	printf("\n--------------------------------------\nHARDWARE CONFIG GROUPS\n");
+	printf("files:          %d\n",iNumFiles);
+	printf("configs:        %d\n",iNumEntries);
+	printf("distinct:       %d\n",iNumGroups);
+	printf("--------------------------------------\n");
+	for(i=0;i<iNumGroups;i++){
+		const HWC_ENTRY_T* ptFirst=&atEntry[atGroup[i].iFirst];
+		printf("config ");
+		PrintHwcFingerprint(ptFirst->abFingerprint,8);
+		printf("  %d chunks, used %d times\n",ptFirst->iNumChunks,atGroup[i].iCount);
+		for(j=0;j<atGroup[i].iCount && j<HWC_MAX_LISTED;j++){
+			printf("    ");
+			PrintHwcEntry(aszFiles,&ptFirst[j]);
+			printf("\n");
+		}
+		if(atGroup[i].iCount>HWC_MAX_LISTED)
+			printf("    ... %d more\n",atGroup[i].iCount-HWC_MAX_LISTED);
+	}
+	for(i=iNumValid;i<iNumEntries;i++){
+		PrintHwcEntry(aszFiles,&atEntry[i]);
+		printf("  %s\n",s_aszHwcState[atEntry[i].iState]);
+		if(atEntry[i].iState==HWC_ERASED)
+			iErased++;
+		else
+			iErrors++;
+	}
+	printf("\n%d configs, %d distinct, %d erased, %d errors",iNumValid,iNumGroups,iErased,iErrors);
+	if(iSkipped)
+		printf(", %d files skipped, no HWC/MWC/flash dump",iSkipped);
+	printf("\n");
+
+	free(atEntry);
+	free(atGroup);
+	return iErrors ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,522 @@
+/*
+ * netXFileCheckerIndex.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  fleet index: the records of a batch stored column by column
+ *  the index file is mapped into memory, a query scans only the columns it needs,
+ *  a block of rows at a time, each predicate as a branch free loop over one column
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+
+
+#define INDEX_MAGIC      0x58444E4E // "NNDX"
+#define INDEX_VERSION    0x00010000
+#define INDEX_ALIGN      64
+#define INDEX_SCAN_ROWS  4096       // rows per scan block, the match vector stays in cache
+
+#define NUM_MACS (HIL_PRODUCT_NUMBER_OF_MAC_ADDRESSES_COM+HIL_PRODUCT_NUMBER_OF_MAC_ADDRESSES_APP)
+
+typedef enum INDEX_COLUMN_Etag {
+	COL_FLAGS,     // uint32_t RECORD_FLAG_xxx
+	COL_DEVICE,    // uint32_t FDL device number
+	COL_SERIAL,    // uint32_t FDL serial number
+	COL_HWREV,     // uint8_t  FDL hardware revision
+	COL_HWCOMP,    // uint8_t  FDL hardware compatibility
+	COL_PRODDATE,  // uint16_t FDL production date 0xYYWW
+	COL_MAC,       // uint8_t[6] per MAC, COM MACs followed by APP MACs
+	COL_FWVER,     // uint64_t firmware version, one 16 bit field per version part
+	COL_FWNUM,     // uint32_t firmware number
+	COL_DEVCLASS,  // uint16_t firmware device class
+	COL_CHIPTYPE,  // uint8_t  firmware chip type
+	COL_NAME,      // uint32_t offset of the file name in the name column
+	COL_NAMES,     // file names, zero terminated
+	COL_NUM
+} INDEX_COLUMN_E;
+
+static const uint32_t s_aulColumnElementSize[COL_NUM]={4,4,4,1,1,2,6*NUM_MACS,8,4,2,1,4,1};
+
+typedef struct INDEX_COLUMN_Ttag {
+	uint64_t ullOffset;          // from start of file, INDEX_ALIGN aligned
+	uint64_t ullSize;
+} INDEX_COLUMN_T;
+
+typedef struct INDEX_HEADER_Ttag {
+	uint32_t ulMagic;
+	uint32_t ulVersion;
+	uint32_t ulNumRows;
+	uint32_t ulNumColumns;
+	INDEX_COLUMN_T atColumn[COL_NUM];
+} INDEX_HEADER_T;
+
+
+
+/* firmware of the COM side, or of the APP side for *.nai files */
+static const NETX_FW_RECORD_T* IndexFirmware(const NETX_RECORD_T* ptRecord){
+	if(ptRecord->atFw[RECORD_FW_COM].ulCookie==0xFFFFFFFF)
+		return &ptRecord->atFw[RECORD_FW_NAI];
+	return &ptRecord->atFw[RECORD_FW_COM];
+}
+
+
+
+static int WriteColumn(FILE* hFile, INDEX_COLUMN_T* ptColumn, const void* pvData, uint64_t ullSize){
+	static const uint8_t abPad[INDEX_ALIGN]={0};
+	long lPos=ftell(hFile);
+
+	if(lPos<0)
+		return EXIT_FAILURE;
+	if(lPos%INDEX_ALIGN){
+		size_t ulPad=INDEX_ALIGN-lPos%INDEX_ALIGN;
+		if(fwrite(abPad,1,ulPad,hFile)!=ulPad)
+			return EXIT_FAILURE;
+		lPos+=ulPad;
+	}
+	ptColumn->ullOffset=lPos;
+	ptColumn->ullSize=ullSize;
+	if(ullSize && fwrite(pvData,1,(size_t)ullSize,hFile)!=ullSize)
+		return EXIT_FAILURE;
+	return 0;
+}
+
+
+
+int CreateFleetIndex(char* szIndexFilename, char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads, char* szCacheFilename){
+	NETX_RECORD_T* atRecord=0;
+	uint8_t* apabColumn[COL_NUM]={0};
+	uint64_t aullSize[COL_NUM]={0};
+	INDEX_HEADER_T tHeader;
+	FILE* hFile=NULL;
+	int iRes=0;
+	int i=0;
+	int j=0;
+	uint32_t ulNameOffset=0;
+
+	atRecord=MemCalloc(iNumFiles,sizeof(NETX_RECORD_T));
+	if(atRecord==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+	if(CollectRecords(aszFiles,iNumFiles,iUseCase,iNumThreads,szCacheFilename,atRecord,NULL)){
+		free(atRecord);
+		return EXIT_FAILURE;
+	}
+
+	for(i=0;i<COL_NUM;i++){
+		aullSize[i]=(uint64_t)s_aulColumnElementSize[i]*iNumFiles;
+	}
+	aullSize[COL_NAMES]=0;
+	for(i=0;i<iNumFiles;i++){
+		aullSize[COL_NAMES]+=strlen(aszFiles[i])+1;
+	}
+	for(i=0;i<COL_NUM;i++){
+		apabColumn[i]=MemAlloc((size_t)aullSize[i]+1);
+		if(apabColumn[i]==NULL){
+			printf("error malloc\n");
+			iRes=EXIT_FAILURE;
+		}
+	}
+
+	if(iRes==0){
+		/* transpose the records into columns */
+		for(i=0;i<iNumFiles;i++){
+			const NETX_RECORD_T* ptRecord=&atRecord[i];
+			const NETX_FW_RECORD_T* ptFw=IndexFirmware(ptRecord);
+			uint64_t ullFwVersion=PackFwVersion(ptFw->ausFwVersion);
+			uint8_t* pabMac=&apabColumn[COL_MAC][i*6*NUM_MACS];
+
+			memcpy(&apabColumn[COL_FLAGS][i*4],&ptRecord->ulFlags,4);
+			memcpy(&apabColumn[COL_DEVICE][i*4],&ptRecord->tBasicDeviceData.ulDeviceNumber,4);
+			memcpy(&apabColumn[COL_SERIAL][i*4],&ptRecord->tBasicDeviceData.ulSerialNumber,4);
+			apabColumn[COL_HWREV][i]=ptRecord->tBasicDeviceData.bHwRevision;
+			apabColumn[COL_HWCOMP][i]=ptRecord->tBasicDeviceData.bHwCompatibility;
+			memcpy(&apabColumn[COL_PRODDATE][i*2],&ptRecord->tBasicDeviceData.usProductionDate,2);
+			for(j=0;j<HIL_PRODUCT_NUMBER_OF_MAC_ADDRESSES_COM;j++){
+				memcpy(&pabMac[6*j],ptRecord->tMACAddressesCom.atMAC[j].abMacAddress,6);
+			}
+			for(j=0;j<HIL_PRODUCT_NUMBER_OF_MAC_ADDRESSES_APP;j++){
+				memcpy(&pabMac[6*(HIL_PRODUCT_NUMBER_OF_MAC_ADDRESSES_COM+j)],ptRecord->tMACAddressesApp.atMAC[j].abMacAddress,6);
+			}
+			memcpy(&apabColumn[COL_FWVER][i*8],&ullFwVersion,8);
+			memcpy(&apabColumn[COL_FWNUM][i*4],&ptFw->ulFwNumber,4);
+			memcpy(&apabColumn[COL_DEVCLASS][i*2],&ptFw->usDeviceClass,2);
+			apabColumn[COL_CHIPTYPE][i]=ptFw->bChipType;
+			memcpy(&apabColumn[COL_NAME][i*4],&ulNameOffset,4);
+			memcpy(&apabColumn[COL_NAMES][ulNameOffset],aszFiles[i],strlen(aszFiles[i])+1);
+			ulNameOffset+=(uint32_t)strlen(aszFiles[i])+1;
+		}
+
+		hFile=fopen(szIndexFilename,"wb");
+		if(hFile==NULL){
+			printf("\nError opening file %s\n",szIndexFilename);
+			iRes=EXIT_FAILURE;
+		}
+	}
+
+	if(iRes==0){
+		memset(&tHeader,0,sizeof(tHeader));
+		tHeader.ulMagic=INDEX_MAGIC;
+		tHeader.ulVersion=INDEX_VERSION;
+		tHeader.ulNumRows=iNumFiles;
+		tHeader.ulNumColumns=COL_NUM;
+		if(fwrite(&tHeader,sizeof(tHeader),1,hFile)!=1)
+			iRes=EXIT_FAILURE;
+		for(i=0;i<COL_NUM && iRes==0;i++){
+			iRes=WriteColumn(hFile,&tHeader.atColumn[i],apabColumn[i],aullSize[i]);
+		}
+		/* header again with the column offsets */
+		fseek(hFile,0,SEEK_SET);
+		if(fwrite(&tHeader,sizeof(tHeader),1,hFile)!=1)
+			iRes=EXIT_FAILURE;
+		if(fclose(hFile))
+			iRes=EXIT_FAILURE;
+		if(iRes)
+			printf("error writing file %s\n",szIndexFilename);
+		else
+			printf("fleet index %s: %d files\n",szIndexFilename,iNumFiles);
+	}
+
+	for(i=0;i<COL_NUM;i++){
+		free(apabColumn[i]);
+	}
+	free(atRecord);
+	return iRes;
+}
+
+
+
+/* query terms, all terms must match
+ *   serial=lo[-hi] device=lo[-hi] hw=lo[-hi] hwcomp=lo[-hi] date=lo[-hi] fwnum=lo[-hi] class=lo[-hi] chip=lo[-hi]
+ *   fw=2.3.x       version parts, x matches any value, missing trailing parts match any value
+ *   mac=00:02:a2:12:34:56   matches any COM or APP MAC
+ *   fdl=valid|invalid|crcerror
+ */
+typedef enum QUERY_TYPE_Etag {
+	QUERY_RANGE,
+	QUERY_FW,
+	QUERY_MAC,
+	QUERY_FDL,
+} QUERY_TYPE_E;
+
+typedef struct QUERY_TERM_Ttag {
+	QUERY_TYPE_E eType;
+	INDEX_COLUMN_E eColumn;
+	uint64_t ullLow;
+	uint64_t ullHigh;            // QUERY_FW: mask
+	uint8_t abMac[6];
+} QUERY_TERM_T;
+
+typedef struct QUERY_FIELD_Ttag {
+	const char* szName;
+	INDEX_COLUMN_E eColumn;
+} QUERY_FIELD_T;
+
+static const QUERY_FIELD_T s_atQueryFields[]={
+	{"serial",COL_SERIAL},
+	{"device",COL_DEVICE},
+	{"hw",COL_HWREV},
+	{"hwcomp",COL_HWCOMP},
+	{"date",COL_PRODDATE},
+	{"fwnum",COL_FWNUM},
+	{"class",COL_DEVCLASS},
+	{"chip",COL_CHIPTYPE},
+};
+
+#define QUERY_MAX_TERMS 16
+
+
+
+static int ParseQueryTerm(char* szTerm, QUERY_TERM_T* ptTerm){
+	char* szValue=strchr(szTerm,'=');
+	char* szEnd=0;
+	int i=0;
+
+	if(szValue==NULL)
+		return EXIT_FAILURE;
+	*szValue++=0;
+	memset(ptTerm,0,sizeof(QUERY_TERM_T));
+
+	if(0==strcmp(szTerm,"fw")){
+		ptTerm->eType=QUERY_FW;
+		ptTerm->eColumn=COL_FWVER;
+		return ParseVersionPattern(szValue,&ptTerm->ullLow,&ptTerm->ullHigh);
+	}
+
+	if(0==strcmp(szTerm,"mac")){
+		unsigned int auiMac[6];
+		ptTerm->eType=QUERY_MAC;
+		ptTerm->eColumn=COL_MAC;
+		if(6!=sscanf(szValue,"%x:%x:%x:%x:%x:%x",&auiMac[0],&auiMac[1],&auiMac[2],&auiMac[3],&auiMac[4],&auiMac[5]))
+			return EXIT_FAILURE;
+		for(i=0;i<6;i++){
+			ptTerm->abMac[i]=(uint8_t)auiMac[i];
+		}
+		return 0;
+	}
+
+	if(0==strcmp(szTerm,"fdl")){
+		ptTerm->eType=QUERY_FDL;
+		ptTerm->eColumn=COL_FLAGS;
+		if(0==strcmp(szValue,"valid"))
+			ptTerm->ullLow=RECORD_FLAG_FDL_VALID|RECORD_FLAG_FDL_CRC_OK;
+		else if(0==strcmp(szValue,"crcerror"))
+			ptTerm->ullLow=RECORD_FLAG_FDL_VALID;
+		else if(0==strcmp(szValue,"invalid"))
+			ptTerm->ullLow=0;
+		else
+			return EXIT_FAILURE;
+		return 0;
+	}
+
+	for(i=0;i<sizeof(s_atQueryFields)/sizeof(s_atQueryFields[0]);i++){
+		if(0==strcmp(szTerm,s_atQueryFields[i].szName)){
+			ptTerm->eType=QUERY_RANGE;
+			ptTerm->eColumn=s_atQueryFields[i].eColumn;
+			ptTerm->ullLow=strtoull(szValue,&szEnd,0);
+			if(szEnd==szValue)
+				return EXIT_FAILURE;
+			ptTerm->ullHigh=ptTerm->ullLow;
+			if(*szEnd=='-'){
+				szValue=szEnd+1;
+				ptTerm->ullHigh=strtoull(szValue,&szEnd,0);
+				if(szEnd==szValue)
+					return EXIT_FAILURE;
+			}
+			if(*szEnd || ptTerm->ullHigh<ptTerm->ullLow)
+				return EXIT_FAILURE;
+			return 0;
+		}
+	}
+	return EXIT_FAILURE;
+}
+
+
+
+/* abMatch[i]&=term(row ulFirst+i), the loops have no branches so the compiler can vectorize them */
+static void ScanTerm(const QUERY_TERM_T* ptTerm, const uint8_t* pabColumn, uint32_t ulFirst, uint32_t ulRows, uint8_t* abMatch){
+	uint32_t i=0;
+	uint32_t ulLow=0;
+	uint32_t ulRange=0;
+	uint64_t ullMax=0;
+
+	switch(ptTerm->eType){
+	case QUERY_RANGE:
+		/* lo<=v<=hi as one unsigned compare (v-lo)<=(hi-lo) */
+		ullMax=((uint64_t)1<<(8*s_aulColumnElementSize[ptTerm->eColumn]))-1;
+		if(ptTerm->ullLow>ullMax){
+			memset(abMatch,0,ulRows);
+			return;
+		}
+		ulLow=(uint32_t)ptTerm->ullLow;
+		ulRange=(uint32_t)(HIL_MIN(ptTerm->ullHigh,ullMax)-ptTerm->ullLow);
+		switch(s_aulColumnElementSize[ptTerm->eColumn]){
+		case 4:
+			{
+				const uint32_t* pulValue=(const uint32_t*)pabColumn+ulFirst;
+				for(i=0;i<ulRows;i++){
+					abMatch[i]&=(uint32_t)(pulValue[i]-ulLow)<=ulRange;
+				}
+			}
+			break;
+		case 2:
+			{
+				const uint16_t* pusValue=(const uint16_t*)pabColumn+ulFirst;
+				for(i=0;i<ulRows;i++){
+					abMatch[i]&=(uint32_t)(pusValue[i]-ulLow)<=ulRange;
+				}
+			}
+			break;
+		default:
+			{
+				const uint8_t* pbValue=pabColumn+ulFirst;
+				for(i=0;i<ulRows;i++){
+					abMatch[i]&=(uint32_t)(pbValue[i]-ulLow)<=ulRange;
+				}
+			}
+			break;
+		}
+		break;
+
+	case QUERY_FW:
+		{
+			const uint64_t* pullValue=(const uint64_t*)pabColumn+ulFirst;
+			uint64_t ullValue=ptTerm->ullLow;
+			uint64_t ullMask=ptTerm->ullHigh;
+			for(i=0;i<ulRows;i++){
+				abMatch[i]&=((pullValue[i]^ullValue)&ullMask)==0;
+			}
+		}
+		break;
+
+	case QUERY_FDL:
+		{
+			const uint32_t* pulValue=(const uint32_t*)pabColumn+ulFirst;
+			uint32_t ulValue=(uint32_t)ptTerm->ullLow;
+			for(i=0;i<ulRows;i++){
+				abMatch[i]&=(pulValue[i]&(RECORD_FLAG_FDL_VALID|RECORD_FLAG_FDL_CRC_OK))==ulValue;
+			}
+		}
+		break;
+
+	case QUERY_MAC:
+		{
+			const uint8_t* pabMac=pabColumn+(size_t)ulFirst*6*NUM_MACS;
+			uint64_t ullMac=0;
+			int j=0;
+			memcpy(&ullMac,ptTerm->abMac,6);
+			for(i=0;i<ulRows;i++){
+				uint8_t bAny=0;
+				for(j=0;j<NUM_MACS;j++){
+					uint64_t ullValue=0;
+					memcpy(&ullValue,&pabMac[6*(i*NUM_MACS+j)],6);
+					bAny|=(ullValue==ullMac);
+				}
+				abMatch[i]&=bAny;
+			}
+		}
+		break;
+	}
+}
+
+
+
+/* every name offset lies in the name column and the column ends with a terminator,
+ * so each name is a terminated string inside the index */
+static bool CheckIndexNames(const INDEX_HEADER_T* ptHeader, const uint8_t* pabData){
+	const INDEX_COLUMN_T* ptNames=&ptHeader->atColumn[COL_NAMES];
+	const uint8_t* pabName=&pabData[ptHeader->atColumn[COL_NAME].ullOffset];
+	uint32_t ulName=0;
+	uint32_t ulRow=0;
+
+	if(ptHeader->ulNumRows==0)
+		return true;
+	if(ptNames->ullSize==0 || pabData[ptNames->ullOffset+ptNames->ullSize-1]!=0)
+		return false;
+	for(ulRow=0;ulRow<ptHeader->ulNumRows;ulRow++){
+		memcpy(&ulName,&pabName[4*ulRow],4);
+		if(ulName>=ptNames->ullSize)
+			return false;
+	}
+	return true;
+}
+
+
+
+static void PrintIndexRow(const INDEX_HEADER_T* ptHeader, const uint8_t* pabData, uint32_t ulRow){
+	const uint8_t* apabColumn[COL_NUM];
+	uint64_t ullFwVersion=0;
+	uint32_t ulName=0;
+	uint32_t ulFlags=0;
+	int i=0;
+
+	for(i=0;i<COL_NUM;i++){
+		apabColumn[i]=&pabData[ptHeader->atColumn[i].ullOffset];
+	}
+	memcpy(&ulName,&apabColumn[COL_NAME][4*ulRow],4);
+	memcpy(&ulFlags,&apabColumn[COL_FLAGS][4*ulRow],4);
+	memcpy(&ullFwVersion,&apabColumn[COL_FWVER][8*ulRow],8);
+
+	printf("%s",(const char*)&apabColumn[COL_NAMES][ulName]);
+	if(ulFlags&RECORD_FLAG_FDL_VALID){
+		printf("  FDL %d/%d hw 0x%02x",((const uint32_t*)apabColumn[COL_DEVICE])[ulRow],((const uint32_t*)apabColumn[COL_SERIAL])[ulRow]
+				,apabColumn[COL_HWREV][ulRow]);
+	}
+	if(ullFwVersion!=0xFFFFFFFFFFFFFFFFULL){
+		printf("  FW %d.%d.%d.%d #%d",(int)(ullFwVersion>>48),(int)(ullFwVersion>>32)&0xFFFF,(int)(ullFwVersion>>16)&0xFFFF,(int)ullFwVersion&0xFFFF
+				,((const uint32_t*)apabColumn[COL_FWNUM])[ulRow]);
+	}
+	printf("\n");
+}
+
+
+
+int QueryFleetIndex(char* szIndexFilename, char* szQuery){
+	BATCH_MAP_T tMap;
+	const INDEX_HEADER_T* ptHeader=0;
+	QUERY_TERM_T atTerm[QUERY_MAX_TERMS];
+	int iNumTerms=0;
+	char* szQueryCopy=0;
+	char* szTerm=0;
+	uint8_t abMatch[INDEX_SCAN_ROWS];
+	uint32_t ulFirst=0;
+	uint32_t ulMatches=0;
+	uint32_t i=0;
+	int t=0;
+
+	szQueryCopy=MemAlloc(strlen(szQuery)+1);
+	if(szQueryCopy==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+	strcpy(szQueryCopy,szQuery);
+	for(szTerm=strtok(szQueryCopy," ,");szTerm!=NULL;szTerm=strtok(NULL," ,")){
+		if(iNumTerms==QUERY_MAX_TERMS){
+			printf("Error: too many query terms\n");
+			free(szQueryCopy);
+			return EXIT_FAILURE;
+		}
+		if(ParseQueryTerm(szTerm,&atTerm[iNumTerms])){
+			printf("Error: invalid query term \"%s\"\n",&szQuery[szTerm-szQueryCopy]);
+			free(szQueryCopy);
+			return EXIT_FAILURE;
+		}
+		iNumTerms++;
+	}
+	free(szQueryCopy);
+
+	if(BatchMapFile(szIndexFilename,&tMap)){
+		printf("\nError opening file %s\n",szIndexFilename);
+		return EXIT_FAILURE;
+	}
+	ptHeader=(const INDEX_HEADER_T*)tMap.pabData;
+	if(tMap.ulSize<sizeof(INDEX_HEADER_T) || ptHeader->ulMagic!=INDEX_MAGIC || ptHeader->ulVersion!=INDEX_VERSION || ptHeader->ulNumColumns!=COL_NUM){
+		printf("Error: %s is no fleet index\n",szIndexFilename);
+		BatchUnmapFile(&tMap);
+		return EXIT_FAILURE;
+	}
+	for(t=0;t<COL_NUM;t++){
+		const INDEX_COLUMN_T* ptColumn=&ptHeader->atColumn[t];
+		if(ptColumn->ullOffset%INDEX_ALIGN || ptColumn->ullOffset+ptColumn->ullSize>tMap.ulSize
+				|| (t!=COL_NAMES && ptColumn->ullSize<(uint64_t)s_aulColumnElementSize[t]*ptHeader->ulNumRows)){
+			printf("Error: fleet index %s is corrupt\n",szIndexFilename);
+			BatchUnmapFile(&tMap);
+			return EXIT_FAILURE;
+		}
+	}
+	if(!CheckIndexNames(ptHeader,tMap.pabData)){
+		printf("Error: fleet index %s is corrupt\n",szIndexFilename);
+		BatchUnmapFile(&tMap);
+		return EXIT_FAILURE;
+	}
+
+	printf("\n--------------------------------------\nFLEET INDEX QUERY\n");
+	printf("index:          %s\n",szIndexFilename);
+	printf("files:          %d\n",ptHeader->ulNumRows);
+	printf("query:          %s\n",szQuery);
+	printf("--------------------------------------\n");
+
+	for(ulFirst=0;ulFirst<ptHeader->ulNumRows;ulFirst+=INDEX_SCAN_ROWS){
+		uint32_t ulRows=HIL_MIN(INDEX_SCAN_ROWS,ptHeader->ulNumRows-ulFirst);
+		memset(abMatch,1,ulRows);
+		for(t=0;t<iNumTerms;t++){
+			ScanTerm(&atTerm[t],&tMap.pabData[ptHeader->atColumn[atTerm[t].eColumn].ullOffset],ulFirst,ulRows,abMatch);
+		}
+		for(i=0;i<ulRows;i++){
+			if(abMatch[i]){
+				PrintIndexRow(ptHeader,tMap.pabData,ulFirst+i);
+				ulMatches++;
+			}
+		}
+	}
+
+	printf("\n%d of %d files match\n",ulMatches,ptHeader->ulNumRows);
+	BatchUnmapFile(&tMap);
+	return 0;
+}
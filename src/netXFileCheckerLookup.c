@@ -21,6 +21,11 @@ static struct
 		{STR(HIL_FILE_HEADER_FIRMWARE_MXF_COOKIE),HIL_FILE_HEADER_FIRMWARE_MXF_COOKIE},
 		{STR(HIL_FILE_HEADER_FIRMWARE_NAI_COOKIE),HIL_FILE_HEADER_FIRMWARE_NAI_COOKIE},
 		{STR(HIL_FILE_HEADER_FIRMWARE_NAE_COOKIE),HIL_FILE_HEADER_FIRMWARE_NAE_COOKIE},
+		{STR(HIL_FILE_HEADER_MODULE_COOKIE      ),HIL_FILE_HEADER_MODULE_COOKIE      },
+		{STR(HIL_FILE_HEADER_OPTION_COOKIE      ),HIL_FILE_HEADER_OPTION_COOKIE      },
+		{STR(HIL_FILE_HEADER_DATABASE_COOKIE    ),HIL_FILE_HEADER_DATABASE_COOKIE    },
+		{STR(HIL_FILE_HEADER_LICENSE_COOKIE     ),HIL_FILE_HEADER_LICENSE_COOKIE     },
+		{STR(HIL_FILE_HEADER_BINARY_COOKIE      ),HIL_FILE_HEADER_BINARY_COOKIE      },
 
         {STR(HIL_HBOOT_STANDARD_COOKIE),                      HIL_HBOOT_STANDARD_COOKIE},
 		{STR(HIL_HBOOT_NO_AUTO_DETECTION_SQI_FLASHES_COOKIE), HIL_HBOOT_NO_AUTO_DETECTION_SQI_FLASHES_COOKIE},
@@ -0,0 +1,163 @@
+/*
+ * netXFileCheckerMd5.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  verification of aulMD5 of the common header of firmware files (NXI, NXF, MXF, UPD)
+ *  the MD5 covers the file from the common header to the end, with aulMD5 and
+ *  ulHeaderCRC32 taken as 0. This follows from the checksums of Hil_FileHeaderV3.h, each
+ *  covers the MD5 so it is computed after it: ulAppChecksum of the boot header sums up the
+ *  file from offset 64 (the boot header is not part of the MD5), ulHeaderCRC32 is the CRC32
+ *  of boot header and common header (it is 0 while the MD5 is computed).
+ *  The coverage is derived, not verified against a released firmware file, the header
+ *  comment of aulMD5 speaks of the whole file. The output says so, a mismatch may mean
+ *  that the coverage is wrong.
+ *  The files are sorted by size and hashed in groups of Md5Lanes() files,
+ *  so all lanes of the multi buffer MD5 work on blocks of equally long files.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+#include "Hil_FileHeaderV3.h"
+
+
+#define FW_MD5_OK         0
+#define FW_MD5_MISMATCH   1
+#define FW_MD5_NO_HEADER  2 // file too short or no firmware file
+#define FW_MD5_LOAD_ERROR 3
+
+static const char* s_aszFwMd5State[]={
+	"OK",
+	"MISMATCH",
+	"ERROR no firmware header",
+	"ERROR file not readable",
+};
+
+#define MD5_START  sizeof(HIL_FILE_BOOT_HEADER_V1_0_T)
+
+typedef struct FW_MD5_BATCH_Ttag {
+	char** aszFiles;
+	int* aiOrder;            // files sorted by size
+	int iNumFiles;
+	int iLanes;              // files per job
+	int* aiState;            // per file in list order
+} FW_MD5_BATCH_T;
+
+
+
+static bool IsFirmwareFile(char* szFilename){
+	switch(GetFileType(szFilename)){
+	case FILETYPE_NXF:
+	case FILETYPE_NXI:
+	case FILETYPE_MXF:
+	case FILETYPE_UPD:
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+
+/* one group of up to MD5_MAX_LANES files of similar size */
+static void FwMd5Job(int iJob, int iWorker, void* pvContext){
+	FW_MD5_BATCH_T* ptBatch=(FW_MD5_BATCH_T*)pvContext;
+	uint8_t* apabFile[MD5_MAX_LANES]={0};
+	const uint8_t* apabData[MD5_MAX_LANES]={0};
+	size_t aulSize[MD5_MAX_LANES]={0};
+	uint32_t aaulExpected[MD5_MAX_LANES][4];
+	uint8_t abDigest[MD5_MAX_LANES*MD5_DIGEST_SIZE];
+	int aiFile[MD5_MAX_LANES];
+	int iFirst=iJob*ptBatch->iLanes;
+	int iNumFiles=HIL_MIN(ptBatch->iLanes,ptBatch->iNumFiles-iFirst);
+	int iNumLanes=0;
+	int i=0;
+
+	for(i=0;i<iNumFiles;i++){
+		int iFile=ptBatch->aiOrder[iFirst+i];
+		HIL_FILE_COMMON_HEADER_V3_0_T* ptCommonHeader=0;
+		size_t ulFileSize=0;
+
+		ptBatch->aiState[iFile]=FW_MD5_NO_HEADER;
+		if(!IsFirmwareFile(ptBatch->aszFiles[iFile]))
+			continue;
+
+		apabFile[i]=LoadFile(ptBatch->aszFiles[iFile],&ulFileSize);
+		if(apabFile[i]==NULL){
+			ptBatch->aiState[iFile]=FW_MD5_LOAD_ERROR;
+			continue;
+		}
+		if(ulFileSize<MD5_START+sizeof(HIL_FILE_COMMON_HEADER_V3_0_T))
+			continue;
+
+		ptCommonHeader=(HIL_FILE_COMMON_HEADER_V3_0_T*)(apabFile[i]+MD5_START);
+		memcpy(aaulExpected[iNumLanes],ptCommonHeader->aulMD5,sizeof(ptCommonHeader->aulMD5));
+		memset(ptCommonHeader->aulMD5,0,sizeof(ptCommonHeader->aulMD5));
+		ptCommonHeader->ulHeaderCRC32=0;
+
+		apabData[iNumLanes]=apabFile[i]+MD5_START;
+		aulSize[iNumLanes]=ulFileSize-MD5_START;
+		aiFile[iNumLanes++]=iFile;
+	}
+
+	Md5Multi(apabData,aulSize,iNumLanes,abDigest);
+	for(i=0;i<iNumLanes;i++){
+		ptBatch->aiState[aiFile[i]]=memcmp(&abDigest[i*MD5_DIGEST_SIZE],aaulExpected[i],MD5_DIGEST_SIZE) ? FW_MD5_MISMATCH : FW_MD5_OK;
+	}
+
+	for(i=0;i<iNumFiles;i++){
+		free(apabFile[i]);
+	}
+}
+
+
+
+/* checks aulMD5 of all firmware files of the batch */
+int VerifyFirmwareMd5(char** aszFiles, int iNumFiles, int iNumThreads){
+	FW_MD5_BATCH_T tBatch;
+	int aiCount[FW_MD5_LOAD_ERROR+1]={0};
+	int i=0;
+
+	tBatch.aszFiles=aszFiles;
+	tBatch.iNumFiles=iNumFiles;
+	tBatch.iLanes=Md5Lanes();
+	tBatch.aiOrder=BatchOrderBySize(aszFiles,iNumFiles);
+	tBatch.aiState=MemCalloc(iNumFiles,sizeof(int));
+	if(tBatch.aiOrder==NULL || tBatch.aiState==NULL){
+		printf("error malloc\n");
+		free(tBatch.aiOrder);
+		free(tBatch.aiState);
+		return EXIT_FAILURE;
+	}
+
+	if(iNumThreads<=0)
+		iNumThreads=BatchGetNumCpus();
+	if(BatchRun((iNumFiles+tBatch.iLanes-1)/tBatch.iLanes,iNumThreads,FwMd5Job,&tBatch)){
+		free(tBatch.aiOrder);
+		free(tBatch.aiState);
+		return EXIT_FAILURE;
+	}
+
+	printf("\n--------------------------------------\nFIRMWARE MD5\n");
+	printf("files:          %d\n",iNumFiles);
+	printf("MD5:            %s\n",Md5Engine());
+	printf("coverage:       offset 64 to the end, aulMD5 and ulHeaderCRC32 as 0 [UNVERIFIED]\n");
+	printf("--------------------------------------\n");
+	for(i=0;i<iNumFiles;i++){
+		printf("%s  %s\n",aszFiles[i],s_aszFwMd5State[tBatch.aiState[i]]);
+		aiCount[tBatch.aiState[i]]++;
+	}
+	printf("\n%d verified, %d mismatch, %d errors\n",
+			aiCount[FW_MD5_OK],aiCount[FW_MD5_MISMATCH],aiCount[FW_MD5_NO_HEADER]+aiCount[FW_MD5_LOAD_ERROR]);
+	if(aiCount[FW_MD5_MISMATCH])
+		printf("the MD5 coverage is not verified against a released firmware file, a mismatch may be a wrong coverage\n");
+
+	free(tBatch.aiOrder);
+	free(tBatch.aiState);
+	return aiCount[FW_MD5_OK]==iNumFiles ? 0 : EXIT_FAILURE;
+}
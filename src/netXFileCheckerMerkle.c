@@ -0,0 +1,478 @@
+/*
+ * netXFileCheckerMerkle.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  per sector SHA-256 hash manifest with one Merkle tree per flash area
+ *  manifests are stored as sidecar files <file>.mkl, two manifests (or a manifest and a dump)
+ *  are compared top down, only subtrees with different hashes are visited
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+
+
+#define MERKLE_MAGIC    0x544B4D4E // "NMKT"
+#define MERKLE_VERSION  0x00010000
+#define MERKLE_MAX_AREAS 8
+#define MERKLE_MAX_SECTORS 0x100000 // per area, 4GB in 4KB sectors
+
+/* manifest file layout: header, area descriptors, nodes of all areas in area order */
+typedef __HIL_PACKED_PRE struct __HIL_PACKED_POST MERKLE_FILE_HEADER_Ttag {
+	uint32_t ulMagic;
+	uint32_t ulVersion;
+	uint32_t ulBlockSize;
+	uint32_t ulImageSize;
+	uint32_t ulNumAreas;
+} MERKLE_FILE_HEADER_T;
+
+typedef __HIL_PACKED_PRE struct __HIL_PACKED_POST MERKLE_FILE_AREA_Ttag {
+	char szSuffix[8];
+	uint32_t ulOffset;
+	uint32_t ulLength;
+	uint32_t ulNumLeaves;
+} MERKLE_FILE_AREA_T;
+
+typedef uint8_t MERKLE_NODE_T[SHA256_DIGEST_SIZE];
+
+typedef struct MERKLE_AREA_Ttag {
+	FILE_T tArea;
+	uint32_t ulNumSectors;
+	uint32_t ulNumLeaves;   // sectors rounded up to a power of two
+	MERKLE_NODE_T* atNode;  // 2*ulNumLeaves-1 nodes in heap order, node 0 is the root
+} MERKLE_AREA_T;
+
+typedef struct MERKLE_TREE_Ttag {
+	uint32_t ulBlockSize;
+	uint32_t ulImageSize;
+	uint32_t ulNumAreas;
+	MERKLE_AREA_T atArea[MERKLE_MAX_AREAS];
+	uint32_t ulHashed;      // sectors hashed
+	uint32_t ulSkipped;     // erased sectors, hash taken from the erased sector hash
+} MERKLE_TREE_T;
+
+
+
+static bool IsManifestFile(const char* szFilename){
+	size_t ulLen=strlen(szFilename);
+	return ulLen>4 && (0==strcmp(&szFilename[ulLen-4],MERKLE_MANIFEST_SUFFIX) || 0==strcmp(&szFilename[ulLen-4],".MKL"));
+}
+
+static bool IsFlashDumpFile(const char* szFilename){
+	size_t ulLen=strlen(szFilename);
+	return ulLen>4 && (0==strcmp(&szFilename[ulLen-4],".bin") || 0==strcmp(&szFilename[ulLen-4],".BIN"));
+}
+
+
+
+static void MerkleFree(MERKLE_TREE_T* ptTree){
+	uint32_t i=0;
+	for(i=0;i<ptTree->ulNumAreas;i++){
+		free(ptTree->atArea[i].atNode);
+		ptTree->atArea[i].atNode=0;
+	}
+	ptTree->ulNumAreas=0;
+}
+
+
+
+static int MerkleAllocArea(MERKLE_AREA_T* ptArea, uint32_t ulBlockSize){
+	uint64_t ullNumSectors=((uint64_t)ptArea->tArea.ulLength+ulBlockSize-1)/ulBlockSize;
+	uint32_t ulLeaves=0;
+
+	if(ullNumSectors>MERKLE_MAX_SECTORS){
+		printf("Error: area %s has more than %d sectors\n",ptArea->tArea.szSuffix,MERKLE_MAX_SECTORS);
+		return EXIT_FAILURE;
+	}
+	ptArea->ulNumSectors=(uint32_t)ullNumSectors;
+
+	/* sectors rounded up to a power of two */
+	ulLeaves=ptArea->ulNumSectors ? ptArea->ulNumSectors-1 : 0;
+	ulLeaves|=ulLeaves>>1;
+	ulLeaves|=ulLeaves>>2;
+	ulLeaves|=ulLeaves>>4;
+	ulLeaves|=ulLeaves>>8;
+	ulLeaves|=ulLeaves>>16;
+	ptArea->ulNumLeaves=ulLeaves+1;
+
+	ptArea->atNode=MemCalloc(2*ptArea->ulNumLeaves-1,sizeof(MERKLE_NODE_T));
+	if(ptArea->atNode==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+	return 0;
+}
+
+
+
+/* hashes all sectors of the areas, erased sectors reuse one precomputed hash */
+static int MerkleBuild(const uint8_t* pabData, size_t ulDataSize, const FILE_T* atArea, int iNumAreas, uint32_t ulBlockSize, MERKLE_TREE_T* ptTree){
+	int i=0;
+	uint32_t ulSector=0;
+	uint32_t ulNode=0;
+	uint8_t* abErased=0;
+	MERKLE_NODE_T abErasedHash;
+
+	memset(ptTree,0,sizeof(MERKLE_TREE_T));
+	ptTree->ulBlockSize=ulBlockSize;
+	ptTree->ulImageSize=(uint32_t)ulDataSize;
+
+	abErased=MemAlloc(ulBlockSize);
+	if(abErased==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+	memset(abErased,0xFF,ulBlockSize);
+	Sha256(abErased,ulBlockSize,abErasedHash);
+	free(abErased);
+
+	for(i=0;i<iNumAreas && ptTree->ulNumAreas<MERKLE_MAX_AREAS;i++){
+		MERKLE_AREA_T* ptArea=&ptTree->atArea[ptTree->ulNumAreas];
+
+		if(atArea[i].ulLength==0)
+			continue;
+
+		ptArea->tArea=atArea[i];
+		if(MerkleAllocArea(ptArea,ulBlockSize)){
+			MerkleFree(ptTree);
+			return EXIT_FAILURE;
+		}
+		ptTree->ulNumAreas++;
+
+		/* leaves, sectors beyond the end of the data keep the zero hash like the padding leaves */
+		for(ulSector=0;ulSector<ptArea->ulNumSectors;ulSector++){
+			uint32_t ulOffset=ptArea->tArea.ulOffset+ulSector*ulBlockSize;
+			uint32_t ulSize=HIL_MIN(ulBlockSize,ptArea->tArea.ulOffset+ptArea->tArea.ulLength-ulOffset);
+			uint8_t* pabLeaf=ptArea->atNode[ptArea->ulNumLeaves-1+ulSector];
+
+			if(ulOffset+ulSize>ulDataSize)
+				continue;
+			/* no separate pass, the erased test stops at the first programmed byte */
+			if(ulSize==ulBlockSize && BlockErased(&pabData[ulOffset],ulSize)){
+				memcpy(pabLeaf,abErasedHash,sizeof(MERKLE_NODE_T));
+				ptTree->ulSkipped++;
+			}
+			else {
+				Sha256(&pabData[ulOffset],ulSize,pabLeaf);
+				ptTree->ulHashed++;
+			}
+		}
+
+		/* inner nodes bottom up */
+		for(ulNode=ptArea->ulNumLeaves-1;ulNode-->0;){
+			Sha256(ptArea->atNode[2*ulNode+1],2*sizeof(MERKLE_NODE_T),ptArea->atNode[ulNode]);
+		}
+	}
+
+	return 0;
+}
+
+
+
+static int MerkleWrite(char* szFilename, const MERKLE_TREE_T* ptTree){
+	FILE* hFile=NULL;
+	uint32_t i=0;
+	int iRes=0;
+	MERKLE_FILE_HEADER_T tHeader;
+	MERKLE_FILE_AREA_T tArea;
+
+	hFile=fopen(szFilename,"wb");
+	if(hFile==NULL){
+		printf("error opening file %s\n",szFilename);
+		return EXIT_FAILURE;
+	}
+
+	tHeader.ulMagic=MERKLE_MAGIC;
+	tHeader.ulVersion=MERKLE_VERSION;
+	tHeader.ulBlockSize=ptTree->ulBlockSize;
+	tHeader.ulImageSize=ptTree->ulImageSize;
+	tHeader.ulNumAreas=ptTree->ulNumAreas;
+	if(fwrite(&tHeader,sizeof(tHeader),1,hFile)!=1)
+		iRes=EXIT_FAILURE;
+
+	for(i=0;i<ptTree->ulNumAreas && iRes==0;i++){
+		memset(&tArea,0,sizeof(tArea));
+		strcpy(tArea.szSuffix,ptTree->atArea[i].tArea.szSuffix);
+		tArea.ulOffset=ptTree->atArea[i].tArea.ulOffset;
+		tArea.ulLength=ptTree->atArea[i].tArea.ulLength;
+		tArea.ulNumLeaves=ptTree->atArea[i].ulNumLeaves;
+		if(fwrite(&tArea,sizeof(tArea),1,hFile)!=1)
+			iRes=EXIT_FAILURE;
+	}
+	for(i=0;i<ptTree->ulNumAreas && iRes==0;i++){
+		size_t ulNumNodes=2*ptTree->atArea[i].ulNumLeaves-1;
+		if(fwrite(ptTree->atArea[i].atNode,sizeof(MERKLE_NODE_T),ulNumNodes,hFile)!=ulNumNodes)
+			iRes=EXIT_FAILURE;
+	}
+
+	if(fclose(hFile))
+		iRes=EXIT_FAILURE;
+	/* a truncated manifest is not left behind */
+	if(iRes){
+		printf("error writing file %s\n",szFilename);
+		remove(szFilename);
+	}
+	return iRes;
+}
+
+
+
+/* end of the last area of the flash dump layouts, areas of short dumps reach beyond the image */
+static uint64_t MerkleLayoutEnd(void){
+	uint64_t ullEnd=0;
+	int iUseCase=0;
+	int i=0;
+
+	for(iUseCase=0;iUseCase<sizeof(tFlashDumpFile)/sizeof(tFlashDumpFile[0]);iUseCase++){
+		for(i=0;i<sizeof(tFlashDumpFile[iUseCase])/sizeof(FILE_T);i++){
+			ullEnd=HIL_MAX(ullEnd,(uint64_t)tFlashDumpFile[iUseCase][i].ulOffset+tFlashDumpFile[iUseCase][i].ulLength);
+		}
+	}
+	return ullEnd;
+}
+
+/* the header has to describe the manifest file exactly before anything is allocated */
+static bool MerkleCheckHeader(const MERKLE_FILE_HEADER_T* ptHeader, const MERKLE_FILE_AREA_T* atArea, long lFileSize){
+	uint64_t ullLimit=HIL_MAX((uint64_t)ptHeader->ulImageSize,MerkleLayoutEnd());
+	uint64_t ullExpected=sizeof(MERKLE_FILE_HEADER_T)+ptHeader->ulNumAreas*sizeof(MERKLE_FILE_AREA_T);
+	uint32_t i=0;
+
+	if(ptHeader->ulBlockSize==0 || (ptHeader->ulBlockSize&(ptHeader->ulBlockSize-1)))
+		return false;
+	for(i=0;i<ptHeader->ulNumAreas;i++){
+		uint64_t ullNumSectors=((uint64_t)atArea[i].ulLength+ptHeader->ulBlockSize-1)/ptHeader->ulBlockSize;
+
+		if(atArea[i].ulLength==0 || (uint64_t)atArea[i].ulOffset+atArea[i].ulLength>ullLimit)
+			return false;
+		if(ullNumSectors>MERKLE_MAX_SECTORS || atArea[i].ulNumLeaves<ullNumSectors || atArea[i].ulNumLeaves>2*ullNumSectors)
+			return false;
+		ullExpected+=(2*(uint64_t)atArea[i].ulNumLeaves-1)*sizeof(MERKLE_NODE_T);
+	}
+	return lFileSize>=0 && (uint64_t)lFileSize==ullExpected;
+}
+
+
+
+static int MerkleRead(char* szFilename, MERKLE_TREE_T* ptTree){
+	FILE* hFile=NULL;
+	uint32_t i=0;
+	int iRes=0;
+	MERKLE_FILE_HEADER_T tHeader;
+	MERKLE_FILE_AREA_T atArea[MERKLE_MAX_AREAS];
+	long lFileSize=0;
+
+	memset(ptTree,0,sizeof(MERKLE_TREE_T));
+
+	hFile=fopen(szFilename,"rb");
+	if(hFile==NULL){
+		printf("\nError opening file %s\n",szFilename);
+		return EXIT_FAILURE;
+	}
+	fseek(hFile,0,SEEK_END);
+	lFileSize=ftell(hFile);
+	fseek(hFile,0,SEEK_SET);
+
+	if(fread(&tHeader,sizeof(tHeader),1,hFile)!=1 || tHeader.ulMagic!=MERKLE_MAGIC || tHeader.ulVersion!=MERKLE_VERSION
+			|| tHeader.ulNumAreas>MERKLE_MAX_AREAS
+			|| fread(atArea,sizeof(MERKLE_FILE_AREA_T),tHeader.ulNumAreas,hFile)!=tHeader.ulNumAreas
+			|| !MerkleCheckHeader(&tHeader,atArea,lFileSize)){
+		printf("Error: %s is no valid manifest\n",szFilename);
+		fclose(hFile);
+		return EXIT_FAILURE;
+	}
+
+	ptTree->ulBlockSize=tHeader.ulBlockSize;
+	ptTree->ulImageSize=tHeader.ulImageSize;
+
+	for(i=0;i<tHeader.ulNumAreas && iRes==0;i++){
+		MERKLE_AREA_T* ptArea=&ptTree->atArea[i];
+
+		memcpy(ptArea->tArea.szSuffix,atArea[i].szSuffix,sizeof(ptArea->tArea.szSuffix)-1);
+		ptArea->tArea.ulOffset=atArea[i].ulOffset;
+		ptArea->tArea.ulLength=atArea[i].ulLength;
+		iRes=MerkleAllocArea(ptArea,ptTree->ulBlockSize);
+		if(iRes)
+			break;
+		ptTree->ulNumAreas++;
+		if(ptArea->ulNumLeaves!=atArea[i].ulNumLeaves
+				|| fread(ptArea->atNode,sizeof(MERKLE_NODE_T),2*ptArea->ulNumLeaves-1,hFile)!=2*ptArea->ulNumLeaves-1){
+			printf("Error: %s is no valid manifest\n",szFilename);
+			iRes=EXIT_FAILURE;
+		}
+	}
+	fclose(hFile);
+
+	if(iRes)
+		MerkleFree(ptTree);
+	return iRes;
+}
+
+
+
+/* a manifest is read, any other file is hashed, flash dumps are split into the layout areas */
+static int MerkleLoad(char* szFilename, int iUseCase, MERKLE_TREE_T* ptTree){
+	uint8_t* pabData=0;
+	size_t ulDataSize=0;
+	int iRes=0;
+
+	if(IsManifestFile(szFilename)){
+		return MerkleRead(szFilename,ptTree);
+	}
+
+	pabData=LoadFile(szFilename,&ulDataSize);
+	if(pabData==NULL){
+		return EXIT_FAILURE;
+	}
+	if(IsFlashDumpFile(szFilename)){
+		iRes=MerkleBuild(pabData,ulDataSize,tFlashDumpFile[iUseCase],sizeof(tFlashDumpFile[iUseCase])/sizeof(FILE_T),GetDumpBlockSize(pabData,ulDataSize,iUseCase),ptTree);
+	}
+	else {
+		FILE_T tArea={{0},0,(uint32_t)ulDataSize,0};
+		strncpy(tArea.szSuffix,&szFilename[strlen(szFilename)-4],sizeof(tArea.szSuffix)-1);
+		iRes=MerkleBuild(pabData,ulDataSize,&tArea,1,FLASH_DUMP_DEFAULT_BLOCK_SIZE,ptTree);
+	}
+	free(pabData);
+	return iRes;
+}
+
+
+
+static void PrintRootHash(const MERKLE_NODE_T abHash){
+	int i=0;
+	for(i=0;i<SHA256_DIGEST_SIZE;i++){
+		printf("%02x",abHash[i]);
+	}
+}
+
+
+
+int CreateMerkleManifest(char* szFilename, int iUseCase){
+	char szManifest[BATCH_MAX_PATH];
+	MERKLE_TREE_T tTree;
+	uint32_t i=0;
+	int iRes=0;
+
+	if(strlen(szFilename)+sizeof(MERKLE_MANIFEST_SUFFIX)>sizeof(szManifest)){
+		printf("Error: filename too long\n");
+		return EXIT_FAILURE;
+	}
+	strcpy(szManifest,szFilename);
+	strcat(szManifest,MERKLE_MANIFEST_SUFFIX);
+
+	iRes=MerkleLoad(szFilename,iUseCase,&tTree);
+	if(iRes)
+		return iRes;
+
+	printf("\n--------------------------------------\nMERKLE MANIFEST\n");
+	printf("manifest:       %s\n",szManifest);
+	printf("block size:     0x%05x\n",tTree.ulBlockSize);
+	printf("SHA-256:        %s\n",Sha256Engine());
+	printf("sectors:        %d hashed, %d erased\n",tTree.ulHashed,tTree.ulSkipped);
+	printf("--------------------------------------\n");
+	for(i=0;i<tTree.ulNumAreas;i++){
+		printf(" %s 0x%05x 0x%05x [%4dKB] ",tTree.atArea[i].tArea.szSuffix,tTree.atArea[i].tArea.ulOffset,tTree.atArea[i].tArea.ulLength,tTree.atArea[i].tArea.ulLength/1024);
+		PrintRootHash(tTree.atArea[i].atNode[0]);
+		printf("\n");
+	}
+
+	iRes=MerkleWrite(szManifest,&tTree);
+	MerkleFree(&tTree);
+	return iRes;
+}
+
+
+
+/* visits only subtrees whose hashes differ, abChanged receives the changed sectors */
+static void MerkleDescend(const MERKLE_AREA_T* ptA, const MERKLE_AREA_T* ptB, uint32_t ulNode, uint8_t* abChanged, uint32_t* pulVisited){
+	(*pulVisited)++;
+	if(0==memcmp(ptA->atNode[ulNode],ptB->atNode[ulNode],sizeof(MERKLE_NODE_T)))
+		return;
+
+	if(ulNode>=ptA->ulNumLeaves-1){
+		uint32_t ulSector=ulNode-(ptA->ulNumLeaves-1);
+		if(ulSector<ptA->ulNumSectors)
+			abChanged[ulSector]=1;
+		return;
+	}
+	MerkleDescend(ptA,ptB,2*ulNode+1,abChanged,pulVisited);
+	MerkleDescend(ptA,ptB,2*ulNode+2,abChanged,pulVisited);
+}
+
+
+
+int DiffMerkle(char* szRefFilename, char* szFilename, int iUseCase){
+	MERKLE_TREE_T tRef;
+	MERKLE_TREE_T tCmp;
+	uint32_t i=0;
+	uint32_t j=0;
+	uint32_t ulVisited=0;
+	uint32_t ulNodes=0;
+	uint32_t ulChangedTotal=0;
+	uint8_t* abChanged=0;
+	int iRes=0;
+
+	if(MerkleLoad(szRefFilename,iUseCase,&tRef))
+		return EXIT_FAILURE;
+	if(MerkleLoad(szFilename,iUseCase,&tCmp)){
+		MerkleFree(&tRef);
+		return EXIT_FAILURE;
+	}
+
+	printf("\n--------------------------------------\nMERKLE DIFF\n");
+	printf("reference:      %s\n",szRefFilename);
+	printf("compare:        %s\n",szFilename);
+	printf("block size:     0x%05x\n",tRef.ulBlockSize);
+	printf("--------------------------------------\n");
+
+	if(tRef.ulBlockSize!=tCmp.ulBlockSize || tRef.ulNumAreas!=tCmp.ulNumAreas){
+		printf("Error: block size or area layout differs\n");
+		iRes=EXIT_FAILURE;
+	}
+
+	for(i=0;i<tRef.ulNumAreas && iRes==0;i++){
+		const MERKLE_AREA_T* ptRef=&tRef.atArea[i];
+		const MERKLE_AREA_T* ptCmp=&tCmp.atArea[i];
+		uint32_t ulChanged=0;
+
+		printf(" %s 0x%05x 0x%05x [%4dKB]",ptRef->tArea.szSuffix,ptRef->tArea.ulOffset,ptRef->tArea.ulLength,ptRef->tArea.ulLength/1024);
+		if(strcmp(ptRef->tArea.szSuffix,ptCmp->tArea.szSuffix) || ptRef->tArea.ulOffset!=ptCmp->tArea.ulOffset || ptRef->tArea.ulLength!=ptCmp->tArea.ulLength){
+			printf(" area layout differs\n");
+			continue;
+		}
+
+		abChanged=MemCalloc(ptRef->ulNumSectors,1);
+		if(abChanged==NULL){
+			printf("error malloc\n");
+			iRes=EXIT_FAILURE;
+			break;
+		}
+		MerkleDescend(ptRef,ptCmp,0,abChanged,&ulVisited);
+		ulNodes+=2*ptRef->ulNumLeaves-1;
+
+		for(j=0;j<ptRef->ulNumSectors;j++){
+			ulChanged+=abChanged[j];
+		}
+		if(ulChanged){
+			printf(" %d of %d sectors changed\n",ulChanged,ptRef->ulNumSectors);
+			PrintChangedRanges(&ptRef->tArea,tRef.ulBlockSize,abChanged);
+		}
+		else {
+			printf(" identical\n");
+		}
+		ulChangedTotal+=ulChanged;
+		free(abChanged);
+	}
+
+	if(iRes==0){
+		printf("\n%d sectors changed, %d of %d tree nodes compared\n",ulChangedTotal,ulVisited,ulNodes);
+	}
+
+	MerkleFree(&tCmp);
+	MerkleFree(&tRef);
+	return iRes;
+}
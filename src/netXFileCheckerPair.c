@@ -0,0 +1,274 @@
+/*
+ * netXFileCheckerPair.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  paired analysis of netX 90 firmware split into an internal and an extension image:
+ *  NXI + NXE (COM side, extension in SQI flash) and NAI + NAE (APP side).
+ *  The partner has the same name with the extension suffix. ulCommonCRC32 of both
+ *  common headers is the CRC32 over the data of the internal image followed by the
+ *  data of the extension image, both files are streamed through one CRC.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+#include "Hil_FileHeaderV3.h"
+
+
+#define PAIR_CHUNK_SIZE 0x10000
+
+#define PAIR_OK             0 // common CRC matches both files
+#define PAIR_SINGLE         1 // no extension and no common CRC
+#define PAIR_MISMATCH       2 // computed CRC differs
+#define PAIR_HEADER_DIFFERS 3 // the files carry different common CRCs
+#define PAIR_NO_PARTNER     4 // common CRC set, extension missing
+#define PAIR_ERROR          5 // file missing, too short or no firmware file
+
+typedef struct PAIR_RESULT_Ttag {
+	char* szPrimary;         // NXI or NAI
+	char* szPartner;         // NXE or NAE
+	char* szGenerated;       // the name not taken from the list, owned by the pair
+	int iFirst;              // first list entry of the pair
+	int iState;
+	uint32_t ulPrimaryCrc;   // ulCommonCRC32 of the internal image
+	uint32_t ulPartnerCrc;   // ulCommonCRC32 of the extension
+	uint32_t ulComputedCrc;
+} PAIR_RESULT_T;
+
+
+
+/* offset of the common header */
+static uint32_t PairCommonHeaderOffset(FILE_TYPE_E eType){
+	if(eType==FILETYPE_NAI)
+		return HBOOT_NAI_HEADER_OFFSET+sizeof(HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T)+sizeof(HIL_FILE_BOOT_HEADER_NAI_NAE_V1_0_T);
+	return sizeof(HIL_FILE_BOOT_HEADER_V1_0_T);
+}
+
+
+
+/* name of the other file of the pair, the last suffix character switches between i and e */
+static char* PairOtherName(const char* szFilename){
+	size_t ulLen=strlen(szFilename);
+	char* szOther=MemAlloc(ulLen+1);
+
+	if(szOther==NULL){
+		printf("error malloc\n");
+		return NULL;
+	}
+	memcpy(szOther,szFilename,ulLen+1);
+	switch(szOther[ulLen-1]){
+	case 'i': szOther[ulLen-1]='e'; break;
+	case 'I': szOther[ulLen-1]='E'; break;
+	case 'e': szOther[ulLen-1]='i'; break;
+	case 'E': szOther[ulLen-1]='I'; break;
+	}
+	return szOther;
+}
+
+
+
+static bool PairReadCommonHeader(FILE* hFile, FILE_TYPE_E eType, HIL_FILE_COMMON_HEADER_V3_0_T* ptCommonHeader){
+	if(fseek(hFile,PairCommonHeaderOffset(eType),SEEK_SET))
+		return false;
+	return fread(ptCommonHeader,sizeof(HIL_FILE_COMMON_HEADER_V3_0_T),1,hFile)==1;
+}
+
+
+
+/* continues the CRC over the data of a firmware file in chunks of PAIR_CHUNK_SIZE */
+static bool PairStreamCrc(FILE* hFile, const HIL_FILE_COMMON_HEADER_V3_0_T* ptCommonHeader, uint8_t* abChunk, uint32_t* pulCrc){
+	uint32_t ulRemaining=ptCommonHeader->ulDataSize;
+
+	if(fseek(hFile,ptCommonHeader->ulDataStartOffset,SEEK_SET))
+		return false;
+	while(ulRemaining){
+		size_t ulChunk=HIL_MIN(ulRemaining,PAIR_CHUNK_SIZE);
+		if(fread(abChunk,1,ulChunk,hFile)!=ulChunk)
+			return false;
+		*pulCrc=PS_CRC32(*pulCrc,abChunk,ulChunk);
+		ulRemaining-=(uint32_t)ulChunk;
+	}
+	return true;
+}
+
+
+
+static void PairCheck(PAIR_RESULT_T* ptPair, uint8_t* abChunk){
+	HIL_FILE_COMMON_HEADER_V3_0_T tPrimaryHeader;
+	HIL_FILE_COMMON_HEADER_V3_0_T tPartnerHeader;
+	FILE* hPrimary=NULL;
+	FILE* hPartner=NULL;
+	uint32_t ulCrc=0;
+
+	ptPair->iState=PAIR_ERROR;
+
+	hPrimary=fopen(ptPair->szPrimary,"rb");
+	if(hPrimary==NULL)
+		return;
+	if(!PairReadCommonHeader(hPrimary,GetFileType(ptPair->szPrimary),&tPrimaryHeader)){
+		fclose(hPrimary);
+		return;
+	}
+	ptPair->ulPrimaryCrc=tPrimaryHeader.ulCommonCRC32;
+
+	hPartner=fopen(ptPair->szPartner,"rb");
+	if(hPartner==NULL){
+		ptPair->iState=tPrimaryHeader.ulCommonCRC32 ? PAIR_NO_PARTNER : PAIR_SINGLE;
+		fclose(hPrimary);
+		return;
+	}
+
+	if(PairReadCommonHeader(hPartner,GetFileType(ptPair->szPartner),&tPartnerHeader)
+			&& PairStreamCrc(hPrimary,&tPrimaryHeader,abChunk,&ulCrc)
+			&& PairStreamCrc(hPartner,&tPartnerHeader,abChunk,&ulCrc)){
+		ptPair->ulPartnerCrc=tPartnerHeader.ulCommonCRC32;
+		ptPair->ulComputedCrc=ulCrc;
+		if(ptPair->ulPrimaryCrc!=ptPair->ulPartnerCrc)
+			ptPair->iState=PAIR_HEADER_DIFFERS;
+		else if(ptPair->ulPrimaryCrc!=ulCrc)
+			ptPair->iState=PAIR_MISMATCH;
+		else
+			ptPair->iState=PAIR_OK;
+	}
+
+	fclose(hPartner);
+	fclose(hPrimary);
+}
+
+
+
+static void PairJob(int iJob, int iWorker, void* pvContext){
+	PAIR_RESULT_T* atPair=(PAIR_RESULT_T*)pvContext;
+	uint8_t* abChunk=MemAlloc(PAIR_CHUNK_SIZE);
+
+	if(abChunk==NULL){
+		atPair[iJob].iState=PAIR_ERROR;
+		return;
+	}
+	PairCheck(&atPair[iJob],abChunk);
+	free(abChunk);
+}
+
+
+
+static int PairCompareName(const void* pvA, const void* pvB){
+	const PAIR_RESULT_T* ptA=(const PAIR_RESULT_T*)pvA;
+	const PAIR_RESULT_T* ptB=(const PAIR_RESULT_T*)pvB;
+	int iRes=strcmp(ptA->szPrimary,ptB->szPrimary);
+
+	return iRes ? iRes : ptA->iFirst-ptB->iFirst;
+}
+
+static int PairCompareFirst(const void* pvA, const void* pvB){
+	return ((const PAIR_RESULT_T*)pvA)->iFirst-((const PAIR_RESULT_T*)pvB)->iFirst;
+}
+
+
+
+static void PrintPair(const PAIR_RESULT_T* ptPair){
+	printf("%s + %s",ptPair->szPrimary,ptPair->szPartner);
+	switch(ptPair->iState){
+	case PAIR_OK:
+		printf("  CRC 0x%08x  OK\n",ptPair->ulComputedCrc);
+		break;
+	case PAIR_SINGLE:
+		printf("  no extension  OK\n");
+		break;
+	case PAIR_MISMATCH:
+		printf("  CRC 0x%08x expected 0x%08x  MISMATCH\n",ptPair->ulComputedCrc,ptPair->ulPrimaryCrc);
+		break;
+	case PAIR_HEADER_DIFFERS:
+		printf("  common CRC 0x%08x / 0x%08x, computed 0x%08x  MISMATCH\n",ptPair->ulPrimaryCrc,ptPair->ulPartnerCrc,ptPair->ulComputedCrc);
+		break;
+	case PAIR_NO_PARTNER:
+		printf("  common CRC 0x%08x, extension missing  FAIL\n",ptPair->ulPrimaryCrc);
+		break;
+	default:
+		printf("  ERROR reading firmware\n");
+		break;
+	}
+}
+
+
+
+/* checks the common CRC of all NXI/NXE and NAI/NAE pairs of the batch,
+ * either file of a pair may be listed, each pair is checked once */
+int CheckFirmwarePairs(char** aszFiles, int iNumFiles, int iNumThreads){
+	PAIR_RESULT_T* atPair=0;
+	int iNumPairs=0;
+	int iNumUnique=0;
+	int iFailed=0;
+	int iSkipped=0;
+	int i=0;
+
+	atPair=MemCalloc(iNumFiles,sizeof(PAIR_RESULT_T));
+	if(atPair==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+
+	for(i=0;i<iNumFiles;i++){
+		FILE_TYPE_E eType=GetFileType(aszFiles[i]);
+		char* szOther=0;
+
+		if(eType!=FILETYPE_NXI && eType!=FILETYPE_NXE && eType!=FILETYPE_NAI && eType!=FILETYPE_NAE){
+			iSkipped++;
+			continue;
+		}
+		szOther=PairOtherName(aszFiles[i]);
+		if(szOther==NULL)
+			break;
+		if(eType==FILETYPE_NXI || eType==FILETYPE_NAI){
+			atPair[iNumPairs].szPrimary=aszFiles[i];
+			atPair[iNumPairs].szPartner=szOther;
+		}
+		else {
+			atPair[iNumPairs].szPrimary=szOther;
+			atPair[iNumPairs].szPartner=aszFiles[i];
+		}
+		atPair[iNumPairs].szGenerated=szOther;
+		atPair[iNumPairs].iFirst=i;
+		iNumPairs++;
+	}
+
+	/* pairs listed twice are checked once, at the first list entry */
+	qsort(atPair,iNumPairs,sizeof(PAIR_RESULT_T),PairCompareName);
+	for(i=1;i<iNumPairs;i++){
+		if(0==strcmp(atPair[i].szPrimary,atPair[i-1].szPrimary))
+			atPair[i].iState=-1;
+	}
+	qsort(atPair,iNumPairs,sizeof(PAIR_RESULT_T),PairCompareFirst);
+	for(i=0,iNumUnique=0;i<iNumPairs;i++){
+		if(atPair[i].iState<0)
+			free(atPair[i].szGenerated);
+		else
+			atPair[iNumUnique++]=atPair[i];
+	}
+
+	if(iNumThreads<=0)
+		iNumThreads=BatchGetNumCpus();
+	BatchRun(iNumUnique,iNumThreads,PairJob,atPair);
+
+	printf("\n--------------------------------------\nFIRMWARE PAIRS\n");
+	printf("files:          %d\n",iNumFiles);
+	printf("pairs:          %d\n",iNumUnique);
+	printf("--------------------------------------\n");
+	for(i=0;i<iNumUnique;i++){
+		PrintPair(&atPair[i]);
+		if(atPair[i].iState>PAIR_SINGLE)
+			iFailed++;
+		free(atPair[i].szGenerated);
+	}
+	printf("\n%d passed, %d failed",iNumUnique-iFailed,iFailed);
+	if(iSkipped)
+		printf(", %d files skipped, no NXI/NXE/NAI/NAE",iSkipped);
+	printf("\n");
+
+	free(atPair);
+	return iFailed || iNumUnique==0 ? EXIT_FAILURE : 0;
+}
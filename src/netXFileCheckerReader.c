@@ -0,0 +1,1073 @@
+/*
+ * netXFileCheckerReader.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  asynchronous batch reader: whole files are read and handed to parser workers.
+ *  On Linux an io_uring keeps up to BATCH_READ_DEPTH files in flight, every file is one
+ *  chain of open, statx, read and close operations driven by the completions. The calling
+ *  thread runs the ring, completed buffers are parsed by iNumThreads workers. A file slot
+ *  is reused after its buffer is parsed, so at most BATCH_READ_DEPTH files are in memory.
+ *  Without io_uring (other systems, old kernels, blocked by seccomp) the files are read
+ *  with blocking open/size/read/close by the workers of BatchRun, one file per worker.
+ *  With physical order the files are started in the order of their data on the disk and
+ *  each file is read once with sequential readahead and dropped from the page cache,
+ *  the parser still gets the list index, so results stay in list order.
+ *  With direct I/O the files bypass the page cache (O_DIRECT, FILE_FLAG_NO_BUFFERING) and are
+ *  read into aligned buffers. The parser gets the buffer like a mapping of the file.
+ *  File buffers come from an arena per worker or ring slot, sized to the flash dump layout and
+ *  reset after the file is parsed, so a batch allocates only while the arenas warm up.
+ *  BatchReadRanges reads given ranges of each file instead of the whole file, the ranges of a
+ *  slot are read one after the other by the ring or with pread, always through the page cache.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // O_DIRECT
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define BATCH_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include <linux/stat.h>
+#ifndef AT_EMPTY_PATH
+#define AT_EMPTY_PATH 0x1000
+#endif
+#endif
+#endif
+
+#include "netXFileChecker.h"
+
+
+#define BATCH_READ_DEPTH 64 // files in flight
+#define BATCH_DIRECT_ALIGN 4096 // buffer address, file offset and length of direct reads
+
+typedef struct BATCH_READ_STATS_Ttag {
+	const char* szBackend;
+	const char* szOrder;
+	int iQueueDepth;
+	volatile long lOperations;   // completed I/O operations
+	volatile long lErrors;
+	volatile long lBuffered;     // direct I/O not supported by the file system
+	uint64_t ullBytes;
+	int64_t llStart;
+	int64_t llEnd;
+} BATCH_READ_STATS_T;
+
+typedef struct BATCH_READ_POOL_Ttag {
+	char** aszFiles;
+	const int* aiOrder;          // read order, NULL for list order
+	bool bAdvise;
+	bool bDirect;
+	BATCH_RANGES_T* atRanges;    // per file, NULL to read whole files
+	FILE_ARENA_T* atArena;       // per worker
+	BATCH_READ_FN fnParse;
+	void* pvContext;
+	BATCH_READ_STATS_T* ptStats;
+	void* pvLock;                // ullBytes
+} BATCH_READ_POOL_T;
+
+static bool s_bPhysicalOrder=false;
+static bool s_bDirect=false;
+
+
+
+static int64_t ReaderNow(void){
+#ifdef _WIN32
+	LARGE_INTEGER tCount;
+	LARGE_INTEGER tFrequency;
+	QueryPerformanceCounter(&tCount);
+	QueryPerformanceFrequency(&tFrequency);
+	return (int64_t)((double)tCount.QuadPart*1e9/(double)tFrequency.QuadPart);
+#else
+	struct timespec tTime;
+	clock_gettime(CLOCK_MONOTONIC,&tTime);
+	return (int64_t)tTime.tv_sec*1000000000LL+tTime.tv_nsec;
+#endif
+}
+
+static void ReaderCount(volatile long* plCounter, long lAdd){
+#ifdef _WIN32
+	InterlockedExchangeAdd(plCounter,lAdd);
+#else
+	__sync_fetch_and_add(plCounter,lAdd);
+#endif
+}
+
+
+
+/* readahead of the whole file, or dropping it from the page cache once it is read */
+static void ReaderAdvise(int iFd, bool bDone){
+#if !defined(_WIN32) && defined(POSIX_FADV_SEQUENTIAL)
+	posix_fadvise(iFd,0,0,bDone ? POSIX_FADV_DONTNEED : POSIX_FADV_SEQUENTIAL);
+#else
+	(void)iFd;
+	(void)bDone;
+#endif
+}
+
+
+
+static size_t ReaderAlignUp(size_t ulSize){
+	return (ulSize+BATCH_DIRECT_ALIGN-1)&~(size_t)(BATCH_DIRECT_ALIGN-1);
+}
+
+/* offset of the next read of a file, ulDone bytes are read. Direct reads need an aligned
+ * offset, after a short read the partly read block is read again. The buffer is aligned,
+ * so the buffer address at the offset is aligned too. */
+static size_t ReaderReadStart(size_t ulDone, bool bDirect){
+	return bDirect ? ulDone&~(size_t)(BATCH_DIRECT_ALIGN-1) : ulDone;
+}
+
+/* end of the last area of the flash dump layouts */
+static size_t ReaderLayoutSize(void){
+	size_t ulEnd=0;
+	int iUseCase=0;
+	int i=0;
+
+	for(iUseCase=0;iUseCase<sizeof(tFlashDumpFile)/sizeof(tFlashDumpFile[0]);iUseCase++){
+		for(i=0;i<sizeof(tFlashDumpFile[iUseCase])/sizeof(FILE_T);i++){
+			ulEnd=HIL_MAX(ulEnd,(size_t)tFlashDumpFile[iUseCase][i].ulOffset+tFlashDumpFile[iUseCase][i].ulLength);
+		}
+	}
+	return ReaderAlignUp(ulEnd);
+}
+
+/* buffer for a file of ulSize bytes, direct reads are aligned and rounded up to the alignment */
+static uint8_t* ReaderGetBuffer(FILE_ARENA_T* ptArena, size_t ulSize, bool bDirect){
+	if(bDirect)
+		return ArenaAlloc(ptArena,ReaderAlignUp(HIL_MAX(ulSize,1)),BATCH_DIRECT_ALIGN);
+	return ArenaAlloc(ptArena,ulSize ? ulSize : 1,sizeof(uint64_t));
+}
+
+/* buffer size for the ranges of a file, they follow each other without gaps */
+static size_t ReaderRangesSize(const BATCH_RANGES_T* ptRanges){
+	size_t ulSize=0;
+	int i=0;
+
+	for(i=0;i<ptRanges->iNumRanges;i++){
+		ulSize+=ptRanges->atRange[i].ulSize;
+	}
+	return ulSize;
+}
+
+/* arena block size, one block holds the largest file */
+static size_t ReaderBlockSize(const BATCH_RANGES_T* atRanges, int iNumFiles){
+	size_t ulSize=0;
+	int i=0;
+
+	if(atRanges==NULL)
+		return ReaderLayoutSize();
+	for(i=0;i<iNumFiles;i++){
+		ulSize=HIL_MAX(ulSize,ReaderRangesSize(&atRanges[i]));
+	}
+	return ulSize;
+}
+
+
+
+/* blocking read of a whole file, counts open, size, read and close operations,
+ * the buffer is released with the reset of the arena */
+static uint8_t* ReaderLoadFile(char* szFilename, const BATCH_READ_POOL_T* ptPool, FILE_ARENA_T* ptArena, size_t* pulSize, long* plOperations, bool* pbBuffered){
+	uint8_t* pabData=0;
+	size_t ulDone=0;
+	size_t ulFileSize=0;
+	bool bDirect=ptPool->bDirect;
+#ifdef _WIN32
+	LARGE_INTEGER tSize;
+	DWORD dwRead=0;
+	HANDLE hFile=CreateFileA(szFilename,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,bDirect ? FILE_FLAG_NO_BUFFERING : FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+
+	*pbBuffered=false;
+	(*plOperations)++;
+	if(hFile==INVALID_HANDLE_VALUE)
+		return NULL;
+	(*plOperations)++;
+	if(GetFileSizeEx(hFile,&tSize)){
+		ulFileSize=(size_t)tSize.QuadPart;
+		pabData=ReaderGetBuffer(ptArena,ulFileSize,ptPool->bDirect);
+	}
+	while(pabData!=NULL && ulDone<ulFileSize){
+		size_t ulStart=ReaderReadStart(ulDone,bDirect);
+		size_t ulChunk=HIL_MIN(ulFileSize-ulStart,0x40000000);
+		OVERLAPPED tOverlapped;
+
+		memset(&tOverlapped,0,sizeof(tOverlapped));
+		tOverlapped.Offset=(DWORD)ulStart;
+		tOverlapped.OffsetHigh=(DWORD)((uint64_t)ulStart>>32);
+		(*plOperations)++;
+		if(!ReadFile(hFile,pabData+ulStart,(DWORD)(bDirect ? ReaderAlignUp(ulChunk) : ulChunk),&dwRead,&tOverlapped) || ulStart+dwRead<=ulDone)
+			break;
+		ulDone=ulStart+dwRead;
+	}
+	(*plOperations)++;
+	CloseHandle(hFile);
+#else
+	struct stat tStat;
+	ssize_t lRead=0;
+	int iFd=-1;
+
+#ifdef O_DIRECT
+	if(bDirect){
+		iFd=open(szFilename,O_RDONLY|O_DIRECT);
+		/* the file system has no direct I/O (tmpfs, some network file systems) */
+		if(iFd<0 && errno==EINVAL)
+			bDirect=false;
+	}
+#else
+	bDirect=false;
+#endif
+	if(!bDirect)
+		iFd=open(szFilename,O_RDONLY);
+
+	*pbBuffered=(ptPool->bDirect && !bDirect);
+	(*plOperations)++;
+	if(iFd<0)
+		return NULL;
+#ifdef F_NOCACHE
+	if(ptPool->bDirect)
+		fcntl(iFd,F_NOCACHE,1);
+#endif
+	if(ptPool->bAdvise || *pbBuffered)
+		ReaderAdvise(iFd,false);
+	(*plOperations)++;
+	if(fstat(iFd,&tStat)==0){
+		ulFileSize=(size_t)tStat.st_size;
+		pabData=ReaderGetBuffer(ptArena,ulFileSize,ptPool->bDirect);
+	}
+	while(pabData!=NULL && ulDone<ulFileSize){
+		size_t ulStart=ReaderReadStart(ulDone,bDirect);
+
+		(*plOperations)++;
+		lRead=pread(iFd,pabData+ulStart,bDirect ? ReaderAlignUp(ulFileSize-ulStart) : ulFileSize-ulStart,(off_t)ulStart);
+		if(lRead<=0 || ulStart+(size_t)lRead<=ulDone)
+			break;
+		ulDone=ulStart+(size_t)lRead;
+	}
+	if(ptPool->bAdvise || *pbBuffered)
+		ReaderAdvise(iFd,true);
+	(*plOperations)++;
+	close(iFd);
+#endif
+	if(pabData!=NULL && ulDone!=ulFileSize){
+		ArenaReset(ptArena);
+		pabData=NULL;
+	}
+	*pulSize=ulDone;
+	return pabData;
+}
+
+
+
+/* blocking read of the ranges of a file, counts open, read and close operations,
+ * a range is read short at the end of the file */
+static uint8_t* ReaderLoadRanges(char* szFilename, BATCH_RANGES_T* ptRanges, FILE_ARENA_T* ptArena, size_t* pulSize, long* plOperations){
+	uint8_t* pabData=ReaderGetBuffer(ptArena,ReaderRangesSize(ptRanges),false);
+	size_t ulPos=0;
+	bool bError=(pabData==NULL);
+	int i=0;
+#ifdef _WIN32
+	HANDLE hFile=CreateFileA(szFilename,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_FLAG_RANDOM_ACCESS,NULL);
+
+	(*plOperations)++;
+	if(hFile==INVALID_HANDLE_VALUE)
+		bError=true;
+	for(i=0;i<ptRanges->iNumRanges && !bError;i++){
+		BATCH_RANGE_T* ptRange=&ptRanges->atRange[i];
+		OVERLAPPED tOverlapped;
+		DWORD dwRead=0;
+
+		memset(&tOverlapped,0,sizeof(tOverlapped));
+		tOverlapped.Offset=ptRange->ulOffset;
+		(*plOperations)++;
+		if(!ReadFile(hFile,pabData+ulPos,ptRange->ulSize,&dwRead,&tOverlapped) && GetLastError()!=ERROR_HANDLE_EOF)
+			bError=true;
+		ptRange->ulRead=dwRead;
+		ulPos+=ptRange->ulSize;
+	}
+	if(hFile!=INVALID_HANDLE_VALUE){
+		(*plOperations)++;
+		CloseHandle(hFile);
+	}
+#else
+	int iFd=open(szFilename,O_RDONLY);
+
+	(*plOperations)++;
+	if(iFd<0)
+		bError=true;
+	for(i=0;i<ptRanges->iNumRanges && !bError;i++){
+		BATCH_RANGE_T* ptRange=&ptRanges->atRange[i];
+		ssize_t lRead=0;
+
+		ptRange->ulRead=0;
+		while(ptRange->ulRead<ptRange->ulSize){
+			(*plOperations)++;
+			lRead=pread(iFd,pabData+ulPos+ptRange->ulRead,ptRange->ulSize-ptRange->ulRead,(off_t)ptRange->ulOffset+ptRange->ulRead);
+			if(lRead<=0)
+				break;
+			ptRange->ulRead+=(uint32_t)lRead;
+		}
+		if(lRead<0)
+			bError=true;
+		ulPos+=ptRange->ulSize;
+	}
+	if(iFd>=0){
+		(*plOperations)++;
+		close(iFd);
+	}
+#endif
+	if(bError){
+		ArenaReset(ptArena);
+		return NULL;
+	}
+	*pulSize=ulPos;
+	return pabData;
+}
+
+/* bytes read of all ranges of a file */
+static size_t ReaderRangesRead(const BATCH_RANGES_T* ptRanges){
+	size_t ulRead=0;
+	int i=0;
+
+	for(i=0;i<ptRanges->iNumRanges;i++){
+		ulRead+=ptRanges->atRange[i].ulRead;
+	}
+	return ulRead;
+}
+
+
+
+static void ReaderJob(int iJob, int iWorker, void* pvContext){
+	BATCH_READ_POOL_T* ptPool=(BATCH_READ_POOL_T*)pvContext;
+	int iFile=ptPool->aiOrder ? ptPool->aiOrder[iJob] : iJob;
+	FILE_ARENA_T* ptArena=&ptPool->atArena[iWorker];
+	long lOperations=0;
+	size_t ulSize=0;
+	size_t ulBytes=0;
+	bool bBuffered=false;
+	uint8_t* pabData=0;
+
+	if(ptPool->atRanges!=NULL){
+		pabData=ReaderLoadRanges(ptPool->aszFiles[iFile],&ptPool->atRanges[iFile],ptArena,&ulSize,&lOperations);
+		ulBytes=ReaderRangesRead(&ptPool->atRanges[iFile]);
+	}
+	else {
+		pabData=ReaderLoadFile(ptPool->aszFiles[iFile],ptPool,ptArena,&ulSize,&lOperations,&bBuffered);
+		ulBytes=ulSize;
+	}
+
+	ReaderCount(&ptPool->ptStats->lOperations,lOperations);
+	if(bBuffered && pabData!=NULL)
+		ReaderCount(&ptPool->ptStats->lBuffered,1);
+	if(pabData==NULL){
+		ReaderCount(&ptPool->ptStats->lErrors,1);
+	}
+	else {
+		BatchLock(ptPool->pvLock);
+		ptPool->ptStats->ullBytes+=ulBytes;
+		BatchUnlock(ptPool->pvLock);
+	}
+	ptPool->fnParse(iFile,iWorker,pabData,ulSize,ptPool->pvContext);
+	ArenaReset(ptArena);
+}
+
+
+
+static int ReaderRunThreads(char** aszFiles, const int* aiOrder, int iNumFiles, int iNumThreads, BATCH_RANGES_T* atRanges, BATCH_READ_FN fnParse, void* pvContext, BATCH_READ_STATS_T* ptStats){
+	BATCH_READ_POOL_T tPool;
+	int iRes=0;
+	int i=0;
+
+	tPool.aszFiles=aszFiles;
+	tPool.aiOrder=aiOrder;
+	tPool.bAdvise=(aiOrder!=NULL);
+	tPool.bDirect=s_bDirect && atRanges==NULL;
+	tPool.atRanges=atRanges;
+	tPool.fnParse=fnParse;
+	tPool.pvContext=pvContext;
+	tPool.ptStats=ptStats;
+	tPool.atArena=MemCalloc(iNumThreads,sizeof(FILE_ARENA_T));
+	tPool.pvLock=BatchLockCreate();
+	if(tPool.pvLock==NULL || tPool.atArena==NULL){
+		printf("error malloc\n");
+		BatchLockDestroy(tPool.pvLock);
+		free(tPool.atArena);
+		return EXIT_FAILURE;
+	}
+	for(i=0;i<iNumThreads;i++){
+		ArenaInit(&tPool.atArena[i],ReaderBlockSize(atRanges,iNumFiles));
+	}
+	ptStats->szBackend="threads";
+	ptStats->iQueueDepth=HIL_MIN(iNumThreads,iNumFiles);
+	iRes=BatchRun(iNumFiles,iNumThreads,ReaderJob,&tPool);
+	for(i=0;i<iNumThreads;i++){
+		ArenaFree(&tPool.atArena[i]);
+	}
+	free(tPool.atArena);
+	BatchLockDestroy(tPool.pvLock);
+	return iRes;
+}
+
+
+
+#ifdef BATCH_IO_URING
+
+#define SLOT_FREE   0
+#define SLOT_OPEN   1
+#define SLOT_STATX  2
+#define SLOT_READ   3
+#define SLOT_CLOSE  4
+#define SLOT_PARSE  5
+
+typedef struct URING_Ttag {
+	int iFd;
+	unsigned uiEntries;
+	unsigned uiToSubmit;
+	unsigned uiPending;          // submitted, completion not reaped yet
+	unsigned* puiSqHead;
+	unsigned* puiSqTail;
+	unsigned* puiSqMask;
+	unsigned* puiSqArray;
+	unsigned* puiCqHead;
+	unsigned* puiCqTail;
+	unsigned* puiCqMask;
+	struct io_uring_sqe* atSqe;
+	struct io_uring_cqe* atCqe;
+	void* pvSqRing;
+	size_t ulSqRingSize;
+	void* pvCqRing;
+	size_t ulCqRingSize;
+} URING_T;
+
+typedef struct READ_SLOT_Ttag {
+	int iJob;
+	int iState;
+	int iFd;
+	bool bError;
+	bool bDirect;                // opened with O_DIRECT
+	uint8_t* pabData;
+	size_t ulSize;
+	size_t ulDone;
+	int iRange;                  // range read, BatchReadRanges
+	size_t ulRangeStart;         // offset of the range in pabData
+	struct statx tStatx;
+} READ_SLOT_T;
+
+/* slots between ring and parser workers */
+typedef struct URING_READER_Ttag {
+	char** aszFiles;
+	const int* aiOrder;          // read order, NULL for list order
+	bool bDirect;
+	BATCH_RANGES_T* atRanges;    // per file, NULL to read whole files
+	BATCH_READ_FN fnParse;
+	void* pvContext;
+	READ_SLOT_T atSlot[BATCH_READ_DEPTH];
+	FILE_ARENA_T atArena[BATCH_READ_DEPTH];
+	pthread_mutex_t tLock;
+	pthread_cond_t tParse;       // slot ready to parse or no more files
+	pthread_cond_t tFree;        // slot parsed
+	int aiReady[BATCH_READ_DEPTH];
+	int iReadyHead;
+	int iNumReady;
+	int iNumFree;
+	bool bDone;
+} URING_READER_T;
+
+typedef struct URING_WORKER_Ttag {
+	URING_READER_T* ptReader;
+	int iWorker;
+} URING_WORKER_T;
+
+
+
+static int UringSetup(URING_T* ptRing, unsigned uiEntries){
+	struct io_uring_params tParams;
+	struct io_uring_probe* ptProbe=0;
+	static const int aiOps[]={IORING_OP_OPENAT,IORING_OP_STATX,IORING_OP_READ,IORING_OP_CLOSE};
+	uint8_t* pabSq=0;
+	uint8_t* pabCq=0;
+	int i=0;
+
+	memset(ptRing,0,sizeof(URING_T));
+	memset(&tParams,0,sizeof(tParams));
+	ptRing->iFd=(int)syscall(__NR_io_uring_setup,uiEntries,&tParams);
+	if(ptRing->iFd<0)
+		return EXIT_FAILURE;
+
+	/* the operations are available since Linux 5.6 */
+	ptProbe=MemCalloc(1,sizeof(struct io_uring_probe)+256*sizeof(struct io_uring_probe_op));
+	if(ptProbe==NULL || syscall(__NR_io_uring_register,ptRing->iFd,IORING_REGISTER_PROBE,ptProbe,256)<0){
+		free(ptProbe);
+		close(ptRing->iFd);
+		return EXIT_FAILURE;
+	}
+	for(i=0;i<sizeof(aiOps)/sizeof(aiOps[0]);i++){
+		if(aiOps[i]>ptProbe->last_op || !(ptProbe->ops[aiOps[i]].flags&IO_URING_OP_SUPPORTED)){
+			free(ptProbe);
+			close(ptRing->iFd);
+			return EXIT_FAILURE;
+		}
+	}
+	free(ptProbe);
+
+	ptRing->uiEntries=tParams.sq_entries;
+	ptRing->ulSqRingSize=tParams.sq_off.array+tParams.sq_entries*sizeof(unsigned);
+	ptRing->ulCqRingSize=tParams.cq_off.cqes+tParams.cq_entries*sizeof(struct io_uring_cqe);
+	if(tParams.features&IORING_FEAT_SINGLE_MMAP)
+		ptRing->ulSqRingSize=ptRing->ulCqRingSize=HIL_MAX(ptRing->ulSqRingSize,ptRing->ulCqRingSize);
+
+	ptRing->pvSqRing=mmap(NULL,ptRing->ulSqRingSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,ptRing->iFd,IORING_OFF_SQ_RING);
+	if(ptRing->pvSqRing==MAP_FAILED){
+		close(ptRing->iFd);
+		return EXIT_FAILURE;
+	}
+	if(tParams.features&IORING_FEAT_SINGLE_MMAP){
+		ptRing->pvCqRing=ptRing->pvSqRing;
+	}
+	else {
+		ptRing->pvCqRing=mmap(NULL,ptRing->ulCqRingSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,ptRing->iFd,IORING_OFF_CQ_RING);
+		if(ptRing->pvCqRing==MAP_FAILED){
+			munmap(ptRing->pvSqRing,ptRing->ulSqRingSize);
+			close(ptRing->iFd);
+			return EXIT_FAILURE;
+		}
+	}
+	ptRing->atSqe=mmap(NULL,tParams.sq_entries*sizeof(struct io_uring_sqe),PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,ptRing->iFd,IORING_OFF_SQES);
+	if(ptRing->atSqe==MAP_FAILED){
+		if(ptRing->pvCqRing!=ptRing->pvSqRing)
+			munmap(ptRing->pvCqRing,ptRing->ulCqRingSize);
+		munmap(ptRing->pvSqRing,ptRing->ulSqRingSize);
+		close(ptRing->iFd);
+		return EXIT_FAILURE;
+	}
+
+	pabSq=ptRing->pvSqRing;
+	pabCq=ptRing->pvCqRing;
+	ptRing->puiSqHead=(unsigned*)(pabSq+tParams.sq_off.head);
+	ptRing->puiSqTail=(unsigned*)(pabSq+tParams.sq_off.tail);
+	ptRing->puiSqMask=(unsigned*)(pabSq+tParams.sq_off.ring_mask);
+	ptRing->puiSqArray=(unsigned*)(pabSq+tParams.sq_off.array);
+	ptRing->puiCqHead=(unsigned*)(pabCq+tParams.cq_off.head);
+	ptRing->puiCqTail=(unsigned*)(pabCq+tParams.cq_off.tail);
+	ptRing->puiCqMask=(unsigned*)(pabCq+tParams.cq_off.ring_mask);
+	ptRing->atCqe=(struct io_uring_cqe*)(pabCq+tParams.cq_off.cqes);
+	return 0;
+}
+
+static void UringClose(URING_T* ptRing){
+	munmap(ptRing->atSqe,ptRing->uiEntries*sizeof(struct io_uring_sqe));
+	if(ptRing->pvCqRing!=ptRing->pvSqRing)
+		munmap(ptRing->pvCqRing,ptRing->ulCqRingSize);
+	munmap(ptRing->pvSqRing,ptRing->ulSqRingSize);
+	close(ptRing->iFd);
+}
+
+/* next free submission entry, the ring has one entry per slot so it never runs full */
+static struct io_uring_sqe* UringGetSqe(URING_T* ptRing, int iSlot){
+	unsigned uiTail=*ptRing->puiSqTail;
+	unsigned uiIndex=uiTail&*ptRing->puiSqMask;
+	struct io_uring_sqe* ptSqe=&ptRing->atSqe[uiIndex];
+
+	memset(ptSqe,0,sizeof(struct io_uring_sqe));
+	ptSqe->user_data=(uint64_t)iSlot;
+	ptRing->puiSqArray[uiIndex]=uiIndex;
+	__atomic_store_n(ptRing->puiSqTail,uiTail+1,__ATOMIC_RELEASE);
+	ptRing->uiToSubmit++;
+	return ptSqe;
+}
+
+/* a signal interrupting the wait is no error, the call is repeated */
+static int UringSubmitAndWait(URING_T* ptRing, unsigned uiWait){
+	long lRes=0;
+
+	do {
+		lRes=syscall(__NR_io_uring_enter,ptRing->iFd,ptRing->uiToSubmit,uiWait,uiWait ? IORING_ENTER_GETEVENTS : 0,NULL,0);
+	} while(lRes<0 && errno==EINTR);
+
+	if(lRes<0)
+		return EXIT_FAILURE;
+	ptRing->uiToSubmit-=(unsigned)lRes;
+	ptRing->uiPending+=(unsigned)lRes;
+	return 0;
+}
+
+
+
+/* queues the next operation of the slot, the file is closed after an error */
+static void UringQueueSlot(URING_T* ptRing, URING_READER_T* ptReader, int iSlot){
+	READ_SLOT_T* ptSlot=&ptReader->atSlot[iSlot];
+	struct io_uring_sqe* ptSqe=UringGetSqe(ptRing,iSlot);
+	size_t ulStart=0;
+
+	switch(ptSlot->iState){
+	case SLOT_OPEN:
+		ptSqe->opcode=IORING_OP_OPENAT;
+		ptSqe->fd=AT_FDCWD;
+		ptSqe->addr=(uint64_t)(uintptr_t)ptReader->aszFiles[ptSlot->iJob];
+		ptSqe->open_flags=O_RDONLY;
+#ifdef O_DIRECT
+		if(ptSlot->bDirect)
+			ptSqe->open_flags|=O_DIRECT;
+#endif
+		break;
+	case SLOT_STATX:
+		ptSqe->opcode=IORING_OP_STATX;
+		ptSqe->fd=ptSlot->iFd;
+		ptSqe->addr=(uint64_t)(uintptr_t)"";
+		ptSqe->len=STATX_SIZE;
+		ptSqe->statx_flags=AT_EMPTY_PATH;
+		ptSqe->off=(uint64_t)(uintptr_t)&ptSlot->tStatx;
+		break;
+	case SLOT_READ:
+		if(ptReader->atRanges!=NULL){
+			const BATCH_RANGE_T* ptRange=&ptReader->atRanges[ptSlot->iJob].atRange[ptSlot->iRange];
+			ptSqe->opcode=IORING_OP_READ;
+			ptSqe->fd=ptSlot->iFd;
+			ptSqe->addr=(uint64_t)(uintptr_t)(ptSlot->pabData+ptSlot->ulRangeStart+ptRange->ulRead);
+			ptSqe->len=ptRange->ulSize-ptRange->ulRead;
+			ptSqe->off=(uint64_t)ptRange->ulOffset+ptRange->ulRead;
+			break;
+		}
+		ulStart=ReaderReadStart(ptSlot->ulDone,ptSlot->bDirect);
+		ptSqe->opcode=IORING_OP_READ;
+		ptSqe->fd=ptSlot->iFd;
+		ptSqe->addr=(uint64_t)(uintptr_t)(ptSlot->pabData+ulStart);
+		ptSqe->len=(uint32_t)HIL_MIN(ptSlot->ulSize-ulStart,0x40000000);
+		if(ptSlot->bDirect)
+			ptSqe->len=(uint32_t)ReaderAlignUp(ptSqe->len);
+		ptSqe->off=ulStart;
+		break;
+	default:
+		ptSqe->opcode=IORING_OP_CLOSE;
+		ptSqe->fd=ptSlot->iFd;
+		break;
+	}
+}
+
+
+
+/* moves the slot to the next range with bytes left, false after the last range */
+static bool UringNextRange(READ_SLOT_T* ptSlot, const BATCH_RANGES_T* ptRanges){
+	while(ptSlot->iRange<ptRanges->iNumRanges){
+		const BATCH_RANGE_T* ptRange=&ptRanges->atRange[ptSlot->iRange];
+		if(ptRange->ulRead<ptRange->ulSize)
+			return true;
+		ptSlot->ulRangeStart+=ptRange->ulSize;
+		ptSlot->iRange++;
+	}
+	return false;
+}
+
+/* a read of BatchReadRanges completed, a range ends early at the end of the file */
+static void UringCompleteRange(URING_READER_T* ptReader, READ_SLOT_T* ptSlot, int iRes){
+	BATCH_RANGES_T* ptRanges=&ptReader->atRanges[ptSlot->iJob];
+	BATCH_RANGE_T* ptRange=&ptRanges->atRange[ptSlot->iRange];
+
+	if(iRes<0){
+		ptSlot->bError=true;
+		ptSlot->iState=SLOT_CLOSE;
+		return;
+	}
+	ptRange->ulRead+=(uint32_t)iRes;
+	ptSlot->ulDone+=(size_t)iRes;
+	if(iRes==0){
+		ptSlot->ulRangeStart+=ptRange->ulSize;
+		ptSlot->iRange++;
+	}
+	if(!UringNextRange(ptSlot,ptRanges))
+		ptSlot->iState=SLOT_CLOSE;
+}
+
+
+
+/* a completed operation moves the slot to the next one, returns true when the file is read and closed */
+static bool UringComplete(URING_T* ptRing, URING_READER_T* ptReader, int iSlot, int iRes){
+	READ_SLOT_T* ptSlot=&ptReader->atSlot[iSlot];
+	size_t ulStart=0;
+
+	switch(ptSlot->iState){
+	case SLOT_OPEN:
+		if(iRes==-EINVAL && ptSlot->bDirect){
+			/* the file system has no direct I/O, open again without */
+			ptSlot->bDirect=false;
+			break;
+		}
+		if(iRes<0){
+			ptSlot->bError=true;
+			return true;
+		}
+		ptSlot->iFd=iRes;
+		if(ptReader->atRanges!=NULL){
+			/* the ranges need no file size, a range beyond the end is read short */
+			ptSlot->ulSize=ReaderRangesSize(&ptReader->atRanges[ptSlot->iJob]);
+			ptSlot->pabData=ReaderGetBuffer(&ptReader->atArena[iSlot],ptSlot->ulSize,false);
+			ptSlot->bError=(ptSlot->pabData==NULL);
+			ptSlot->iState=(!ptSlot->bError && UringNextRange(ptSlot,&ptReader->atRanges[ptSlot->iJob])) ? SLOT_READ : SLOT_CLOSE;
+			break;
+		}
+		if(ptReader->aiOrder || ptReader->bDirect!=ptSlot->bDirect)
+			ReaderAdvise(ptSlot->iFd,false);
+		ptSlot->iState=SLOT_STATX;
+		break;
+	case SLOT_STATX:
+		if(iRes>=0){
+			ptSlot->ulSize=(size_t)ptSlot->tStatx.stx_size;
+			ptSlot->pabData=ReaderGetBuffer(&ptReader->atArena[iSlot],ptSlot->ulSize,ptReader->bDirect);
+		}
+		ptSlot->bError=(iRes<0 || ptSlot->pabData==NULL);
+		ptSlot->iState=(ptSlot->bError || ptSlot->ulSize==0) ? SLOT_CLOSE : SLOT_READ;
+		break;
+	case SLOT_READ:
+		if(ptReader->atRanges!=NULL){
+			UringCompleteRange(ptReader,ptSlot,iRes);
+			break;
+		}
+		ulStart=ReaderReadStart(ptSlot->ulDone,ptSlot->bDirect);
+		if(iRes<=0 || ulStart+(size_t)iRes<=ptSlot->ulDone){
+			ptSlot->bError=true;
+			ptSlot->iState=SLOT_CLOSE;
+			break;
+		}
+		ptSlot->ulDone=ulStart+(size_t)iRes;
+		if(ptSlot->ulDone>=ptSlot->ulSize){
+			if(ptReader->aiOrder || ptReader->bDirect!=ptSlot->bDirect)
+				ReaderAdvise(ptSlot->iFd,true);
+			ptSlot->iState=SLOT_CLOSE;
+		}
+		break;
+	default:
+		return true;
+	}
+	UringQueueSlot(ptRing,ptReader,iSlot);
+	return false;
+}
+
+
+
+/* after an error: reaps the completions of all submitted operations, the kernel writes into
+ * the buffers and file descriptors until then, and closes the files of the slots in flight.
+ * false if the ring fails, the buffers must not be freed then */
+static bool UringDrain(URING_T* ptRing, URING_READER_T* ptReader){
+	int i=0;
+
+	while(ptRing->uiPending>0){
+		unsigned uiHead=*ptRing->puiCqHead;
+		unsigned uiTail=__atomic_load_n(ptRing->puiCqTail,__ATOMIC_ACQUIRE);
+
+		if(uiHead==uiTail){
+			if(syscall(__NR_io_uring_enter,ptRing->iFd,0,1,IORING_ENTER_GETEVENTS,NULL,0)<0 && errno!=EINTR)
+				return false;
+			continue;
+		}
+		for(;uiHead!=uiTail;uiHead++){
+			struct io_uring_cqe* ptCqe=&ptRing->atCqe[uiHead&*ptRing->puiCqMask];
+			READ_SLOT_T* ptSlot=&ptReader->atSlot[(int)ptCqe->user_data];
+
+			if(ptSlot->iState==SLOT_OPEN && ptCqe->res>=0)
+				ptSlot->iFd=ptCqe->res;
+			else if(ptSlot->iState==SLOT_CLOSE)
+				ptSlot->iFd=-1;
+			ptRing->uiPending--;
+		}
+		__atomic_store_n(ptRing->puiCqHead,uiHead,__ATOMIC_RELEASE);
+	}
+	for(i=0;i<BATCH_READ_DEPTH;i++){
+		READ_SLOT_T* ptSlot=&ptReader->atSlot[i];
+		if(ptSlot->iState>=SLOT_OPEN && ptSlot->iState<=SLOT_CLOSE && ptSlot->iFd>=0)
+			close(ptSlot->iFd);
+	}
+	return true;
+}
+
+
+
+static void* UringParseWorker(void* pvArg){
+	URING_WORKER_T* ptWorker=(URING_WORKER_T*)pvArg;
+	URING_READER_T* ptReader=ptWorker->ptReader;
+
+	for(;;){
+		READ_SLOT_T* ptSlot=0;
+		int iSlot=0;
+
+		pthread_mutex_lock(&ptReader->tLock);
+		while(ptReader->iNumReady==0 && !ptReader->bDone)
+			pthread_cond_wait(&ptReader->tParse,&ptReader->tLock);
+		if(ptReader->iNumReady==0){
+			pthread_mutex_unlock(&ptReader->tLock);
+			break;
+		}
+		iSlot=ptReader->aiReady[ptReader->iReadyHead];
+		ptReader->iReadyHead=(ptReader->iReadyHead+1)%BATCH_READ_DEPTH;
+		ptReader->iNumReady--;
+		pthread_mutex_unlock(&ptReader->tLock);
+
+		ptSlot=&ptReader->atSlot[iSlot];
+		ptReader->fnParse(ptSlot->iJob,ptWorker->iWorker,ptSlot->bError ? NULL : ptSlot->pabData,ptReader->atRanges ? ptSlot->ulSize : ptSlot->ulDone,ptReader->pvContext);
+		ArenaReset(&ptReader->atArena[iSlot]);
+		ptSlot->pabData=0;
+
+		pthread_mutex_lock(&ptReader->tLock);
+		ptSlot->iState=SLOT_FREE;
+		ptReader->iNumFree++;
+		pthread_cond_signal(&ptReader->tFree);
+		pthread_mutex_unlock(&ptReader->tLock);
+	}
+	return NULL;
+}
+
+
+
+/* the calling thread drives the ring, iNumThreads parser threads take the read files */
+static int ReaderRunUring(URING_T* ptRing, char** aszFiles, const int* aiOrder, int iNumFiles, int iNumThreads, BATCH_RANGES_T* atRanges, BATCH_READ_FN fnParse, void* pvContext, BATCH_READ_STATS_T* ptStats){
+	URING_READER_T* ptReader=MemCalloc(1,sizeof(URING_READER_T));
+	URING_WORKER_T* atWorker=MemCalloc(iNumThreads,sizeof(URING_WORKER_T));
+	pthread_t* atThread=MemCalloc(iNumThreads,sizeof(pthread_t));
+	int iStarted=0;
+	int iInFlight=0;
+	int iNext=0;
+	int iRes=0;
+	bool bDrained=true;
+	int i=0;
+
+	if(ptReader==NULL || atWorker==NULL || atThread==NULL){
+		printf("error malloc\n");
+		free(ptReader);
+		free(atWorker);
+		free(atThread);
+		return EXIT_FAILURE;
+	}
+	ptReader->aszFiles=aszFiles;
+	ptReader->aiOrder=aiOrder;
+	ptReader->bDirect=s_bDirect && atRanges==NULL;
+	ptReader->atRanges=atRanges;
+	ptReader->fnParse=fnParse;
+	ptReader->pvContext=pvContext;
+	ptReader->iNumFree=BATCH_READ_DEPTH;
+	for(i=0;i<BATCH_READ_DEPTH;i++){
+		ArenaInit(&ptReader->atArena[i],ReaderBlockSize(atRanges,iNumFiles));
+	}
+	pthread_mutex_init(&ptReader->tLock,NULL);
+	pthread_cond_init(&ptReader->tParse,NULL);
+	pthread_cond_init(&ptReader->tFree,NULL);
+
+	for(i=0;i<iNumThreads;i++){
+		atWorker[i].ptReader=ptReader;
+		atWorker[i].iWorker=i;
+		if(pthread_create(&atThread[i],NULL,UringParseWorker,&atWorker[i]))
+			break;
+		iStarted++;
+	}
+	if(iStarted==0){
+		/* nobody would parse the files */
+		iRes=EXIT_FAILURE;
+		iNext=iNumFiles;
+	}
+
+	ptStats->szBackend="io_uring";
+	ptStats->iQueueDepth=HIL_MIN(BATCH_READ_DEPTH,iNumFiles);
+
+	while(iNext<iNumFiles || iInFlight>0){
+		unsigned uiHead=0;
+		unsigned uiTail=0;
+
+		/* start files on free slots, wait for a parsed slot if none is free and nothing is in flight */
+		pthread_mutex_lock(&ptReader->tLock);
+		while(iInFlight==0 && ptReader->iNumFree==0)
+			pthread_cond_wait(&ptReader->tFree,&ptReader->tLock);
+		for(i=0;i<BATCH_READ_DEPTH && iNext<iNumFiles && ptReader->iNumFree>0;i++){
+			READ_SLOT_T* ptSlot=&ptReader->atSlot[i];
+
+			if(ptSlot->iState!=SLOT_FREE)
+				continue;
+			memset(ptSlot,0,sizeof(READ_SLOT_T));
+			ptSlot->iJob=aiOrder ? aiOrder[iNext] : iNext;
+			iNext++;
+			ptSlot->iFd=-1;
+			if(atRanges!=NULL){
+				int j=0;
+				for(j=0;j<atRanges[ptSlot->iJob].iNumRanges;j++){
+					atRanges[ptSlot->iJob].atRange[j].ulRead=0;
+				}
+			}
+#ifdef O_DIRECT
+			ptSlot->bDirect=ptReader->bDirect;
+#endif
+			ptSlot->iState=SLOT_OPEN;
+			ptReader->iNumFree--;
+			UringQueueSlot(ptRing,ptReader,i);
+			iInFlight++;
+		}
+		pthread_mutex_unlock(&ptReader->tLock);
+
+		if(UringSubmitAndWait(ptRing,1)){
+			printf("error io_uring_enter\n");
+			iRes=EXIT_FAILURE;
+			bDrained=UringDrain(ptRing,ptReader);
+			break;
+		}
+
+		uiHead=*ptRing->puiCqHead;
+		uiTail=__atomic_load_n(ptRing->puiCqTail,__ATOMIC_ACQUIRE);
+		for(;uiHead!=uiTail;uiHead++){
+			struct io_uring_cqe* ptCqe=&ptRing->atCqe[uiHead&*ptRing->puiCqMask];
+			int iSlot=(int)ptCqe->user_data;
+			READ_SLOT_T* ptSlot=&ptReader->atSlot[iSlot];
+
+			ptStats->lOperations++;
+			ptRing->uiPending--;
+			if(!UringComplete(ptRing,ptReader,iSlot,ptCqe->res))
+				continue;
+
+			iInFlight--;
+			if(!ptSlot->bError && ptReader->bDirect && !ptSlot->bDirect)
+				ptStats->lBuffered++;
+			if(ptSlot->bError)
+				ptStats->lErrors++;
+			else
+				ptStats->ullBytes+=ptSlot->ulDone;
+			pthread_mutex_lock(&ptReader->tLock);
+			ptSlot->iState=SLOT_PARSE;
+			ptReader->aiReady[(ptReader->iReadyHead+ptReader->iNumReady)%BATCH_READ_DEPTH]=iSlot;
+			ptReader->iNumReady++;
+			pthread_cond_signal(&ptReader->tParse);
+			pthread_mutex_unlock(&ptReader->tLock);
+		}
+		__atomic_store_n(ptRing->puiCqHead,uiHead,__ATOMIC_RELEASE);
+	}
+
+	pthread_mutex_lock(&ptReader->tLock);
+	ptReader->bDone=true;
+	pthread_cond_broadcast(&ptReader->tParse);
+	pthread_mutex_unlock(&ptReader->tLock);
+	for(i=0;i<iStarted;i++){
+		pthread_join(atThread[i],NULL);
+	}
+
+	if(!bDrained){
+		/* operations may still write into the buffers, they are left to the process exit */
+		printf("error io_uring, %u operations not completed\n",ptRing->uiPending);
+		free(atWorker);
+		free(atThread);
+		return iRes;
+	}
+	for(i=0;i<BATCH_READ_DEPTH;i++){
+		ArenaFree(&ptReader->atArena[i]);
+	}
+	pthread_cond_destroy(&ptReader->tFree);
+	pthread_cond_destroy(&ptReader->tParse);
+	pthread_mutex_destroy(&ptReader->tLock);
+	free(ptReader);
+	free(atWorker);
+	free(atThread);
+	return iRes;
+}
+
+#endif
+
+
+
+/* files are read in the order of their data on the disk, for archives on rotating disks */
+void BatchReadSetPhysicalOrder(bool bPhysical){
+	s_bPhysicalOrder=bPhysical;
+}
+
+
+
+/* files bypass the page cache and are read into aligned buffers */
+void BatchReadSetDirect(bool bDirect){
+	s_bDirect=bDirect;
+}
+
+
+
+/* whole files or the ranges of atRanges, see BatchReadFiles */
+static int ReaderRun(char** aszFiles, int iNumFiles, int iNumThreads, BATCH_RANGES_T* atRanges, BATCH_READ_FN fnParse, void* pvContext){
+	BATCH_READ_STATS_T tStats;
+	int* aiOrder=0;
+	bool bExtents=false;
+	double dSeconds=0;
+	int iRes=EXIT_FAILURE;
+#ifdef BATCH_IO_URING
+	URING_T tRing;
+#endif
+
+	memset(&tStats,0,sizeof(tStats));
+	if(iNumThreads<1)
+		iNumThreads=BatchGetNumCpus();
+	tStats.llStart=ReaderNow();
+	tStats.szOrder="list";
+	if(s_bPhysicalOrder){
+		aiOrder=BatchOrderByPosition(aszFiles,iNumFiles,&bExtents);
+		if(aiOrder==NULL)
+			return EXIT_FAILURE;
+		tStats.szOrder=bExtents ? "physical, first extent" : "physical, inode";
+	}
+
+#ifdef BATCH_IO_URING
+	/* one submission entry per slot, a slot has one operation in flight */
+	if(iNumFiles>1 && UringSetup(&tRing,BATCH_READ_DEPTH)==0){
+		iRes=ReaderRunUring(&tRing,aszFiles,aiOrder,iNumFiles,iNumThreads,atRanges,fnParse,pvContext,&tStats);
+		UringClose(&tRing);
+	}
+	else {
+		iRes=ReaderRunThreads(aszFiles,aiOrder,iNumFiles,iNumThreads,atRanges,fnParse,pvContext,&tStats);
+	}
+#else
+	iRes=ReaderRunThreads(aszFiles,aiOrder,iNumFiles,iNumThreads,atRanges,fnParse,pvContext,&tStats);
+#endif
+
+	tStats.llEnd=ReaderNow();
+	free(aiOrder);
+	dSeconds=(double)(tStats.llEnd-tStats.llStart)/1e9;
+	if(dSeconds<=0)
+		dSeconds=1e-9;
+
+	printf("\n--------------------------------------\nBATCH READER\n");
+	printf("backend:        %s\n",tStats.szBackend);
+	printf("queue depth:    %d\n",tStats.iQueueDepth);
+	printf("order:          %s\n",tStats.szOrder);
+	if(s_bDirect && atRanges==NULL)
+		printf("direct I/O:     %ld files [%ld buffered, no direct I/O on the file system]\n",iNumFiles-(long)tStats.lErrors-(long)tStats.lBuffered,(long)tStats.lBuffered);
+	printf("files:          %d [%ld not readable]\n",iNumFiles,(long)tStats.lErrors);
+	printf("operations:     %ld [open, %sread, close]\n",(long)tStats.lOperations,atRanges ? "" : "size, ");
+	printf("IOPS:           %.0f\n",(double)tStats.lOperations/dSeconds);
+	printf("throughput:     %.1f MB/s\n",(double)tStats.ullBytes/(1024.0*1024.0)/dSeconds);
+	printf("--------------------------------------\n");
+	return iRes;
+}
+
+
+
+/* reads all files of the list and calls fnParse(iJob,iWorker,pabData,ulSize,pvContext) for each,
+ * pabData is NULL if the file could not be read, the buffer is reused after fnParse returns.
+ * iWorker is below iNumThreads. Prints the reader statistics. */
+int BatchReadFiles(char** aszFiles, int iNumFiles, int iNumThreads, BATCH_READ_FN fnParse, void* pvContext){
+	return ReaderRun(aszFiles,iNumFiles,iNumThreads,NULL,fnParse,pvContext);
+}
+
+
+
+/* like BatchReadFiles, but only the ranges atRanges[iJob] of each file are read, the parser
+ * gets them in one buffer of ulSize bytes, the sum of the range sizes, with ulRead of each range set */
+int BatchReadRanges(char** aszFiles, int iNumFiles, int iNumThreads, BATCH_RANGES_T* atRanges, BATCH_READ_FN fnParse, void* pvContext){
+	return ReaderRun(aszFiles,iNumFiles,iNumThreads,atRanges,fnParse,pvContext);
+}
@@ -0,0 +1,444 @@
+/*
+ * netXFileCheckerRecord.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  analysis result record: the fields printed by AnalyzeFDL and AnalyzeFHV3DeviceInfo
+ *  collected into one structure, used for batch summaries, the result cache and fleet checks
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+#include "Hil_FileHeaderV3.h"
+#include "Hil_DeviceProductionData.h"
+
+
+
+
+
+static void RecordFDL(const uint8_t* pabData, size_t ulDataSize, NETX_RECORD_T* ptRecord){
+	const HIL_PRODUCT_DATA_LABEL_T* ptFDL=(const HIL_PRODUCT_DATA_LABEL_T*)pabData;
+
+	if(ulDataSize<sizeof(HIL_PRODUCT_DATA_LABEL_T))
+		return;
+	if(memcmp(ptFDL->tHeader.abStartToken,HIL_PRODUCT_DATA_START_TOKEN,sizeof(ptFDL->tHeader.abStartToken))
+			|| memcmp(ptFDL->tFooter.abEndToken,HIL_PRODUCT_DATA_END_TOKEN,sizeof(ptFDL->tFooter.abEndToken)))
+		return;
+
+	ptRecord->ulFlags|=RECORD_FLAG_FDL_VALID;
+	if(ptFDL->tFooter.ulChecksum==PS_CRC32(0x00000000,(const uint8_t*)&ptFDL->tProductData,sizeof(HIL_PRODUCT_DATA_T))){
+		ptRecord->ulFlags|=RECORD_FLAG_FDL_CRC_OK;
+	}
+	ptRecord->tBasicDeviceData=ptFDL->tProductData.tBasicDeviceData;
+	ptRecord->tMACAddressesCom=ptFDL->tProductData.tMACAddressesCom;
+	ptRecord->tMACAddressesApp=ptFDL->tProductData.tMACAddressesApp;
+}
+
+
+
+/* boot header (NXF style or NAI style) followed by common header and device info */
+static void RecordFirmware(const uint8_t* pabData, size_t ulDataSize, bool bNai, NETX_FW_RECORD_T* ptFw){
+	const HIL_FILE_COMMON_HEADER_V3_0_T* ptCommonHeader=0;
+	const HIL_FILE_DEVICE_INFO_V1_0_T* ptDeviceInfo=0;
+	size_t ulOffset=0;
+
+	memset(ptFw,0xFF,sizeof(NETX_FW_RECORD_T));
+
+	if(bNai){
+		ulOffset=HBOOT_NAI_HEADER_OFFSET+sizeof(HIL_FILE_HBOOT_BOOT_HEADER_NAI_NAE_V1_0_T);
+		if(ulDataSize<ulOffset+sizeof(HIL_FILE_NAI_HEADER_V3_0_T))
+			return;
+		ptFw->ulCookie=((const HIL_FILE_BOOT_HEADER_NAI_NAE_V1_0_T*)&pabData[ulOffset])->ulMagicCookie;
+		ulOffset+=sizeof(HIL_FILE_BOOT_HEADER_NAI_NAE_V1_0_T);
+	}
+	else {
+		if(ulDataSize<sizeof(HIL_FILE_BOOT_HEADER_V1_0_T)+sizeof(HIL_FILE_COMMON_HEADER_V3_0_T)+sizeof(HIL_FILE_DEVICE_INFO_V1_0_T))
+			return;
+		ptFw->ulCookie=((const HIL_FILE_BOOT_HEADER_V1_0_T*)pabData)->ulMagicCookie;
+		ulOffset=sizeof(HIL_FILE_BOOT_HEADER_V1_0_T);
+	}
+
+	ptCommonHeader=(const HIL_FILE_COMMON_HEADER_V3_0_T*)&pabData[ulOffset];
+	ptDeviceInfo=(const HIL_FILE_DEVICE_INFO_V1_0_T*)&pabData[ulOffset+sizeof(HIL_FILE_COMMON_HEADER_V3_0_T)];
+
+	ptFw->ulHeaderCRC32=ptCommonHeader->ulHeaderCRC32;
+	ptFw->ulCommonCRC32=ptCommonHeader->ulCommonCRC32;
+	memcpy(ptFw->aulMD5,ptCommonHeader->aulMD5,sizeof(ptFw->aulMD5));
+
+	ptFw->usManufacturer=ptDeviceInfo->usManufacturer;
+	ptFw->usDeviceClass=ptDeviceInfo->usDeviceClass;
+	ptFw->bHwCompatibility=ptDeviceInfo->bHwCompatibility;
+	ptFw->bChipType=ptDeviceInfo->bChipType;
+	memcpy(ptFw->ausHwOptions,ptDeviceInfo->ausHwOptions,sizeof(ptFw->ausHwOptions));
+	ptFw->ulLicenseFlags1=ptDeviceInfo->ulLicenseFlags1;
+	ptFw->ulLicenseFlags2=ptDeviceInfo->ulLicenseFlags2;
+	ptFw->usNetXLicenseID=ptDeviceInfo->usNetXLicenseID;
+	ptFw->usNetXLicenseFlags=ptDeviceInfo->usNetXLicenseFlags;
+	memcpy(ptFw->ausFwVersion,ptDeviceInfo->ausFwVersion,sizeof(ptFw->ausFwVersion));
+	ptFw->ulFwNumber=ptDeviceInfo->ulFwNumber;
+	ptFw->ulDeviceNumber=ptDeviceInfo->ulDeviceNumber;
+	ptFw->ulSerialNumber=ptDeviceInfo->ulSerialNumber;
+}
+
+
+
+static void RecordDumpArea(const uint8_t* pabData, size_t ulDataSize, int iUseCase, char* szSuffix, NETX_FW_RECORD_T* ptFw){
+	uint32_t ulOffset=getOffset(iUseCase,szSuffix);
+	uint32_t ulLength=getLength(iUseCase,szSuffix);
+
+	if(ulLength==0 || ulOffset>=ulDataSize){
+		memset(ptFw,0xFF,sizeof(NETX_FW_RECORD_T));
+		return;
+	}
+	RecordFirmware(&pabData[ulOffset],HIL_MIN(ulLength,ulDataSize-ulOffset),false,ptFw);
+}
+
+
+
+/* firmware version as one number, one 16 bit field per version part, major first */
+uint64_t PackFwVersion(const uint16_t* ausFwVersion){
+	return ((uint64_t)ausFwVersion[0]<<48)|((uint64_t)ausFwVersion[1]<<32)|((uint64_t)ausFwVersion[2]<<16)|ausFwVersion[3];
+}
+
+
+
+/* version pattern like 2.3.x, x matches any value, missing trailing parts match any value
+ * result is the packed version and the mask of the given parts */
+int ParseVersionPattern(const char* szPattern, uint64_t* pullValue, uint64_t* pullMask){
+	char* szEnd=0;
+	int i=0;
+
+	*pullValue=0;
+	*pullMask=0;
+	for(i=0;i<4 && *szPattern;i++){
+		if(*szPattern=='x' || *szPattern=='*'){
+			szPattern++;
+		}
+		else {
+			unsigned long ulPart=strtoul(szPattern,&szEnd,0);
+			if(szEnd==szPattern || ulPart>0xFFFF)
+				return EXIT_FAILURE;
+			*pullValue|=(uint64_t)ulPart<<(48-16*i);
+			*pullMask|=(uint64_t)0xFFFF<<(48-16*i);
+			szPattern=szEnd;
+		}
+		if(*szPattern=='.' && i<3)
+			szPattern++;
+		else if(*szPattern)
+			return EXIT_FAILURE;
+	}
+	return 0;
+}
+
+
+
+static void RecordInit(FILE_TYPE_E eFileType, int iUseCase, size_t ulDataSize, NETX_RECORD_T* ptRecord){
+	int i=0;
+
+	memset(ptRecord,0,sizeof(NETX_RECORD_T));
+	ptRecord->ulFileType=eFileType;
+	ptRecord->ulUseCase=iUseCase;
+	ptRecord->ulFileSize=(uint32_t)ulDataSize;
+
+	memset(&ptRecord->tBasicDeviceData,0xFF,sizeof(ptRecord->tBasicDeviceData));
+	memset(&ptRecord->tMACAddressesCom,0xFF,sizeof(ptRecord->tMACAddressesCom));
+	memset(&ptRecord->tMACAddressesApp,0xFF,sizeof(ptRecord->tMACAddressesApp));
+	for(i=0;i<RECORD_FW_NUM;i++){
+		memset(&ptRecord->atFw[i],0xFF,sizeof(NETX_FW_RECORD_T));
+	}
+}
+
+
+
+/* fills the record, unused parts are set to 0xFF like erased flash,
+ * abSha256 is the content hash if the caller has it already, NULL otherwise */
+static void RecordBuild(const uint8_t* pabData, size_t ulDataSize, const uint8_t* abSha256, FILE_TYPE_E eFileType, int iUseCase, NETX_RECORD_T* ptRecord){
+	RecordInit(eFileType,iUseCase,ulDataSize,ptRecord);
+	if(abSha256!=NULL)
+		memcpy(ptRecord->abSha256,abSha256,SHA256_DIGEST_SIZE);
+	else
+		Sha256(pabData,ulDataSize,ptRecord->abSha256);
+
+	switch(eFileType){
+	case FILETYPE_FLASHDUMP:
+		RecordFDL(&pabData[HIL_MIN(getOffset(iUseCase,".fdl"),ulDataSize)],ulDataSize-HIL_MIN(getOffset(iUseCase,".fdl"),ulDataSize),ptRecord);
+		RecordDumpArea(pabData,ulDataSize,iUseCase,".nxi",&ptRecord->atFw[RECORD_FW_COM]);
+		RecordDumpArea(pabData,ulDataSize,iUseCase,".upd",&ptRecord->atFw[RECORD_FW_UPD]);
+		RecordDumpArea(pabData,ulDataSize,iUseCase,".mxf",&ptRecord->atFw[RECORD_FW_MXF]);
+		break;
+
+	case FILETYPE_FDL:
+		RecordFDL(pabData,ulDataSize,ptRecord);
+		break;
+
+	case FILETYPE_NXF:
+	case FILETYPE_NXI:
+	case FILETYPE_NXE:
+	case FILETYPE_UPD:
+		RecordFirmware(pabData,ulDataSize,false,&ptRecord->atFw[RECORD_FW_COM]);
+		break;
+
+	case FILETYPE_MXF:
+		RecordFirmware(pabData,ulDataSize,false,&ptRecord->atFw[RECORD_FW_MXF]);
+		break;
+
+	case FILETYPE_NAI:
+		RecordFirmware(pabData,ulDataSize,true,&ptRecord->atFw[RECORD_FW_NAI]);
+		break;
+
+	case FILETYPE_NAE:
+		RecordFirmware(pabData,ulDataSize,false,&ptRecord->atFw[RECORD_FW_NAI]);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void BuildRecord(const uint8_t* pabData, size_t ulDataSize, FILE_TYPE_E eFileType, int iUseCase, NETX_RECORD_T* ptRecord){
+	RecordBuild(pabData,ulDataSize,NULL,eFileType,iUseCase,ptRecord);
+}
+
+
+
+/* record of a file of which only the header fragments were read, the fragments of a flash dump
+ * are the areas named by szSuffix, any other file has one fragment at offset 0.
+ * file size and content hash stay 0 */
+void BuildFragmentRecord(const RECORD_FRAGMENT_T* atFragment, int iNumFragments, FILE_TYPE_E eFileType, int iUseCase, NETX_RECORD_T* ptRecord){
+	int i=0;
+
+	RecordInit(eFileType,iUseCase,0,ptRecord);
+	if(eFileType!=FILETYPE_FLASHDUMP){
+		if(iNumFragments>0){
+			BuildRecord(atFragment[0].pabData,atFragment[0].ulSize,eFileType,iUseCase,ptRecord);
+			memset(ptRecord->abSha256,0,sizeof(ptRecord->abSha256));
+			ptRecord->ulFileSize=0;
+		}
+		return;
+	}
+
+	for(i=0;i<iNumFragments;i++){
+		const RECORD_FRAGMENT_T* ptFragment=&atFragment[i];
+
+		if(0==strcmp(ptFragment->szSuffix,".fdl"))
+			RecordFDL(ptFragment->pabData,ptFragment->ulSize,ptRecord);
+		else if(0==strcmp(ptFragment->szSuffix,".nxi"))
+			RecordFirmware(ptFragment->pabData,ptFragment->ulSize,false,&ptRecord->atFw[RECORD_FW_COM]);
+		else if(0==strcmp(ptFragment->szSuffix,".upd"))
+			RecordFirmware(ptFragment->pabData,ptFragment->ulSize,false,&ptRecord->atFw[RECORD_FW_UPD]);
+		else if(0==strcmp(ptFragment->szSuffix,".mxf"))
+			RecordFirmware(ptFragment->pabData,ptFragment->ulSize,false,&ptRecord->atFw[RECORD_FW_MXF]);
+	}
+}
+
+
+
+static void PrintFwSummary(const char* szName, const NETX_FW_RECORD_T* ptFw){
+	if(ptFw->ulCookie==0xFFFFFFFF){
+		return;
+	}
+	if(0==strcmp(LookupCode(ptFw->ulCookie),"Unknown code")){
+		printf("  %s ?",szName);
+		return;
+	}
+	printf("  %s %d.%d.%d.%d #%d",szName,ptFw->ausFwVersion[0],ptFw->ausFwVersion[1],ptFw->ausFwVersion[2],ptFw->ausFwVersion[3],ptFw->ulFwNumber);
+}
+
+
+
+/* one line per file for batch runs, without line end so callers can append */
+void PrintRecordSummary(const char* szFilename, const NETX_RECORD_T* ptRecord){
+	printf("%s",szFilename);
+
+	if(ptRecord->ulFlags&RECORD_FLAG_LOAD_ERROR){
+		printf("  error reading file");
+		return;
+	}
+
+	if(ptRecord->ulFlags&RECORD_FLAG_FDL_VALID){
+		printf("  FDL %d/%d hw 0x%02x%s",ptRecord->tBasicDeviceData.ulDeviceNumber,ptRecord->tBasicDeviceData.ulSerialNumber
+				,ptRecord->tBasicDeviceData.bHwRevision,(ptRecord->ulFlags&RECORD_FLAG_FDL_CRC_OK)?"":" CRC error");
+	}
+	else if(ptRecord->ulFileType==FILETYPE_FLASHDUMP || ptRecord->ulFileType==FILETYPE_FDL){
+		printf("  FDL invalid");
+	}
+
+	switch(ptRecord->ulFileType){
+	case FILETYPE_NXF:
+		PrintFwSummary("NXF",&ptRecord->atFw[RECORD_FW_COM]);
+		break;
+	case FILETYPE_UPD:
+		PrintFwSummary("UPD",&ptRecord->atFw[RECORD_FW_COM]);
+		break;
+	default:
+		PrintFwSummary("NXI",&ptRecord->atFw[RECORD_FW_COM]);
+		break;
+	}
+	PrintFwSummary("UPD",&ptRecord->atFw[RECORD_FW_UPD]);
+	PrintFwSummary("MXF",&ptRecord->atFw[RECORD_FW_MXF]);
+	PrintFwSummary("NAI",&ptRecord->atFw[RECORD_FW_NAI]);
+}
+
+
+
+typedef struct BATCH_RECORD_CONTEXT_Ttag {
+	char** aszFiles;
+	int iUseCase;
+	RESULT_CACHE_T* ptCache;
+	NETX_RECORD_T* atRecord;
+	bool* abCached;
+} BATCH_RECORD_CONTEXT_T;
+
+
+
+/* record of one file, looked up in the cache if given, returns true for a cache hit */
+bool RecordFile(RESULT_CACHE_T* ptCache, char* szFilename, int iUseCase, NETX_RECORD_T* ptRecord){
+	FILE_ID_T tId;
+	bool bId=false;
+	bool bCached=false;
+	FILE_TYPE_E eFileType=GetFileType(szFilename);
+	uint8_t* pabData=0;
+	size_t ulDataSize=0;
+	uint8_t abSha256[SHA256_DIGEST_SIZE];
+
+	if(ptCache){
+		bId=(0==GetFileId(szFilename,&tId));
+		if(bId && CacheLookupId(ptCache,&tId,eFileType,iUseCase,ptRecord)){
+			return true;
+		}
+	}
+
+	pabData=LoadFile(szFilename,&ulDataSize);
+	if(pabData==NULL){
+		memset(ptRecord,0xFF,sizeof(NETX_RECORD_T));
+		ptRecord->ulFlags=RECORD_FLAG_LOAD_ERROR;
+		return false;
+	}
+
+	if(ptCache){
+		Sha256(pabData,ulDataSize,abSha256);
+		bCached=CacheLookupHash(ptCache,abSha256,eFileType,iUseCase,ptRecord);
+		if(!bCached){
+			RecordBuild(pabData,ulDataSize,abSha256,eFileType,iUseCase,ptRecord);
+		}
+		/* store the current identity, a copied or touched file is found by identity next time */
+		if(bId){
+			CacheInsert(ptCache,&tId,ptRecord);
+		}
+	}
+	else {
+		RecordBuild(pabData,ulDataSize,NULL,eFileType,iUseCase,ptRecord);
+	}
+	free(pabData);
+	return bCached;
+}
+
+
+
+static void RecordJob(int iJob, int iWorker, void* pvContext){
+	BATCH_RECORD_CONTEXT_T* ptCtx=(BATCH_RECORD_CONTEXT_T*)pvContext;
+	bool bCached=RecordFile(ptCtx->ptCache,ptCtx->aszFiles[iJob],ptCtx->iUseCase,&ptCtx->atRecord[iJob]);
+
+	(void)iWorker;
+	if(ptCtx->abCached)
+		ptCtx->abCached[iJob]=bCached;
+}
+
+
+
+/* record of a file read by the batch reader */
+static void RecordParse(int iJob, int iWorker, const uint8_t* pabData, size_t ulSize, void* pvContext){
+	BATCH_RECORD_CONTEXT_T* ptCtx=(BATCH_RECORD_CONTEXT_T*)pvContext;
+	NETX_RECORD_T* ptRecord=&ptCtx->atRecord[iJob];
+
+	(void)iWorker;
+	if(pabData==NULL){
+		printf("error reading file %s\n",ptCtx->aszFiles[iJob]);
+		memset(ptRecord,0xFF,sizeof(NETX_RECORD_T));
+		ptRecord->ulFlags=RECORD_FLAG_LOAD_ERROR;
+		return;
+	}
+	BuildRecord(pabData,ulSize,GetFileType(ptCtx->aszFiles[iJob]),ptCtx->iUseCase,ptRecord);
+}
+
+
+
+/* fills atRecord[i] for aszFiles[i] on iNumThreads workers, records are reused from the cache file if given,
+ * abCached may be NULL */
+int CollectRecords(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads, char* szCacheFilename, NETX_RECORD_T* atRecord, bool* abCached){
+	int i=0;
+	BATCH_RECORD_CONTEXT_T tCtx;
+
+	memset(&tCtx,0,sizeof(tCtx));
+	tCtx.aszFiles=aszFiles;
+	tCtx.iUseCase=iUseCase;
+	tCtx.atRecord=atRecord;
+	tCtx.abCached=abCached;
+
+	for(i=0;i<iNumFiles;i++){
+		FILE_TYPE_E eFileType=GetFileType(aszFiles[i]);
+		if(eFileType==FILETYPE_UNKNOWN || eFileType==FILETYPE_LIST || eFileType==FILETYPE_MANIFEST || eFileType==FILETYPE_INDEX){
+			printf("Error: unsupported file %s\n",aszFiles[i]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if(iNumThreads<1)
+		iNumThreads=BatchGetNumCpus();
+
+	/* without cache every file is read, the batch reader keeps many reads in flight */
+	if(szCacheFilename==NULL){
+		return BatchReadFiles(aszFiles,iNumFiles,iNumThreads,RecordParse,&tCtx);
+	}
+
+	tCtx.ptCache=CacheOpen(szCacheFilename);
+	if(tCtx.ptCache==NULL)
+		return EXIT_FAILURE;
+	BatchRun(iNumFiles,iNumThreads,RecordJob,&tCtx);
+
+	return CacheClose(tCtx.ptCache);
+}
+
+
+
+/* one summary line per file in list order */
+int AnalyzeBatch(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads, char* szCacheFilename){
+	int i=0;
+	int iErrors=0;
+	NETX_RECORD_T* atRecord=0;
+	bool* abCached=0;
+
+	atRecord=MemCalloc(iNumFiles,sizeof(NETX_RECORD_T));
+	abCached=MemCalloc(iNumFiles,sizeof(bool));
+	if(atRecord==NULL || abCached==NULL){
+		printf("error malloc\n");
+		free(atRecord);
+		free(abCached);
+		return EXIT_FAILURE;
+	}
+
+	if(CollectRecords(aszFiles,iNumFiles,iUseCase,iNumThreads,szCacheFilename,atRecord,abCached)){
+		iErrors++;
+	}
+	else {
+		printf("\n--------------------------------------\nBATCH SUMMARY\n");
+		printf("--------------------------------------\n");
+		for(i=0;i<iNumFiles;i++){
+			PrintRecordSummary(aszFiles[i],&atRecord[i]);
+			printf("%s\n",abCached[i]?"  [cached]":"");
+			if(atRecord[i].ulFlags&RECORD_FLAG_LOAD_ERROR)
+				iErrors++;
+		}
+		printf("\n%d files, %d errors\n",iNumFiles,iErrors);
+	}
+
+	free(atRecord);
+	free(abCached);
+	return iErrors ? EXIT_FAILURE : 0;
+}
+
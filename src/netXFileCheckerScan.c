@@ -0,0 +1,191 @@
+/*
+ * netXFileCheckerScan.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  block compare and erased flash (0xFF) scan helpers used by diff, compliance and fill level analysis,
+ *  SSE2 is used when the compiler provides it, plain C otherwise
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SCAN_USE_SSE2
+#endif
+
+#include "netXFileChecker.h"
+
+
+
+/* returns true if both blocks of ulSize bytes are identical */
+bool BlockEqual(const uint8_t* pabA, const uint8_t* pabB, uint32_t ulSize){
+	uint32_t ulPos=0;
+
+#ifdef SCAN_USE_SSE2
+	/* 64 bytes per round, differences are or-ed up and checked once per round */
+	for(;ulPos+64<=ulSize;ulPos+=64){
+		__m128i tDiff0=_mm_xor_si128(_mm_loadu_si128((const __m128i*)(pabA+ulPos+ 0)),_mm_loadu_si128((const __m128i*)(pabB+ulPos+ 0)));
+		__m128i tDiff1=_mm_xor_si128(_mm_loadu_si128((const __m128i*)(pabA+ulPos+16)),_mm_loadu_si128((const __m128i*)(pabB+ulPos+16)));
+		__m128i tDiff2=_mm_xor_si128(_mm_loadu_si128((const __m128i*)(pabA+ulPos+32)),_mm_loadu_si128((const __m128i*)(pabB+ulPos+32)));
+		__m128i tDiff3=_mm_xor_si128(_mm_loadu_si128((const __m128i*)(pabA+ulPos+48)),_mm_loadu_si128((const __m128i*)(pabB+ulPos+48)));
+		__m128i tDiff=_mm_or_si128(_mm_or_si128(tDiff0,tDiff1),_mm_or_si128(tDiff2,tDiff3));
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(tDiff,_mm_setzero_si128()))!=0xFFFF){
+			return false;
+		}
+	}
+#endif
+
+	return 0==memcmp(pabA+ulPos,pabB+ulPos,ulSize-ulPos);
+}
+
+
+
+/* BlockEqual that also tells in the same pass whether the identical blocks are erased (0xFF) */
+bool BlockEqualErased(const uint8_t* pabA, const uint8_t* pabB, uint32_t ulSize, bool* pbErased){
+	uint32_t ulPos=0;
+	bool bErased=true;
+
+	*pbErased=false;
+#ifdef SCAN_USE_SSE2
+	{
+		__m128i tAnd=_mm_set1_epi8((char)0xFF);
+
+		for(;ulPos+64<=ulSize;ulPos+=64){
+			__m128i tA0=_mm_loadu_si128((const __m128i*)(pabA+ulPos+ 0));
+			__m128i tA1=_mm_loadu_si128((const __m128i*)(pabA+ulPos+16));
+			__m128i tA2=_mm_loadu_si128((const __m128i*)(pabA+ulPos+32));
+			__m128i tA3=_mm_loadu_si128((const __m128i*)(pabA+ulPos+48));
+			__m128i tDiff=_mm_or_si128(
+					_mm_or_si128(_mm_xor_si128(tA0,_mm_loadu_si128((const __m128i*)(pabB+ulPos+ 0))),_mm_xor_si128(tA1,_mm_loadu_si128((const __m128i*)(pabB+ulPos+16)))),
+					_mm_or_si128(_mm_xor_si128(tA2,_mm_loadu_si128((const __m128i*)(pabB+ulPos+32))),_mm_xor_si128(tA3,_mm_loadu_si128((const __m128i*)(pabB+ulPos+48)))));
+			if(_mm_movemask_epi8(_mm_cmpeq_epi8(tDiff,_mm_setzero_si128()))!=0xFFFF){
+				return false;
+			}
+			/* the blocks are equal so far, erased A means erased B */
+			tAnd=_mm_and_si128(tAnd,_mm_and_si128(_mm_and_si128(tA0,tA1),_mm_and_si128(tA2,tA3)));
+		}
+		bErased=_mm_movemask_epi8(_mm_cmpeq_epi8(tAnd,_mm_set1_epi8((char)0xFF)))==0xFFFF;
+	}
+#endif
+
+	for(;ulPos<ulSize;ulPos++){
+		if(pabA[ulPos]!=pabB[ulPos])
+			return false;
+		if(pabA[ulPos]!=0xFF)
+			bErased=false;
+	}
+	*pbErased=bErased;
+	return true;
+}
+
+
+
+/* returns the offset of the first differing byte, or ulSize if both blocks are identical */
+uint32_t BlockFirstMismatch(const uint8_t* pabA, const uint8_t* pabB, uint32_t ulSize){
+	uint32_t ulPos=0;
+
+#ifdef SCAN_USE_SSE2
+	for(;ulPos+64<=ulSize;ulPos+=64){
+		if(!BlockEqual(pabA+ulPos,pabB+ulPos,64)){
+			break;
+		}
+	}
+	for(;ulPos+16<=ulSize;ulPos+=16){
+		int iMask=_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(pabA+ulPos)),_mm_loadu_si128((const __m128i*)(pabB+ulPos))));
+		if(iMask!=0xFFFF){
+			/* first zero bit of the equal mask is the first differing byte */
+			int iBit=0;
+			iMask=~iMask;
+			while(!(iMask&1)){
+				iMask>>=1;
+				iBit++;
+			}
+			return ulPos+iBit;
+		}
+	}
+#endif
+
+	for(;ulPos<ulSize;ulPos++){
+		if(pabA[ulPos]!=pabB[ulPos])
+			return ulPos;
+	}
+	return ulSize;
+}
+
+
+
+/* returns true if all bytes of the block are erased (0xFF) */
+bool BlockErased(const uint8_t* pab, uint32_t ulSize){
+	uint32_t ulPos=0;
+
+#ifdef SCAN_USE_SSE2
+	for(;ulPos+64<=ulSize;ulPos+=64){
+		__m128i tAnd=_mm_and_si128(
+				_mm_and_si128(_mm_loadu_si128((const __m128i*)(pab+ulPos+ 0)),_mm_loadu_si128((const __m128i*)(pab+ulPos+16))),
+				_mm_and_si128(_mm_loadu_si128((const __m128i*)(pab+ulPos+32)),_mm_loadu_si128((const __m128i*)(pab+ulPos+48))));
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(tAnd,_mm_set1_epi8((char)0xFF)))!=0xFFFF){
+			return false;
+		}
+	}
+#endif
+
+	for(;ulPos<ulSize;ulPos++){
+		if(pab[ulPos]!=0xFF)
+			return false;
+	}
+	return true;
+}
+
+
+
+/* returns the offset behind the last programmed (not 0xFF) byte, 0 if the block is erased */
+uint32_t BlockWrittenEnd(const uint8_t* pab, uint32_t ulSize){
+	uint32_t ulEnd=ulSize;
+
+	/* unaligned tail first, then 16 bytes per step from the end */
+	while(ulEnd%16){
+		if(pab[ulEnd-1]!=0xFF)
+			return ulEnd;
+		ulEnd--;
+	}
+
+#ifdef SCAN_USE_SSE2
+	while(ulEnd){
+		int iMask=_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(pab+ulEnd-16)),_mm_set1_epi8((char)0xFF)));
+		if(iMask!=0xFFFF){
+			/* highest zero bit of the erased mask is the last programmed byte */
+			int iBit=15;
+			while(iMask&(1<<iBit)){
+				iBit--;
+			}
+			return ulEnd-16+iBit+1;
+		}
+		ulEnd-=16;
+	}
+#else
+	while(ulEnd){
+		if(pab[ulEnd-1]!=0xFF)
+			return ulEnd;
+		ulEnd--;
+	}
+#endif
+
+	return 0;
+}
+
+
+
+/* classifies a sector: erased, programmed up to the end or programmed with an erased tail */
+uint8_t GetSectorState(const uint8_t* pab, uint32_t ulSize){
+	uint32_t ulEnd=BlockWrittenEnd(pab,ulSize);
+
+	if(ulEnd==0)
+		return SECTOR_ERASED;
+	/* the last flash word is programmed, the sector is used up to its end */
+	if(ulEnd+FLASH_WORD_SIZE>ulSize)
+		return SECTOR_USED;
+	return SECTOR_PARTIAL;
+}
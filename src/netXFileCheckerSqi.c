@@ -0,0 +1,663 @@
+/*
+ * netXFileCheckerSqi.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  SQI flash dump analysis (tSQIDumpFile)
+ *  use case B holds the update area, use case C the FAT file system, remanent data
+ *  and its management area. The remanent data is not analyzed.
+ *  Only the boot sector, the FATs and the directories of the FAT area are read, they form
+ *  an index of all files with their cluster chains. Each cluster belongs to one file or
+ *  directory, a cluster reached twice is cross-linked. The files are then hashed on the
+ *  batch workers, streamed from the dump in runs of contiguous clusters, so the area is
+ *  never loaded as a whole.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+
+
+#define SQI_READ_SIZE       0x10000    // largest run of contiguous clusters read at once
+#define SQI_DIR_ENTRY_SIZE  32
+#define SQI_MAX_NAME        256
+
+#define SQI_FAT_FREE        0x00000000
+#define SQI_FAT_BAD         0xFFFFFFF7 // decoded FAT entries, 12 and 16 bit values are extended
+#define SQI_FAT_EOC         0xFFFFFFF8
+
+#define SQI_ATTR_VOLUME     0x08
+#define SQI_ATTR_DIRECTORY  0x10
+#define SQI_ATTR_LFN        0x0F
+
+#define SQI_FILE_OK         0
+#define SQI_FILE_FREE       1 // free cluster in the chain
+#define SQI_FILE_BAD        2 // bad cluster in the chain
+#define SQI_FILE_RANGE      3 // cluster number outside the area
+#define SQI_FILE_CROSS      4 // cluster used twice
+#define SQI_FILE_SIZE       5 // file size does not match the chain length
+#define SQI_FILE_READ       6
+
+static const char* s_aszSqiFileState[]={
+	"OK",
+	"ERROR free cluster in chain",
+	"ERROR bad cluster in chain",
+	"ERROR cluster out of range",
+	"ERROR cross-linked",
+	"ERROR size does not match the chain",
+	"ERROR read",
+};
+
+typedef struct SQI_FAT_ENTRY_Ttag {
+	char szPath[BATCH_MAX_PATH];
+	uint32_t ulFirstCluster;
+	uint32_t ulSize;
+	uint32_t ulNumClusters;
+	uint8_t bAttr;
+	int iState;
+	uint8_t abSha256[SHA256_DIGEST_SIZE];
+} SQI_FAT_ENTRY_T;
+
+typedef struct SQI_FAT_Ttag {
+	char* szFilename;
+	uint32_t ulBase;             // offset of the FAT area in the dump
+	uint32_t ulClusterSize;
+	uint32_t ulFatOffset;        // offsets relative to ulBase
+	uint32_t ulFatSize;          // bytes per FAT
+	uint32_t ulNumFats;
+	uint32_t ulRootOffset;       // FAT12/16 root directory
+	uint32_t ulRootEntries;
+	uint32_t ulRootCluster;      // FAT32 root directory
+	uint32_t ulDataOffset;
+	uint32_t ulNumClusters;      // clusters 2 .. ulNumClusters+1
+	int iFatBits;
+	bool bFatsEqual;
+	uint32_t* aulFat;            // decoded FAT entries
+	int32_t* alOwner;            // entry owning a cluster, -1 for none
+	SQI_FAT_ENTRY_T* atEntry;
+	int iNumEntries;
+	int iMaxEntries;
+	FILE** ahFile;               // read handle per worker
+} SQI_FAT_T;
+
+
+
+static uint16_t SqiReadWord(const uint8_t* pab){
+	return (uint16_t)(pab[0]|(pab[1]<<8));
+}
+
+static uint32_t SqiReadDword(const uint8_t* pab){
+	return (uint32_t)pab[0]|((uint32_t)pab[1]<<8)|((uint32_t)pab[2]<<16)|((uint32_t)pab[3]<<24);
+}
+
+
+
+static bool SqiRead(FILE* hFile, uint32_t ulOffset, void* pvBuffer, uint32_t ulSize){
+	if(fseek(hFile,ulOffset,SEEK_SET))
+		return false;
+	return fread(pvBuffer,1,ulSize,hFile)==ulSize;
+}
+
+
+
+static bool SqiIsDataCluster(const SQI_FAT_T* ptFat, uint32_t ulCluster){
+	return ulCluster>=2 && ulCluster<ptFat->ulNumClusters+2;
+}
+
+
+
+/* parses the boot sector, returns false if there is no FAT file system */
+static bool SqiParseBootSector(SQI_FAT_T* ptFat, const uint8_t* abBoot, uint32_t ulAreaSize){
+	uint32_t ulBytesPerSector=SqiReadWord(&abBoot[11]);
+	uint32_t ulSectorsPerCluster=abBoot[13];
+	uint32_t ulReserved=SqiReadWord(&abBoot[14]);
+	uint32_t ulTotalSectors=SqiReadWord(&abBoot[19]);
+	uint32_t ulFatSectors=SqiReadWord(&abBoot[22]);
+	uint32_t ulRootSectors=0;
+	uint32_t ulDataSectors=0;
+	uint64_t ullFatSize=0;
+
+	if(abBoot[510]!=0x55 || abBoot[511]!=0xAA)
+		return false;
+	if(ulBytesPerSector<512 || ulBytesPerSector>4096 || (ulBytesPerSector&(ulBytesPerSector-1)))
+		return false;
+	if(ulSectorsPerCluster==0 || (ulSectorsPerCluster&(ulSectorsPerCluster-1)) || ulReserved==0)
+		return false;
+
+	ptFat->ulNumFats=abBoot[16];
+	ptFat->ulRootEntries=SqiReadWord(&abBoot[17]);
+	if(ulTotalSectors==0)
+		ulTotalSectors=SqiReadDword(&abBoot[32]);
+	if(ulFatSectors==0){
+		ulFatSectors=SqiReadDword(&abBoot[36]);
+		ptFat->ulRootCluster=SqiReadDword(&abBoot[44]);
+	}
+	if(ptFat->ulNumFats==0 || ulFatSectors==0)
+		return false;
+	ulTotalSectors=HIL_MIN(ulTotalSectors,ulAreaSize/ulBytesPerSector);
+
+	ulRootSectors=(ptFat->ulRootEntries*SQI_DIR_ENTRY_SIZE+ulBytesPerSector-1)/ulBytesPerSector;
+	ptFat->ulClusterSize=ulBytesPerSector*ulSectorsPerCluster;
+	ptFat->ulFatOffset=ulReserved*ulBytesPerSector;
+	/* all FAT copies lie inside the area, so the offsets behind them fit into 32 bits */
+	ullFatSize=(uint64_t)ulFatSectors*ulBytesPerSector;
+	if(ptFat->ulFatOffset+ptFat->ulNumFats*ullFatSize>ulAreaSize)
+		return false;
+	ptFat->ulFatSize=(uint32_t)ullFatSize;
+	ptFat->ulRootOffset=ptFat->ulFatOffset+ptFat->ulNumFats*ptFat->ulFatSize;
+	ptFat->ulDataOffset=ptFat->ulRootOffset+ulRootSectors*ulBytesPerSector;
+	if((uint64_t)ptFat->ulDataOffset>=(uint64_t)ulTotalSectors*ulBytesPerSector)
+		return false;
+	ulDataSectors=ulTotalSectors-ptFat->ulDataOffset/ulBytesPerSector;
+	ptFat->ulNumClusters=ulDataSectors/ulSectorsPerCluster;
+
+	if(ptFat->ulNumClusters<4085)
+		ptFat->iFatBits=12;
+	else if(ptFat->ulNumClusters<65525)
+		ptFat->iFatBits=16;
+	else
+		ptFat->iFatBits=32;
+
+	/* clusters the FAT has no entries for are not usable */
+	ptFat->ulNumClusters=HIL_MIN(ptFat->ulNumClusters,(uint32_t)((uint64_t)ptFat->ulFatSize*8/ptFat->iFatBits)-2);
+	return true;
+}
+
+
+
+/* reads all FAT copies, decodes the first one */
+static bool SqiLoadFat(SQI_FAT_T* ptFat, FILE* hFile){
+	uint8_t* abFat=MemAlloc(ptFat->ulFatSize);
+	uint8_t* abCopy=MemAlloc(ptFat->ulFatSize);
+	uint32_t ulEntries=ptFat->ulNumClusters+2;
+	uint32_t i=0;
+	bool bOk=false;
+
+	ptFat->aulFat=MemAlloc(ulEntries*sizeof(uint32_t));
+	ptFat->alOwner=MemAlloc(ulEntries*sizeof(int32_t));
+	if(abFat==NULL || abCopy==NULL || ptFat->aulFat==NULL || ptFat->alOwner==NULL){
+		printf("error malloc\n");
+	}
+	else if(SqiRead(hFile,ptFat->ulBase+ptFat->ulFatOffset,abFat,ptFat->ulFatSize)){
+		bOk=true;
+		ptFat->bFatsEqual=true;
+		for(i=1;i<ptFat->ulNumFats;i++){
+			if(!SqiRead(hFile,ptFat->ulBase+ptFat->ulFatOffset+i*ptFat->ulFatSize,abCopy,ptFat->ulFatSize)
+					|| !BlockEqual(abFat,abCopy,ptFat->ulFatSize))
+				ptFat->bFatsEqual=false;
+		}
+		for(i=0;i<ulEntries;i++){
+			uint32_t ulEntry=0;
+			uint32_t ulBad=0;
+
+			switch(ptFat->iFatBits){
+			case 12:
+				ulEntry=SqiReadWord(&abFat[i+i/2]);
+				ulEntry=(i&1) ? ulEntry>>4 : ulEntry&0x0FFF;
+				ulBad=0x0FF7;
+				break;
+			case 16:
+				ulEntry=SqiReadWord(&abFat[i*2]);
+				ulBad=0xFFF7;
+				break;
+			default:
+				ulEntry=SqiReadDword(&abFat[i*4])&0x0FFFFFFF;
+				ulBad=0x0FFFFFF7;
+				break;
+			}
+			if(ulEntry==ulBad)
+				ulEntry=SQI_FAT_BAD;
+			else if(ulEntry>ulBad)
+				ulEntry=SQI_FAT_EOC;
+			ptFat->aulFat[i]=ulEntry;
+			ptFat->alOwner[i]=-1;
+		}
+	}
+	else {
+		printf("error reading FAT\n");
+	}
+	free(abFat);
+	free(abCopy);
+	return bOk;
+}
+
+
+
+/* follows the cluster chain of an entry and claims its clusters */
+static int SqiWalkChain(SQI_FAT_T* ptFat, int iEntry){
+	SQI_FAT_ENTRY_T* ptEntry=&ptFat->atEntry[iEntry];
+	uint32_t ulCluster=ptEntry->ulFirstCluster;
+
+	ptEntry->ulNumClusters=0;
+	if(ulCluster==0)
+		return SQI_FILE_OK;
+
+	for(;;){
+		if(!SqiIsDataCluster(ptFat,ulCluster))
+			return SQI_FILE_RANGE;
+		if(ptFat->alOwner[ulCluster]>=0)
+			return SQI_FILE_CROSS;
+		ptFat->alOwner[ulCluster]=iEntry;
+		ptEntry->ulNumClusters++;
+		ulCluster=ptFat->aulFat[ulCluster];
+		if(ulCluster==SQI_FAT_EOC)
+			return SQI_FILE_OK;
+		if(ulCluster==SQI_FAT_FREE)
+			return SQI_FILE_FREE;
+		if(ulCluster==SQI_FAT_BAD)
+			return SQI_FILE_BAD;
+	}
+}
+
+
+
+static int SqiAddEntry(SQI_FAT_T* ptFat){
+	if(ptFat->iNumEntries==ptFat->iMaxEntries){
+		int iMax=ptFat->iMaxEntries ? ptFat->iMaxEntries*2 : 64;
+		SQI_FAT_ENTRY_T* atEntry=MemRealloc(ptFat->atEntry,iMax*sizeof(SQI_FAT_ENTRY_T));
+		if(atEntry==NULL){
+			printf("error malloc\n");
+			return -1;
+		}
+		ptFat->atEntry=atEntry;
+		ptFat->iMaxEntries=iMax;
+	}
+	memset(&ptFat->atEntry[ptFat->iNumEntries],0,sizeof(SQI_FAT_ENTRY_T));
+	return ptFat->iNumEntries++;
+}
+
+
+
+/* short name NAME.EXT without padding */
+static void SqiShortName(const uint8_t* abEntry, char* szName){
+	int iLen=0;
+	int i=0;
+
+	for(i=0;i<8 && abEntry[i]!=' ';i++){
+		szName[iLen++]=(char)abEntry[i];
+	}
+	if(abEntry[8]!=' ')
+		szName[iLen++]='.';
+	for(i=8;i<11 && abEntry[i]!=' ';i++){
+		szName[iLen++]=(char)abEntry[i];
+	}
+	szName[iLen]='\0';
+}
+
+
+
+/* checksum of the short name, stored in every LFN entry of the name */
+static uint8_t SqiShortNameChecksum(const uint8_t* abEntry){
+	uint8_t bSum=0;
+	int i=0;
+
+	for(i=0;i<11;i++){
+		bSum=(uint8_t)(((bSum&1)<<7)+(bSum>>1)+abEntry[i]);
+	}
+	return bSum;
+}
+
+
+
+/* long file name part of an LFN entry, characters beyond ASCII are replaced by '_',
+ * false if the ordinal does not fit into szLongName */
+static bool SqiLongNamePart(const uint8_t* abEntry, char* szLongName){
+	static const uint8_t abCharOffset[13]={1,3,5,7,9,14,16,18,20,22,24,28,30};
+	int iPos=((abEntry[0]&0x1F)-1)*13;
+	int i=0;
+
+	if(iPos<0 || iPos+13>=SQI_MAX_NAME)
+		return false;
+	if(abEntry[0]&0x40)
+		szLongName[iPos+13]='\0';
+	for(i=0;i<13;i++){
+		uint16_t usChar=SqiReadWord(&abEntry[abCharOffset[i]]);
+		if(usChar==0x0000){
+			szLongName[iPos+i]='\0';
+			break;
+		}
+		szLongName[iPos+i]=usChar<0x80 ? (char)usChar : '_';
+	}
+	return true;
+}
+
+
+
+/* adds the entries of a directory, the directories found are read later by the caller
+ * a long name is used if all its LFN entries were accepted and carry the checksum of
+ * the short name, the 8.3 name otherwise */
+static void SqiParseDir(SQI_FAT_T* ptFat, const uint8_t* abDir, uint32_t ulSize, const char* szParent){
+	char szLongName[SQI_MAX_NAME];
+	char szName[SQI_MAX_NAME];
+	bool bLongName=false;
+	uint8_t bChecksum=0;
+	uint32_t ulOffset=0;
+
+	for(ulOffset=0;ulOffset+SQI_DIR_ENTRY_SIZE<=ulSize;ulOffset+=SQI_DIR_ENTRY_SIZE){
+		const uint8_t* abEntry=&abDir[ulOffset];
+		SQI_FAT_ENTRY_T* ptEntry=0;
+		int iEntry=0;
+
+		if(abEntry[0]==0x00)
+			break;
+		if(abEntry[0]==0xE5){
+			bLongName=false;
+			continue;
+		}
+		if(abEntry[11]==SQI_ATTR_LFN){
+			if(abEntry[0]&0x40){
+				memset(szLongName,0,sizeof(szLongName));
+				bChecksum=abEntry[13];
+				bLongName=true;
+			}
+			if(abEntry[13]!=bChecksum || !SqiLongNamePart(abEntry,szLongName))
+				bLongName=false;
+			continue;
+		}
+		if((abEntry[11]&SQI_ATTR_VOLUME) || abEntry[0]=='.'){
+			bLongName=false;
+			continue;
+		}
+
+		if(bLongName && SqiShortNameChecksum(abEntry)==bChecksum)
+			strcpy(szName,szLongName);
+		else
+			SqiShortName(abEntry,szName);
+		bLongName=false;
+
+		iEntry=SqiAddEntry(ptFat);
+		if(iEntry<0)
+			return;
+		ptEntry=&ptFat->atEntry[iEntry];
+		snprintf(ptEntry->szPath,sizeof(ptEntry->szPath),"%s/%s",szParent,szName);
+		ptEntry->bAttr=abEntry[11];
+		ptEntry->ulSize=SqiReadDword(&abEntry[28]);
+		ptEntry->ulFirstCluster=SqiReadWord(&abEntry[26]);
+		if(ptFat->iFatBits==32)
+			ptEntry->ulFirstCluster|=(uint32_t)SqiReadWord(&abEntry[20])<<16;
+
+		ptEntry->iState=SqiWalkChain(ptFat,iEntry);
+		if(ptEntry->iState==SQI_FILE_OK && 0==(ptEntry->bAttr&SQI_ATTR_DIRECTORY)
+				&& ptEntry->ulNumClusters!=(ptEntry->ulSize+ptFat->ulClusterSize-1)/ptFat->ulClusterSize)
+			ptEntry->iState=SQI_FILE_SIZE;
+	}
+}
+
+
+
+/* reads the clusters of a directory, the chain has been walked already */
+static uint8_t* SqiReadDirClusters(SQI_FAT_T* ptFat, FILE* hFile, uint32_t ulFirstCluster, uint32_t ulNumClusters, uint32_t* pulSize){
+	uint8_t* abDir=MemAlloc((size_t)ulNumClusters*ptFat->ulClusterSize+1);
+	uint32_t ulCluster=ulFirstCluster;
+	uint32_t i=0;
+
+	if(abDir==NULL){
+		printf("error malloc\n");
+		return NULL;
+	}
+	for(i=0;i<ulNumClusters;i++){
+		if(!SqiRead(hFile,ptFat->ulBase+ptFat->ulDataOffset+(ulCluster-2)*ptFat->ulClusterSize,&abDir[i*ptFat->ulClusterSize],ptFat->ulClusterSize)){
+			free(abDir);
+			return NULL;
+		}
+		ulCluster=ptFat->aulFat[ulCluster];
+	}
+	*pulSize=ulNumClusters*ptFat->ulClusterSize;
+	return abDir;
+}
+
+
+
+/* builds the index of all files and directories, directories are read in the order they are found */
+static bool SqiBuildIndex(SQI_FAT_T* ptFat, FILE* hFile){
+	uint8_t* abDir=0;
+	uint32_t ulSize=0;
+	int i=0;
+
+	if(ptFat->iFatBits==32){
+		int iRoot=SqiAddEntry(ptFat);
+		if(iRoot<0)
+			return false;
+		ptFat->atEntry[iRoot].ulFirstCluster=ptFat->ulRootCluster;
+		ptFat->atEntry[iRoot].bAttr=SQI_ATTR_DIRECTORY;
+		ptFat->atEntry[iRoot].iState=SqiWalkChain(ptFat,iRoot);
+		if(ptFat->atEntry[iRoot].iState==SQI_FILE_OK)
+			abDir=SqiReadDirClusters(ptFat,hFile,ptFat->ulRootCluster,ptFat->atEntry[iRoot].ulNumClusters,&ulSize);
+		i=1;
+	}
+	else {
+		ulSize=ptFat->ulRootEntries*SQI_DIR_ENTRY_SIZE;
+		abDir=MemAlloc(ulSize+1);
+		if(abDir!=NULL && !SqiRead(hFile,ptFat->ulBase+ptFat->ulRootOffset,abDir,ulSize)){
+			free(abDir);
+			abDir=NULL;
+		}
+	}
+	if(abDir==NULL){
+		printf("error reading root directory\n");
+		return false;
+	}
+	SqiParseDir(ptFat,abDir,ulSize,"");
+	free(abDir);
+
+	for(;i<ptFat->iNumEntries;i++){
+		SQI_FAT_ENTRY_T* ptEntry=&ptFat->atEntry[i];
+		char szParent[BATCH_MAX_PATH];
+
+		if(0==(ptEntry->bAttr&SQI_ATTR_DIRECTORY) || ptEntry->iState!=SQI_FILE_OK || ptEntry->ulNumClusters==0)
+			continue;
+		abDir=SqiReadDirClusters(ptFat,hFile,ptEntry->ulFirstCluster,ptEntry->ulNumClusters,&ulSize);
+		if(abDir==NULL){
+			ptFat->atEntry[i].iState=SQI_FILE_READ;
+			continue;
+		}
+		strcpy(szParent,ptEntry->szPath);
+		SqiParseDir(ptFat,abDir,ulSize,szParent); // may move atEntry
+		free(abDir);
+	}
+	return true;
+}
+
+
+
+/* SHA-256 of one file, runs of contiguous clusters are read at once */
+static void SqiHashJob(int iJob, int iWorker, void* pvContext){
+	SQI_FAT_T* ptFat=(SQI_FAT_T*)pvContext;
+	SQI_FAT_ENTRY_T* ptEntry=&ptFat->atEntry[iJob];
+	SHA256_CTX_T tCtx;
+	uint8_t* abBuffer=0;
+	uint32_t ulRemaining=ptEntry->ulSize;
+	uint32_t ulCluster=ptEntry->ulFirstCluster;
+	uint32_t ulMaxRun=HIL_MAX(SQI_READ_SIZE/ptFat->ulClusterSize,1);
+
+	if((ptEntry->bAttr&SQI_ATTR_DIRECTORY) || ptEntry->iState!=SQI_FILE_OK)
+		return;
+
+	if(ptFat->ahFile[iWorker]==NULL)
+		ptFat->ahFile[iWorker]=fopen(ptFat->szFilename,"rb");
+	abBuffer=MemAlloc(ulMaxRun*ptFat->ulClusterSize);
+	if(ptFat->ahFile[iWorker]==NULL || abBuffer==NULL){
+		ptEntry->iState=SQI_FILE_READ;
+		free(abBuffer);
+		return;
+	}
+
+	Sha256Init(&tCtx);
+	while(ulRemaining){
+		uint32_t ulFirst=ulCluster;
+		uint32_t ulRun=1;
+		uint32_t ulBytes=0;
+
+		while(ulRun<ulMaxRun && ptFat->aulFat[ulCluster]==ulCluster+1){
+			ulCluster++;
+			ulRun++;
+		}
+		ulBytes=HIL_MIN(ulRemaining,ulRun*ptFat->ulClusterSize);
+		if(!SqiRead(ptFat->ahFile[iWorker],ptFat->ulBase+ptFat->ulDataOffset+(ulFirst-2)*ptFat->ulClusterSize,abBuffer,ulBytes)){
+			ptEntry->iState=SQI_FILE_READ;
+			break;
+		}
+		Sha256Update(&tCtx,abBuffer,ulBytes);
+		ulRemaining-=ulBytes;
+		ulCluster=ptFat->aulFat[ulCluster];
+	}
+	Sha256Final(&tCtx,ptEntry->abSha256);
+	free(abBuffer);
+}
+
+
+
+static void PrintSqiEntry(const SQI_FAT_ENTRY_T* ptEntry){
+	int i=0;
+
+	if(ptEntry->bAttr&SQI_ATTR_DIRECTORY){
+		printf("%-40s  <DIR>     %-5u  %-16s  %s\n",ptEntry->szPath[0] ? ptEntry->szPath : "/",ptEntry->ulNumClusters,"",s_aszSqiFileState[ptEntry->iState]);
+		return;
+	}
+	printf("%-40s  %-8u  %-5u  ",ptEntry->szPath,ptEntry->ulSize,ptEntry->ulNumClusters);
+	if(ptEntry->iState==SQI_FILE_OK){
+		for(i=0;i<8;i++){
+			printf("%02x",ptEntry->abSha256[i]);
+		}
+	}
+	else {
+		printf("%-16s","");
+	}
+	printf("  %s\n",s_aszSqiFileState[ptEntry->iState]);
+}
+
+
+
+/* FAT file system of the area at ulOffset, index of all files and per file hash */
+int AnalyzeFatArea(char* szFilename, FILE* hFile, uint32_t ulOffset, uint32_t ulLength, int iNumThreads){
+	SQI_FAT_T tFat;
+	uint8_t abBoot[512];
+	uint32_t ulUsed=0;
+	int iFiles=0;
+	int iDirs=0;
+	int iErrors=0;
+	int i=0;
+
+	memset(&tFat,0,sizeof(tFat));
+	tFat.szFilename=szFilename;
+	tFat.ulBase=ulOffset;
+
+	printf("\n--------------------------------------\nFAT FILE SYSTEM\n");
+	printf("check offset:   0x%06x\n",ulOffset);
+	if(!SqiRead(hFile,ulOffset,abBoot,sizeof(abBoot))){
+		printf("ERROR area exceeds the dump\n");
+		return EXIT_FAILURE;
+	}
+	if(BlockErased(abBoot,sizeof(abBoot))){
+		printf("area erased\n");
+		return 0;
+	}
+	if(!SqiParseBootSector(&tFat,abBoot,ulLength)){
+		printf("ERROR no FAT boot sector\n");
+		return EXIT_FAILURE;
+	}
+	if(!SqiLoadFat(&tFat,hFile) || !SqiBuildIndex(&tFat,hFile)){
+		free(tFat.aulFat);
+		free(tFat.alOwner);
+		free(tFat.atEntry);
+		return EXIT_FAILURE;
+	}
+
+	if(iNumThreads<=0)
+		iNumThreads=BatchGetNumCpus();
+	tFat.ahFile=MemCalloc(iNumThreads,sizeof(FILE*));
+	if(tFat.ahFile==NULL || BatchRun(tFat.iNumEntries,iNumThreads,SqiHashJob,&tFat)){
+		for(i=0;i<tFat.iNumEntries;i++){
+			if(0==(tFat.atEntry[i].bAttr&SQI_ATTR_DIRECTORY) && tFat.atEntry[i].iState==SQI_FILE_OK)
+				tFat.atEntry[i].iState=SQI_FILE_READ;
+		}
+	}
+	for(i=0;tFat.ahFile!=NULL && i<iNumThreads;i++){
+		if(tFat.ahFile[i]!=NULL)
+			fclose(tFat.ahFile[i]);
+	}
+
+	for(i=2;i<(int)tFat.ulNumClusters+2;i++){
+		if(tFat.aulFat[i]!=SQI_FAT_FREE)
+			ulUsed++;
+	}
+	printf("type:           FAT%d\n",tFat.iFatBits);
+	printf("cluster size:   %u\n",tFat.ulClusterSize);
+	printf("clusters:       %u, %u used, %u free\n",tFat.ulNumClusters,ulUsed,tFat.ulNumClusters-ulUsed);
+	printf("FAT copies:     %u, %s\n",tFat.ulNumFats,tFat.bFatsEqual ? "equal" : "DIFFERENT");
+	printf("--------------------------------------\n");
+	printf("%-40s  %-8s  %-5s  %-16s  %s\n","path","size","clust","sha256","state");
+	for(i=0;i<tFat.iNumEntries;i++){
+		PrintSqiEntry(&tFat.atEntry[i]);
+		if(tFat.atEntry[i].bAttr&SQI_ATTR_DIRECTORY)
+			iDirs++;
+		else
+			iFiles++;
+		if(tFat.atEntry[i].iState!=SQI_FILE_OK)
+			iErrors++;
+	}
+	printf("\n%d files, %d directories, %d errors\n",iFiles,iDirs,iErrors);
+
+	free(tFat.ahFile);
+	free(tFat.aulFat);
+	free(tFat.alOwner);
+	free(tFat.atEntry);
+	return iErrors || !tFat.bFatsEqual ? EXIT_FAILURE : 0;
+}
+
+
+
+static const FILE_T* GetSqiArea(int iUseCase, const char* szSuffix){
+	int i=0;
+
+	for(i=0;i<sizeof(tSQIDumpFile[iUseCase])/sizeof(FILE_T);i++){
+		if(0==strcmp(szSuffix,tSQIDumpFile[iUseCase][i].szSuffix))
+			return &tSQIDumpFile[iUseCase][i];
+	}
+	return NULL;
+}
+
+
+
+/* SQI flash dump of use case B (update area) or C (FAT, remanent data) */
+int AnalyzeSqiDump(char* szFilename, int iUseCase, int iNumThreads){
+	const FILE_T* ptUpd=GetSqiArea(iUseCase,".upd");
+	const FILE_T* ptFatArea=GetSqiArea(iUseCase,".fat");
+	FILE* hFile=NULL;
+	int iRes=0;
+	int i=0;
+
+	if(iUseCase!=USE_CASE_B && iUseCase!=USE_CASE_C){
+		printf("Error: no SQI flash layout for use case A\n");
+		return EXIT_FAILURE;
+	}
+	hFile=fopen(szFilename,"rb");
+	if(hFile==NULL){
+		printf("\nError opening file %s\n",szFilename);
+		return EXIT_FAILURE;
+	}
+
+	printf("\nanalyze SQI FLASH DUMP file [use case %c] %s\n\n",'A'+iUseCase,szFilename);
+	for(i=0;i<sizeof(tSQIDumpFile[iUseCase])/sizeof(FILE_T);i++){
+		if(tSQIDumpFile[iUseCase][i].ulLength)
+			printf("%s  offset: 0x%08x, areasize: 0x%08x [%dKB]\n",tSQIDumpFile[iUseCase][i].szSuffix,
+					tSQIDumpFile[iUseCase][i].ulOffset,tSQIDumpFile[iUseCase][i].ulLength,tSQIDumpFile[iUseCase][i].ulLength/1024);
+	}
+
+	if(ptUpd!=NULL){
+		printf("\n-------------------------------------- Update Area --------------------------------------\n");
+		iRes|=AnalyzeNxfFileHeader(ptUpd->ulOffset,hFile);
+		FileScratchRelease();
+	}
+	if(ptFatArea!=NULL){
+		printf("\n-------------------------------------- File System --------------------------------------\n");
+		iRes|=AnalyzeFatArea(szFilename,hFile,ptFatArea->ulOffset,ptFatArea->ulLength,iNumThreads);
+	}
+
+	fclose(hFile);
+	return iRes ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,522 @@
+/*
+ * netXFileCheckerTags.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  tag list of legacy firmware files (netX 51, netX 52, etc.)
+ *  the common header gives offset, size and reserved size of the tag list,
+ *  the list is a sequence of tags, each tag is its type, the data size and the data
+ *  padded to a DWORD boundary. The list ends with the end tag (type 0).
+ *  Bit 31 of the type marks a disabled tag, its data is kept but not used by the firmware.
+ *  The tags are walked in place, the entries point into the file data.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+#include "Hil_FileHeaderV3.h"
+
+
+#define TAG_END          0x00000000
+#define TAG_IGNORE_FLAG  0x80000000 // tag disabled
+#define TAG_HEADER_SIZE  8          // ulTagType, ulTagDataSize
+#define TAG_MAX_TAGS     256
+#define TAG_PRINT_BYTES  16         // data bytes shown in the tag table
+#define TAG_NAME_MAX     64         // tags starting with a name, e.g. task lists
+#define TAG_MAX_DIFFS    16         // differences kept per file of a batch diff
+
+#define TAG_LIST_OK         0
+#define TAG_LIST_NONE       1 // no tag list
+#define TAG_LIST_OUTSIDE    2 // tag list beyond the end of the file
+#define TAG_LIST_OVERSIZE   3 // tag list larger than the reserved size
+#define TAG_LIST_TRUNCATED  4 // a tag exceeds the tag list
+#define TAG_LIST_NO_END     5 // no end tag
+#define TAG_LIST_TOO_MANY   6 // more than TAG_MAX_TAGS tags
+#define TAG_LIST_NO_HEADER  7 // file too short or no firmware file
+#define TAG_LIST_LOAD_ERROR 8
+
+static const char* s_aszTagListState[]={
+	"OK",
+	"no tag list",
+	"ERROR tag list outside of the file",
+	"ERROR tag list larger than reserved size",
+	"ERROR tag exceeds the tag list",
+	"ERROR no end tag",
+	"ERROR too many tags",
+	"ERROR no firmware header",
+	"ERROR file not readable",
+};
+
+typedef struct TAG_ENTRY_Ttag {
+	uint32_t ulType;             // including TAG_IGNORE_FLAG
+	uint32_t ulSize;
+	uint32_t ulOffset;           // offset of the tag in the tag list
+	const uint8_t* pabData;      // points into the tag list
+} TAG_ENTRY_T;
+
+typedef struct TAG_LIST_Ttag {
+	uint32_t ulOffset;           // from the beginning of the file
+	uint32_t ulSize;
+	uint32_t ulSizeMax;
+	int iState;
+	int iNumTags;
+	TAG_ENTRY_T atTag[TAG_MAX_TAGS];
+} TAG_LIST_T;
+
+#define TAG_DIFF_VALUE    0 // data differs
+#define TAG_DIFF_MISSING  1 // tag of the reference not found
+#define TAG_DIFF_ADDED    2 // tag not in the reference
+#define TAG_DIFF_ENABLED  3 // enabled in one file, disabled in the other
+
+typedef struct TAG_DIFF_Ttag {
+	uint32_t ulType;             // without TAG_IGNORE_FLAG
+	int iInstance;               // n-th tag of this type
+	int iKind;
+	uint32_t ulByte;             // TAG_DIFF_VALUE: first differing byte
+} TAG_DIFF_T;
+
+typedef struct TAG_DIFF_RESULT_Ttag {
+	int iState;                  // TAG_LIST_xxx of the file
+	int iNumDiffs;
+	TAG_DIFF_T atDiff[TAG_MAX_DIFFS];
+} TAG_DIFF_RESULT_T;
+
+typedef struct TAG_BATCH_Ttag {
+	char** aszFiles;
+	const TAG_LIST_T* ptRef;
+	TAG_DIFF_RESULT_T* atResult;
+} TAG_BATCH_T;
+
+
+
+static uint32_t TagRead32(const uint8_t* pab){
+	uint32_t ulValue;
+	memcpy(&ulValue,pab,sizeof(ulValue));
+	return ulValue;
+}
+
+
+
+/* checks position and size of the tag list against the file */
+static int TagListLocate(const HIL_FILE_COMMON_HEADER_V3_0_T* ptCommonHeader, uint64_t ullFileSize, TAG_LIST_T* ptList){
+	ptList->ulOffset=ptCommonHeader->ulTagListOffset;
+	ptList->ulSize=ptCommonHeader->ulTagListSize;
+	ptList->ulSizeMax=ptCommonHeader->ulTagListSizeMax;
+	ptList->iNumTags=0;
+
+	/* 0xFFFFFFFF: erased area of a flash dump */
+	if(ptList->ulSize==0 || ptList->ulSize==0xFFFFFFFF)
+		return TAG_LIST_NONE;
+	if((uint64_t)ptList->ulOffset+ptList->ulSize>ullFileSize)
+		return TAG_LIST_OUTSIDE;
+	if(ptList->ulSizeMax && ptList->ulSize>ptList->ulSizeMax)
+		return TAG_LIST_OVERSIZE;
+	return TAG_LIST_OK;
+}
+
+
+
+/* walks the tags of a tag list in place, every tag is checked against the end of the list */
+static int TagListWalk(const uint8_t* pabList, TAG_LIST_T* ptList){
+	uint32_t ulPos=0;
+
+	ptList->iNumTags=0;
+	while(ptList->ulSize-ulPos>=TAG_HEADER_SIZE){
+		uint32_t ulType=TagRead32(pabList+ulPos);
+		uint32_t ulSize=TagRead32(pabList+ulPos+4);
+
+		if(ulType==TAG_END)
+			return TAG_LIST_OK;
+		if(ulSize>ptList->ulSize-ulPos-TAG_HEADER_SIZE)
+			return TAG_LIST_TRUNCATED;
+		if(ptList->iNumTags==TAG_MAX_TAGS)
+			return TAG_LIST_TOO_MANY;
+
+		ptList->atTag[ptList->iNumTags].ulType=ulType;
+		ptList->atTag[ptList->iNumTags].ulSize=ulSize;
+		ptList->atTag[ptList->iNumTags].ulOffset=ulPos;
+		ptList->atTag[ptList->iNumTags].pabData=pabList+ulPos+TAG_HEADER_SIZE;
+		ptList->iNumTags++;
+
+		/* the padding of the last tag may be cut off by the list size */
+		ulPos+=TAG_HEADER_SIZE+ulSize;
+		if(ulPos&3)
+			ulPos=HIL_MIN(ptList->ulSize,(ulPos+3)&~3u);
+	}
+	return TAG_LIST_NO_END;
+}
+
+
+
+/* tag list of a mapped firmware file, the tags point into the mapping */
+static int TagListFromFile(const uint8_t* pabFile, size_t ulFileSize, TAG_LIST_T* ptList){
+	HIL_FILE_COMMON_HEADER_V3_0_T tCommonHeader;
+
+	ptList->iNumTags=0;
+	ptList->iState=TAG_LIST_NO_HEADER;
+	if(ulFileSize<sizeof(HIL_FILE_BOOT_HEADER_V1_0_T)+sizeof(HIL_FILE_COMMON_HEADER_V3_0_T))
+		return ptList->iState;
+	memcpy(&tCommonHeader,pabFile+sizeof(HIL_FILE_BOOT_HEADER_V1_0_T),sizeof(tCommonHeader));
+	ptList->iState=TagListLocate(&tCommonHeader,ulFileSize,ptList);
+	if(ptList->iState==TAG_LIST_OK)
+		ptList->iState=TagListWalk(pabFile+ptList->ulOffset,ptList);
+	return ptList->iState;
+}
+
+
+
+static bool IsTagFile(char* szFilename){
+	switch(GetFileType(szFilename)){
+	case FILETYPE_NXF:
+	case FILETYPE_NXI:
+	case FILETYPE_MXF:
+	case FILETYPE_UPD:
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+
+/* length of a name at the start of the tag data, 0 if the data doesn't start with a printable string */
+static int TagNameLength(const TAG_ENTRY_T* ptTag){
+	uint32_t ulMax=HIL_MIN(ptTag->ulSize,TAG_NAME_MAX);
+	uint32_t i=0;
+
+	for(i=0;i<ulMax;i++){
+		if(ptTag->pabData[i]==0)
+			return i>=2 ? (int)i : 0;
+		if(ptTag->pabData[i]<0x20 || ptTag->pabData[i]>0x7E)
+			return 0;
+	}
+	return 0;
+}
+
+
+
+static void PrintTag(int iTag, const TAG_ENTRY_T* ptTag){
+	uint32_t ulShow=HIL_MIN(ptTag->ulSize,TAG_PRINT_BYTES);
+	int iNameLen=TagNameLength(ptTag);
+	uint32_t i=0;
+
+	printf("%-3d 0x%08x  0x%04x  %5u  %-8s ",iTag,ptTag->ulType&~TAG_IGNORE_FLAG,ptTag->ulOffset,ptTag->ulSize,
+			(ptTag->ulType&TAG_IGNORE_FLAG) ? "disabled" : "enabled");
+	if(iNameLen){
+		printf("\"%.*s\"",iNameLen,(const char*)ptTag->pabData);
+	}
+	else {
+		for(i=0;i<ulShow;i++){
+			printf("%02x",ptTag->pabData[i]);
+		}
+		if(ulShow<ptTag->ulSize)
+			printf("...");
+	}
+	printf("\n");
+}
+
+
+
+/* prints the tag list of a firmware file, offset is the boot header of the firmware */
+int AnalyzeTagList(fpos_t offset, FILE* hInFile){
+	HIL_FILE_COMMON_HEADER_V3_0_T tCommonHeader;
+	TAG_LIST_T* ptList=0;
+	uint8_t* abList=0;
+	fpos_t listOffset;
+	long lFileSize=0;
+	int i=0;
+
+	if(ReadFileData(hInFile,offset+sizeof(HIL_FILE_BOOT_HEADER_V1_0_T),&tCommonHeader,sizeof(tCommonHeader))!=sizeof(tCommonHeader))
+		return EXIT_FAILURE;
+
+	ptList=FileScratch(sizeof(TAG_LIST_T));
+	if(ptList==NULL){
+		printf("error malloc\n");
+		return EXIT_FAILURE;
+	}
+	lFileSize=GetFileDataSize(hInFile);
+
+	/* the tag list offset counts from the firmware, which may be an area of a dump */
+	ptList->iState=TagListLocate(&tCommonHeader,lFileSize>(long)offset ? (uint64_t)(lFileSize-(long)offset) : 0,ptList);
+	if(ptList->iState==TAG_LIST_NONE)
+		return 0;
+	if(ptList->iState==TAG_LIST_OK){
+		abList=FileScratch(ptList->ulSize);
+		listOffset=offset+ptList->ulOffset;
+		if(abList==NULL){
+			printf("error malloc\n");
+			return EXIT_FAILURE;
+		}
+		if(ReadFileData(hInFile,listOffset,abList,ptList->ulSize)!=ptList->ulSize)
+			ptList->iState=TAG_LIST_LOAD_ERROR;
+		else
+			ptList->iState=TagListWalk(abList,ptList);
+	}
+
+	printf("\n--------------------------------------\nTAG LIST\n");
+	printf("check offset:   0x%05x\n",(int)offset+ptList->ulOffset);
+	printf("size:           0x%04x [max 0x%04x]\n",ptList->ulSize,ptList->ulSizeMax);
+	printf("tags:           %d\n",ptList->iNumTags);
+	printf("state:          %s\n",s_aszTagListState[ptList->iState]);
+	printf("--------------------------------------\n");
+	if(ptList->iNumTags){
+		printf("#   type        offset  size   state    data\n");
+		for(i=0;i<ptList->iNumTags;i++){
+			PrintTag(i,&ptList->atTag[i]);
+		}
+	}
+
+	return ptList->iState==TAG_LIST_OK ? 0 : EXIT_FAILURE;
+}
+
+
+
+/* writes the tag list of a firmware file into <filename>.tags, one tag per line:
+ * type, state, size and the complete data as hex string */
+int ExportTagList(char* szFilename){
+	char szTagFilename[BATCH_MAX_PATH+8];
+	BATCH_MAP_T tMap;
+	TAG_LIST_T* ptList=0;
+	FILE* hFile=NULL;
+	int iRes=0;
+	int i=0;
+	uint32_t j=0;
+
+	if(BatchMapFile(szFilename,&tMap)){
+		printf("error opening file %s\n",szFilename);
+		return EXIT_FAILURE;
+	}
+	ptList=MemAlloc(sizeof(TAG_LIST_T));
+	if(ptList==NULL){
+		printf("error malloc\n");
+		BatchUnmapFile(&tMap);
+		return EXIT_FAILURE;
+	}
+	if(TagListFromFile(tMap.pabData,tMap.ulSize,ptList)!=TAG_LIST_OK){
+		printf("%s: %s, no tags exported\n",szFilename,s_aszTagListState[ptList->iState]);
+		free(ptList);
+		BatchUnmapFile(&tMap);
+		return EXIT_FAILURE;
+	}
+
+	snprintf(szTagFilename,sizeof(szTagFilename),"%s.tags",szFilename);
+	hFile=fopen(szTagFilename,"w");
+	if(hFile==NULL){
+		printf("error opening file %s\n",szTagFilename);
+		free(ptList);
+		BatchUnmapFile(&tMap);
+		return EXIT_FAILURE;
+	}
+	fprintf(hFile,"# tag list of %s, type state size data\n",szFilename);
+	for(i=0;i<ptList->iNumTags;i++){
+		const TAG_ENTRY_T* ptTag=&ptList->atTag[i];
+		fprintf(hFile,"0x%08x %s %u ",ptTag->ulType&~TAG_IGNORE_FLAG,(ptTag->ulType&TAG_IGNORE_FLAG) ? "disabled" : "enabled",ptTag->ulSize);
+		for(j=0;j<ptTag->ulSize;j++){
+			fprintf(hFile,"%02x",ptTag->pabData[j]);
+		}
+		fprintf(hFile,"\n");
+	}
+	if(fclose(hFile)){
+		printf("error writing file %s\n",szTagFilename);
+		iRes=EXIT_FAILURE;
+	}
+	else {
+		printf("\n%d tags written to %s\n",ptList->iNumTags,szTagFilename);
+	}
+
+	free(ptList);
+	BatchUnmapFile(&tMap);
+	return iRes;
+}
+
+
+
+static void TagAddDiff(TAG_DIFF_RESULT_T* ptResult, uint32_t ulType, int iInstance, int iKind, uint32_t ulByte){
+	if(ptResult->iNumDiffs<TAG_MAX_DIFFS){
+		TAG_DIFF_T* ptDiff=&ptResult->atDiff[ptResult->iNumDiffs];
+		ptDiff->ulType=ulType;
+		ptDiff->iInstance=iInstance;
+		ptDiff->iKind=iKind;
+		ptDiff->ulByte=ulByte;
+	}
+	ptResult->iNumDiffs++;
+}
+
+
+
+/* n-th tag of a type, the instance counts enabled and disabled tags */
+static const TAG_ENTRY_T* TagFind(const TAG_LIST_T* ptList, uint32_t ulType, int iInstance){
+	int i=0;
+
+	for(i=0;i<ptList->iNumTags;i++){
+		if((ptList->atTag[i].ulType&~TAG_IGNORE_FLAG)==ulType && iInstance--==0)
+			return &ptList->atTag[i];
+	}
+	return NULL;
+}
+
+static int TagInstance(const TAG_LIST_T* ptList, int iTag){
+	uint32_t ulType=ptList->atTag[iTag].ulType&~TAG_IGNORE_FLAG;
+	int iInstance=0;
+	int i=0;
+
+	for(i=0;i<iTag;i++){
+		if((ptList->atTag[i].ulType&~TAG_IGNORE_FLAG)==ulType)
+			iInstance++;
+	}
+	return iInstance;
+}
+
+
+
+/* compares the tags of a file with the reference, tags are matched by type and instance */
+static void TagCompare(const TAG_LIST_T* ptRef, const TAG_LIST_T* ptList, TAG_DIFF_RESULT_T* ptResult){
+	int i=0;
+
+	for(i=0;i<ptRef->iNumTags;i++){
+		const TAG_ENTRY_T* ptRefTag=&ptRef->atTag[i];
+		uint32_t ulType=ptRefTag->ulType&~TAG_IGNORE_FLAG;
+		int iInstance=TagInstance(ptRef,i);
+		const TAG_ENTRY_T* ptTag=TagFind(ptList,ulType,iInstance);
+
+		if(ptTag==NULL){
+			TagAddDiff(ptResult,ulType,iInstance,TAG_DIFF_MISSING,0);
+			continue;
+		}
+		if((ptTag->ulType^ptRefTag->ulType)&TAG_IGNORE_FLAG)
+			TagAddDiff(ptResult,ulType,iInstance,TAG_DIFF_ENABLED,0);
+		if(ptTag->ulSize!=ptRefTag->ulSize)
+			TagAddDiff(ptResult,ulType,iInstance,TAG_DIFF_VALUE,HIL_MIN(ptTag->ulSize,ptRefTag->ulSize));
+		else if(!BlockEqual(ptTag->pabData,ptRefTag->pabData,ptTag->ulSize))
+			TagAddDiff(ptResult,ulType,iInstance,TAG_DIFF_VALUE,BlockFirstMismatch(ptTag->pabData,ptRefTag->pabData,ptTag->ulSize));
+	}
+	for(i=0;i<ptList->iNumTags;i++){
+		uint32_t ulType=ptList->atTag[i].ulType&~TAG_IGNORE_FLAG;
+		int iInstance=TagInstance(ptList,i);
+
+		if(TagFind(ptRef,ulType,iInstance)==NULL)
+			TagAddDiff(ptResult,ulType,iInstance,TAG_DIFF_ADDED,0);
+	}
+}
+
+
+
+static void TagDiffJob(int iJob, int iWorker, void* pvContext){
+	TAG_BATCH_T* ptBatch=(TAG_BATCH_T*)pvContext;
+	TAG_DIFF_RESULT_T* ptResult=&ptBatch->atResult[iJob];
+	TAG_LIST_T* ptList=0;
+	BATCH_MAP_T tMap;
+
+	ptResult->iState=TAG_LIST_NO_HEADER;
+	if(!IsTagFile(ptBatch->aszFiles[iJob]))
+		return;
+	ptResult->iState=TAG_LIST_LOAD_ERROR;
+	if(BatchMapFile(ptBatch->aszFiles[iJob],&tMap))
+		return;
+	ptList=MemAlloc(sizeof(TAG_LIST_T));
+	if(ptList!=NULL){
+		ptResult->iState=TagListFromFile(tMap.pabData,tMap.ulSize,ptList);
+		/* a file without tag list differs from a reference with tags by all missing tags */
+		if(ptResult->iState==TAG_LIST_OK || ptResult->iState==TAG_LIST_NONE)
+			TagCompare(ptBatch->ptRef,ptList,ptResult);
+		free(ptList);
+	}
+	BatchUnmapFile(&tMap);
+}
+
+
+
+static void PrintTagDiff(const TAG_DIFF_T* ptDiff){
+	printf("  tag 0x%08x #%d  ",ptDiff->ulType,ptDiff->iInstance);
+	switch(ptDiff->iKind){
+	case TAG_DIFF_VALUE:
+		printf("value differs at byte 0x%04x\n",ptDiff->ulByte);
+		break;
+	case TAG_DIFF_MISSING:
+		printf("missing\n");
+		break;
+	case TAG_DIFF_ADDED:
+		printf("not in reference\n");
+		break;
+	default:
+		printf("enabled/disabled differs\n");
+		break;
+	}
+}
+
+
+
+/* lists the firmware files of the batch whose tags differ from the reference */
+int DiffTagLists(char* szRefFilename, char** aszFiles, int iNumFiles, int iNumThreads){
+	TAG_BATCH_T tBatch;
+	TAG_LIST_T* ptRef=0;
+	BATCH_MAP_T tRefMap;
+	int iNumEqual=0;
+	int iNumDiffer=0;
+	int iNumErrors=0;
+	int i=0;
+	int j=0;
+
+	if(BatchMapFile(szRefFilename,&tRefMap)){
+		printf("error opening file %s\n",szRefFilename);
+		return EXIT_FAILURE;
+	}
+	ptRef=MemAlloc(sizeof(TAG_LIST_T));
+	tBatch.atResult=MemCalloc(iNumFiles,sizeof(TAG_DIFF_RESULT_T));
+	if(ptRef==NULL || tBatch.atResult==NULL){
+		printf("error malloc\n");
+		free(ptRef);
+		free(tBatch.atResult);
+		BatchUnmapFile(&tRefMap);
+		return EXIT_FAILURE;
+	}
+	if(TagListFromFile(tRefMap.pabData,tRefMap.ulSize,ptRef)!=TAG_LIST_OK && ptRef->iState!=TAG_LIST_NONE){
+		printf("reference %s: %s\n",szRefFilename,s_aszTagListState[ptRef->iState]);
+		free(ptRef);
+		free(tBatch.atResult);
+		BatchUnmapFile(&tRefMap);
+		return EXIT_FAILURE;
+	}
+
+	tBatch.aszFiles=aszFiles;
+	tBatch.ptRef=ptRef;
+	if(iNumThreads<=0)
+		iNumThreads=BatchGetNumCpus();
+	BatchRun(iNumFiles,iNumThreads,TagDiffJob,&tBatch);
+
+	printf("\n--------------------------------------\nTAG LIST DIFF\n");
+	printf("reference:      %s\n",szRefFilename);
+	printf("reference tags: %d\n",ptRef->iNumTags);
+	printf("files:          %d\n",iNumFiles);
+	printf("--------------------------------------\n");
+	for(i=0;i<iNumFiles;i++){
+		const TAG_DIFF_RESULT_T* ptResult=&tBatch.atResult[i];
+
+		if(ptResult->iState!=TAG_LIST_OK && ptResult->iState!=TAG_LIST_NONE){
+			printf("%s  %s\n",aszFiles[i],s_aszTagListState[ptResult->iState]);
+			iNumErrors++;
+			continue;
+		}
+		if(ptResult->iNumDiffs==0){
+			iNumEqual++;
+			continue;
+		}
+		iNumDiffer++;
+		printf("%s  %d differences\n",aszFiles[i],ptResult->iNumDiffs);
+		for(j=0;j<HIL_MIN(ptResult->iNumDiffs,TAG_MAX_DIFFS);j++){
+			PrintTagDiff(&ptResult->atDiff[j]);
+		}
+		if(ptResult->iNumDiffs>TAG_MAX_DIFFS)
+			printf("  ...\n");
+	}
+	printf("\n%d equal, %d differ, %d errors\n",iNumEqual,iNumDiffer,iNumErrors);
+
+	free(ptRef);
+	free(tBatch.atResult);
+	BatchUnmapFile(&tRefMap);
+	return iNumDiffer || iNumErrors ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,228 @@
+/*
+ * netXFileCheckerTriage.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  quick fleet triage: only the FDL and the first TRIAGE_HEADER_SIZE bytes of the NXI, UPD
+ *  and MXF areas of a flash dump are read, the header ranges are computed from the layout
+ *  of the use case. Ranges closer than TRIAGE_MERGE_GAP are read with one request. The
+ *  requests of all files go to the batch reader (BatchReadRanges), on Linux the io_uring
+ *  keeps the requests of many files in flight.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "netXFileChecker.h"
+#include "Hil_FileHeaderV3.h"
+#include "Hil_DeviceProductionData.h"
+
+
+#define TRIAGE_HEADER_SIZE 0x200  // boot header, common header and device info
+#define TRIAGE_MERGE_GAP   0x1000 // ranges closer than this are read at once
+#define TRIAGE_MAX_RANGES  BATCH_MAX_RANGES
+
+typedef struct TRIAGE_RANGE_Ttag {
+	const char* szSuffix;
+	uint32_t ulOffset;
+	uint32_t ulSize;
+	int iRead;                   // read request covering the range
+} TRIAGE_RANGE_T;
+
+typedef struct TRIAGE_RESULT_Ttag {
+	NETX_RECORD_T tRecord;
+	TRIAGE_RANGE_T atRange[TRIAGE_MAX_RANGES];
+	int iNumRanges;
+} TRIAGE_RESULT_T;
+
+typedef struct TRIAGE_BATCH_Ttag {
+	char** aszFiles;
+	int iUseCase;
+	TRIAGE_RESULT_T* atResult;
+	BATCH_RANGES_T* atRead;      // merged ranges per file
+} TRIAGE_BATCH_T;
+
+static const char* s_aszTriageAreas[]={
+		".fdl",
+		".nxi",
+		".upd",
+		".mxf",
+};
+
+
+
+static void TriageSetRange(TRIAGE_RANGE_T* ptRange, const char* szSuffix, uint32_t ulOffset, uint32_t ulSize){
+	ptRange->szSuffix=szSuffix;
+	ptRange->ulOffset=ulOffset;
+	ptRange->ulSize=ulSize;
+}
+
+
+
+/* header ranges of the file in ascending order, 0 for files without headers */
+static int TriageRanges(FILE_TYPE_E eFileType, int iUseCase, TRIAGE_RANGE_T* atRange){
+	int iNumRanges=0;
+	int i=0;
+
+	switch(eFileType){
+	case FILETYPE_FLASHDUMP:
+		for(i=0;i<sizeof(s_aszTriageAreas)/sizeof(s_aszTriageAreas[0]);i++){
+			char* szSuffix=(char*)s_aszTriageAreas[i];
+			uint32_t ulLength=getLength(iUseCase,szSuffix);
+
+			if(ulLength==0)
+				continue;
+			if(0==strcmp(szSuffix,".fdl"))
+				ulLength=HIL_MIN(ulLength,sizeof(HIL_PRODUCT_DATA_LABEL_T));
+			else
+				ulLength=HIL_MIN(ulLength,TRIAGE_HEADER_SIZE);
+			TriageSetRange(&atRange[iNumRanges++],szSuffix,getOffset(iUseCase,szSuffix),ulLength);
+		}
+		break;
+
+	case FILETYPE_FDL:
+		TriageSetRange(&atRange[iNumRanges++],".fdl",0,sizeof(HIL_PRODUCT_DATA_LABEL_T));
+		break;
+
+	case FILETYPE_NXF:
+	case FILETYPE_NXI:
+	case FILETYPE_NXE:
+	case FILETYPE_UPD:
+	case FILETYPE_MXF:
+	case FILETYPE_NAE:
+		TriageSetRange(&atRange[iNumRanges++],"",0,TRIAGE_HEADER_SIZE);
+		break;
+
+	case FILETYPE_NAI:
+		TriageSetRange(&atRange[iNumRanges++],"",0,HBOOT_NAI_HEADER_OFFSET+TRIAGE_HEADER_SIZE);
+		break;
+
+	default:
+		break;
+	}
+	return iNumRanges;
+}
+
+
+
+/* ranges closer than TRIAGE_MERGE_GAP share one read request */
+static void TriageMergeRanges(TRIAGE_RANGE_T* atRange, int iNumRanges, BATCH_RANGES_T* ptRead){
+	int i=0;
+
+	ptRead->iNumRanges=0;
+	for(i=0;i<iNumRanges;i++){
+		BATCH_RANGE_T* ptLast=ptRead->iNumRanges ? &ptRead->atRange[ptRead->iNumRanges-1] : NULL;
+
+		if(ptLast!=NULL && atRange[i].ulOffset<=ptLast->ulOffset+ptLast->ulSize+TRIAGE_MERGE_GAP){
+			ptLast->ulSize=HIL_MAX(ptLast->ulSize,atRange[i].ulOffset+atRange[i].ulSize-ptLast->ulOffset);
+		}
+		else {
+			ptLast=&ptRead->atRange[ptRead->iNumRanges++];
+			ptLast->ulOffset=atRange[i].ulOffset;
+			ptLast->ulSize=atRange[i].ulSize;
+			ptLast->ulRead=0;
+		}
+		atRange[i].iRead=ptRead->iNumRanges-1;
+	}
+}
+
+
+
+/* the merged ranges follow each other in pabData */
+static void TriageParse(int iJob, int iWorker, const uint8_t* pabData, size_t ulSize, void* pvContext){
+	TRIAGE_BATCH_T* ptBatch=(TRIAGE_BATCH_T*)pvContext;
+	TRIAGE_RESULT_T* ptResult=&ptBatch->atResult[iJob];
+	const BATCH_RANGES_T* ptRead=&ptBatch->atRead[iJob];
+	RECORD_FRAGMENT_T atFragment[TRIAGE_MAX_RANGES];
+	size_t aulReadStart[TRIAGE_MAX_RANGES];
+	size_t ulStart=0;
+	int i=0;
+
+	if(pabData==NULL){
+		memset(&ptResult->tRecord,0xFF,sizeof(NETX_RECORD_T));
+		ptResult->tRecord.ulFlags=RECORD_FLAG_LOAD_ERROR;
+		return;
+	}
+	for(i=0;i<ptRead->iNumRanges;i++){
+		aulReadStart[i]=ulStart;
+		ulStart+=ptRead->atRange[i].ulSize;
+	}
+	for(i=0;i<ptResult->iNumRanges;i++){
+		const TRIAGE_RANGE_T* ptRange=&ptResult->atRange[i];
+		const BATCH_RANGE_T* ptReadRange=&ptRead->atRange[ptRange->iRead];
+		uint32_t ulPos=ptRange->ulOffset-ptReadRange->ulOffset;
+
+		atFragment[i].szSuffix=ptRange->szSuffix;
+		atFragment[i].pabData=pabData+aulReadStart[ptRange->iRead]+ulPos;
+		atFragment[i].ulSize=ptReadRange->ulRead>ulPos ? HIL_MIN(ptRange->ulSize,ptReadRange->ulRead-ulPos) : 0;
+	}
+	BuildFragmentRecord(atFragment,ptResult->iNumRanges,GetFileType(ptBatch->aszFiles[iJob]),ptBatch->iUseCase,&ptResult->tRecord);
+}
+
+
+
+/* one summary line per file like -batch, built from the header ranges only */
+int TriageBatch(char** aszFiles, int iNumFiles, int iUseCase, int iNumThreads){
+	TRIAGE_BATCH_T tBatch;
+	int iNumReads=0;
+	int iRes=0;
+	uint64_t ullBytesRead=0;
+	int iErrors=0;
+	int i=0;
+
+	tBatch.aszFiles=aszFiles;
+	tBatch.iUseCase=iUseCase;
+	if(iNumThreads<=0)
+		iNumThreads=BatchGetNumCpus();
+	tBatch.atResult=MemCalloc(iNumFiles,sizeof(TRIAGE_RESULT_T));
+	tBatch.atRead=MemCalloc(iNumFiles,sizeof(BATCH_RANGES_T));
+	if(tBatch.atResult==NULL || tBatch.atRead==NULL){
+		printf("error malloc\n");
+		free(tBatch.atResult);
+		free(tBatch.atRead);
+		return EXIT_FAILURE;
+	}
+	for(i=0;i<iNumFiles;i++){
+		TRIAGE_RESULT_T* ptResult=&tBatch.atResult[i];
+
+		ptResult->iNumRanges=TriageRanges(GetFileType(aszFiles[i]),iUseCase,ptResult->atRange);
+		TriageMergeRanges(ptResult->atRange,ptResult->iNumRanges,&tBatch.atRead[i]);
+	}
+
+	iRes=BatchReadRanges(aszFiles,iNumFiles,iNumThreads,tBatch.atRead,TriageParse,&tBatch);
+	if(iRes){
+		free(tBatch.atResult);
+		free(tBatch.atRead);
+		return EXIT_FAILURE;
+	}
+
+	for(i=0;i<iNumFiles;i++){
+		int iRead=0;
+		if(tBatch.atResult[i].tRecord.ulFlags&RECORD_FLAG_LOAD_ERROR)
+			continue;
+		for(iRead=0;iRead<tBatch.atRead[i].iNumRanges;iRead++){
+			iNumReads++;
+			ullBytesRead+=tBatch.atRead[i].atRange[iRead].ulRead;
+		}
+	}
+
+	printf("\n--------------------------------------\nTRIAGE\n");
+	printf("files:          %d\n",iNumFiles);
+	printf("reads:          %d\n",iNumReads);
+	printf("bytes read:     %llu [%lluKB]\n",(unsigned long long)ullBytesRead,(unsigned long long)ullBytesRead/1024);
+	printf("--------------------------------------\n");
+	for(i=0;i<iNumFiles;i++){
+		PrintRecordSummary(aszFiles[i],&tBatch.atResult[i].tRecord);
+		printf("\n");
+		if(tBatch.atResult[i].tRecord.ulFlags&RECORD_FLAG_LOAD_ERROR)
+			iErrors++;
+	}
+	printf("\n%d files, %d errors\n",iNumFiles,iErrors);
+
+	free(tBatch.atResult);
+	free(tBatch.atRead);
+	return iErrors ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,287 @@
+/*
+ * sha256.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  SHA-256 and SHA-224 (FIPS 180-4)
+ *  blocks are processed with the SHA extensions of x86 (SHA-NI) or ARMv8 when available
+ */
+
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define SHA256_USE_SHANI
+#endif
+
+#if defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)
+#include <arm_neon.h>
+#define SHA256_USE_ARMV8
+#endif
+
+#include "netXFileChecker.h"
+
+
+static const uint32_t s_aulSha256K[64]={
+	0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+	0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+	0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+	0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+	0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+	0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+	0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+	0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2,
+};
+
+#define ROR32(x,n) (((x)>>(n))|((x)<<(32-(n))))
+
+
+
+static void Sha256BlockC(uint32_t* aulState, const uint8_t* pabBlock){
+	uint32_t aulW[64];
+	uint32_t a,b,c,d,e,f,g,h;
+	int i=0;
+
+	for(i=0;i<16;i++){
+		aulW[i]=((uint32_t)pabBlock[4*i]<<24)|((uint32_t)pabBlock[4*i+1]<<16)|((uint32_t)pabBlock[4*i+2]<<8)|pabBlock[4*i+3];
+	}
+	for(i=16;i<64;i++){
+		uint32_t s0=ROR32(aulW[i-15],7)^ROR32(aulW[i-15],18)^(aulW[i-15]>>3);
+		uint32_t s1=ROR32(aulW[i-2],17)^ROR32(aulW[i-2],19)^(aulW[i-2]>>10);
+		aulW[i]=aulW[i-16]+s0+aulW[i-7]+s1;
+	}
+
+	a=aulState[0]; b=aulState[1]; c=aulState[2]; d=aulState[3];
+	e=aulState[4]; f=aulState[5]; g=aulState[6]; h=aulState[7];
+
+	for(i=0;i<64;i++){
+		uint32_t S1=ROR32(e,6)^ROR32(e,11)^ROR32(e,25);
+		uint32_t ch=(e&f)^(~e&g);
+		uint32_t t1=h+S1+ch+s_aulSha256K[i]+aulW[i];
+		uint32_t S0=ROR32(a,2)^ROR32(a,13)^ROR32(a,22);
+		uint32_t maj=(a&b)^(a&c)^(b&c);
+		uint32_t t2=S0+maj;
+		h=g; g=f; f=e; e=d+t1;
+		d=c; c=b; b=a; a=t1+t2;
+	}
+
+	aulState[0]+=a; aulState[1]+=b; aulState[2]+=c; aulState[3]+=d;
+	aulState[4]+=e; aulState[5]+=f; aulState[6]+=g; aulState[7]+=h;
+}
+
+static void Sha256BlocksC(uint32_t* aulState, const uint8_t* pabData, size_t ulNumBlocks){
+	while(ulNumBlocks--){
+		Sha256BlockC(aulState,pabData);
+		pabData+=64;
+	}
+}
+
+
+
+#ifdef SHA256_USE_SHANI
+/* state is kept as ABEF/CDGH, each sha256rnds2 does two rounds */
+__attribute__((target("sha,sse4.1,ssse3")))
+static void Sha256BlocksShaNi(uint32_t* aulState, const uint8_t* pabData, size_t ulNumBlocks){
+	const __m128i tByteSwap=_mm_set_epi64x(0x0c0d0e0f08090a0bULL,0x0405060700010203ULL);
+	__m128i tState0,tState1,tTmp,tMsg,tAbefSave,tCdghSave;
+	__m128i atW[4];
+	int i=0;
+
+	tTmp=_mm_loadu_si128((const __m128i*)&aulState[0]);
+	tState1=_mm_loadu_si128((const __m128i*)&aulState[4]);
+	tTmp=_mm_shuffle_epi32(tTmp,0xB1);              // CDAB
+	tState1=_mm_shuffle_epi32(tState1,0x1B);        // EFGH
+	tState0=_mm_alignr_epi8(tTmp,tState1,8);        // ABEF
+	tState1=_mm_blend_epi16(tState1,tTmp,0xF0);     // CDGH
+
+	while(ulNumBlocks--){
+		tAbefSave=tState0;
+		tCdghSave=tState1;
+		for(i=0;i<16;i++){
+			if(i<4){
+				atW[i]=_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(pabData+16*i)),tByteSwap);
+			}
+			else {
+				/* W[i..i+3] from the previous 16 words */
+				__m128i tW=_mm_sha256msg1_epu32(atW[i&3],atW[(i+1)&3]);
+				tW=_mm_add_epi32(tW,_mm_alignr_epi8(atW[(i+3)&3],atW[(i+2)&3],4));
+				atW[i&3]=_mm_sha256msg2_epu32(tW,atW[(i+3)&3]);
+			}
+			tMsg=_mm_add_epi32(atW[i&3],_mm_loadu_si128((const __m128i*)&s_aulSha256K[4*i]));
+			tState1=_mm_sha256rnds2_epu32(tState1,tState0,tMsg);
+			tMsg=_mm_shuffle_epi32(tMsg,0x0E);
+			tState0=_mm_sha256rnds2_epu32(tState0,tState1,tMsg);
+		}
+		tState0=_mm_add_epi32(tState0,tAbefSave);
+		tState1=_mm_add_epi32(tState1,tCdghSave);
+		pabData+=64;
+	}
+
+	tTmp=_mm_shuffle_epi32(tState0,0x1B);           // FEBA
+	tState1=_mm_shuffle_epi32(tState1,0xB1);        // DCHG
+	tState0=_mm_blend_epi16(tTmp,tState1,0xF0);     // DCBA
+	tState1=_mm_alignr_epi8(tState1,tTmp,8);        // HGFE
+	_mm_storeu_si128((__m128i*)&aulState[0],tState0);
+	_mm_storeu_si128((__m128i*)&aulState[4],tState1);
+}
+
+static bool Sha256HasShaNi(void){
+	unsigned int a=0,b=0,c=0,d=0;
+	if(!__get_cpuid(1,&a,&b,&c,&d) || !(c&bit_SSE4_1) || !(c&bit_SSSE3))
+		return false;
+	if(!__get_cpuid_count(7,0,&a,&b,&c,&d))
+		return false;
+	return (b&(1u<<29))!=0;
+}
+#endif
+
+
+
+#ifdef SHA256_USE_ARMV8
+static void Sha256BlocksArmV8(uint32_t* aulState, const uint8_t* pabData, size_t ulNumBlocks){
+	uint32x4_t tState0=vld1q_u32(&aulState[0]);
+	uint32x4_t tState1=vld1q_u32(&aulState[4]);
+	uint32x4_t atW[4];
+	int i=0;
+
+	while(ulNumBlocks--){
+		uint32x4_t tAbcdSave=tState0;
+		uint32x4_t tEfghSave=tState1;
+		for(i=0;i<4;i++){
+			atW[i]=vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(pabData+16*i)));
+		}
+		for(i=0;i<16;i++){
+			uint32x4_t tWk=vaddq_u32(atW[i&3],vld1q_u32(&s_aulSha256K[4*i]));
+			uint32x4_t tTmp=tState0;
+			if(i<12){
+				atW[i&3]=vsha256su1q_u32(vsha256su0q_u32(atW[i&3],atW[(i+1)&3]),atW[(i+2)&3],atW[(i+3)&3]);
+			}
+			tState0=vsha256hq_u32(tState0,tState1,tWk);
+			tState1=vsha256h2q_u32(tState1,tTmp,tWk);
+		}
+		tState0=vaddq_u32(tState0,tAbcdSave);
+		tState1=vaddq_u32(tState1,tEfghSave);
+		pabData+=64;
+	}
+	vst1q_u32(&aulState[0],tState0);
+	vst1q_u32(&aulState[4],tState1);
+}
+#endif
+
+
+
+typedef void (*SHA256_BLOCKS_FN)(uint32_t* aulState, const uint8_t* pabData, size_t ulNumBlocks);
+
+/* selected on first use, all candidates give the same result so a race is harmless */
+static SHA256_BLOCKS_FN s_fnSha256Blocks=NULL;
+
+static SHA256_BLOCKS_FN Sha256Select(void){
+	if(s_fnSha256Blocks==NULL){
+		SHA256_BLOCKS_FN fnBlocks=Sha256BlocksC;
+#if defined(SHA256_USE_SHANI)
+		if(Sha256HasShaNi())
+			fnBlocks=Sha256BlocksShaNi;
+#elif defined(SHA256_USE_ARMV8)
+		fnBlocks=Sha256BlocksArmV8;
+#endif
+		s_fnSha256Blocks=fnBlocks;
+	}
+	return s_fnSha256Blocks;
+}
+
+static void Sha256Blocks(uint32_t* aulState, const uint8_t* pabData, size_t ulNumBlocks){
+	Sha256Select()(aulState,pabData,ulNumBlocks);
+}
+
+
+
+/* name of the block implementation in use, for reports */
+const char* Sha256Engine(void){
+	SHA256_BLOCKS_FN fnBlocks=Sha256Select();
+#ifdef SHA256_USE_SHANI
+	if(fnBlocks==Sha256BlocksShaNi)
+		return "SHA-NI";
+#endif
+#ifdef SHA256_USE_ARMV8
+	if(fnBlocks==Sha256BlocksArmV8)
+		return "ARMv8 SHA2";
+#endif
+	return "C";
+}
+
+
+
+void Sha256Init(SHA256_CTX_T* ptCtx){
+	static const uint32_t aulInit[8]={
+		0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19,
+	};
+	memcpy(ptCtx->aulState,aulInit,sizeof(aulInit));
+	ptCtx->ullLength=0;
+	ptCtx->ulBufferLen=0;
+}
+
+
+
+void Sha256Update(SHA256_CTX_T* ptCtx, const void* pvData, size_t ulSize){
+	const uint8_t* pabData=(const uint8_t*)pvData;
+
+	ptCtx->ullLength+=ulSize;
+
+	if(ptCtx->ulBufferLen){
+		size_t ulFill=HIL_MIN(ulSize,64-ptCtx->ulBufferLen);
+		memcpy(&ptCtx->abBuffer[ptCtx->ulBufferLen],pabData,ulFill);
+		ptCtx->ulBufferLen+=ulFill;
+		pabData+=ulFill;
+		ulSize-=ulFill;
+		if(ptCtx->ulBufferLen<64)
+			return;
+		Sha256Blocks(ptCtx->aulState,ptCtx->abBuffer,1);
+		ptCtx->ulBufferLen=0;
+	}
+
+	if(ulSize>=64){
+		Sha256Blocks(ptCtx->aulState,pabData,ulSize/64);
+		pabData+=ulSize&~(size_t)63;
+		ulSize&=63;
+	}
+
+	memcpy(ptCtx->abBuffer,pabData,ulSize);
+	ptCtx->ulBufferLen=ulSize;
+}
+
+
+
+void Sha256Final(SHA256_CTX_T* ptCtx, uint8_t* abDigest){
+	uint64_t ullBits=ptCtx->ullLength*8;
+	int i=0;
+
+	ptCtx->abBuffer[ptCtx->ulBufferLen++]=0x80;
+	if(ptCtx->ulBufferLen>56){
+		memset(&ptCtx->abBuffer[ptCtx->ulBufferLen],0,64-ptCtx->ulBufferLen);
+		Sha256Blocks(ptCtx->aulState,ptCtx->abBuffer,1);
+		ptCtx->ulBufferLen=0;
+	}
+	memset(&ptCtx->abBuffer[ptCtx->ulBufferLen],0,56-ptCtx->ulBufferLen);
+	for(i=0;i<8;i++){
+		ptCtx->abBuffer[56+i]=(uint8_t)(ullBits>>(56-8*i));
+	}
+	Sha256Blocks(ptCtx->aulState,ptCtx->abBuffer,1);
+
+	for(i=0;i<8;i++){
+		abDigest[4*i+0]=(uint8_t)(ptCtx->aulState[i]>>24);
+		abDigest[4*i+1]=(uint8_t)(ptCtx->aulState[i]>>16);
+		abDigest[4*i+2]=(uint8_t)(ptCtx->aulState[i]>>8);
+		abDigest[4*i+3]=(uint8_t)(ptCtx->aulState[i]);
+	}
+}
+
+
+
+void Sha256(const void* pvData, size_t ulSize, uint8_t* abDigest){
+	SHA256_CTX_T tCtx;
+	Sha256Init(&tCtx);
+	Sha256Update(&tCtx,pvData,ulSize);
+	Sha256Final(&tCtx,abDigest);
+}
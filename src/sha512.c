@@ -0,0 +1,298 @@
+/*
+ * sha512.c
+ *
+ *  Created on: 19.10.2026
+ *
+ *  SHA-512 and SHA-384 (FIPS 180-4)
+ *  Sha384Multi hashes up to four buffers at once, the common full blocks run in
+ *  the 64 bit lanes of AVX2 registers when the CPU has them
+ */
+
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SHA512_USE_AVX2
+#endif
+
+#include "netXFileChecker.h"
+
+
+static const uint64_t s_aullSha512K[80]={
+	0x428a2f98d728ae22ULL,0x7137449123ef65cdULL,0xb5c0fbcfec4d3b2fULL,0xe9b5dba58189dbbcULL,
+	0x3956c25bf348b538ULL,0x59f111f1b605d019ULL,0x923f82a4af194f9bULL,0xab1c5ed5da6d8118ULL,
+	0xd807aa98a3030242ULL,0x12835b0145706fbeULL,0x243185be4ee4b28cULL,0x550c7dc3d5ffb4e2ULL,
+	0x72be5d74f27b896fULL,0x80deb1fe3b1696b1ULL,0x9bdc06a725c71235ULL,0xc19bf174cf692694ULL,
+	0xe49b69c19ef14ad2ULL,0xefbe4786384f25e3ULL,0x0fc19dc68b8cd5b5ULL,0x240ca1cc77ac9c65ULL,
+	0x2de92c6f592b0275ULL,0x4a7484aa6ea6e483ULL,0x5cb0a9dcbd41fbd4ULL,0x76f988da831153b5ULL,
+	0x983e5152ee66dfabULL,0xa831c66d2db43210ULL,0xb00327c898fb213fULL,0xbf597fc7beef0ee4ULL,
+	0xc6e00bf33da88fc2ULL,0xd5a79147930aa725ULL,0x06ca6351e003826fULL,0x142929670a0e6e70ULL,
+	0x27b70a8546d22ffcULL,0x2e1b21385c26c926ULL,0x4d2c6dfc5ac42aedULL,0x53380d139d95b3dfULL,
+	0x650a73548baf63deULL,0x766a0abb3c77b2a8ULL,0x81c2c92e47edaee6ULL,0x92722c851482353bULL,
+	0xa2bfe8a14cf10364ULL,0xa81a664bbc423001ULL,0xc24b8b70d0f89791ULL,0xc76c51a30654be30ULL,
+	0xd192e819d6ef5218ULL,0xd69906245565a910ULL,0xf40e35855771202aULL,0x106aa07032bbd1b8ULL,
+	0x19a4c116b8d2d0c8ULL,0x1e376c085141ab53ULL,0x2748774cdf8eeb99ULL,0x34b0bcb5e19b48a8ULL,
+	0x391c0cb3c5c95a63ULL,0x4ed8aa4ae3418acbULL,0x5b9cca4f7763e373ULL,0x682e6ff3d6b2b8a3ULL,
+	0x748f82ee5defb2fcULL,0x78a5636f43172f60ULL,0x84c87814a1f0ab72ULL,0x8cc702081a6439ecULL,
+	0x90befffa23631e28ULL,0xa4506cebde82bde9ULL,0xbef9a3f7b2c67915ULL,0xc67178f2e372532bULL,
+	0xca273eceea26619cULL,0xd186b8c721c0c207ULL,0xeada7dd6cde0eb1eULL,0xf57d4f7fee6ed178ULL,
+	0x06f067aa72176fbaULL,0x0a637dc5a2c898a6ULL,0x113f9804bef90daeULL,0x1b710b35131c471bULL,
+	0x28db77f523047d84ULL,0x32caab7b40c72493ULL,0x3c9ebe0a15c9bebcULL,0x431d67c49c100d4cULL,
+	0x4cc5d4becb3e42b6ULL,0x597f299cfc657e2aULL,0x5fcb6fab3ad6faecULL,0x6c44198c4a475817ULL,
+};
+
+#define ROR64(x,n) (((x)>>(n))|((x)<<(64-(n))))
+
+
+
+static uint64_t Load64Be(const uint8_t* pab){
+	return ((uint64_t)pab[0]<<56)|((uint64_t)pab[1]<<48)|((uint64_t)pab[2]<<40)|((uint64_t)pab[3]<<32)|
+		((uint64_t)pab[4]<<24)|((uint64_t)pab[5]<<16)|((uint64_t)pab[6]<<8)|pab[7];
+}
+
+
+
+static void Sha512Block(uint64_t* aullState, const uint8_t* pabBlock){
+	uint64_t aullW[80];
+	uint64_t a,b,c,d,e,f,g,h;
+	int i=0;
+
+	for(i=0;i<16;i++){
+		aullW[i]=Load64Be(pabBlock+8*i);
+	}
+	for(i=16;i<80;i++){
+		uint64_t s0=ROR64(aullW[i-15],1)^ROR64(aullW[i-15],8)^(aullW[i-15]>>7);
+		uint64_t s1=ROR64(aullW[i-2],19)^ROR64(aullW[i-2],61)^(aullW[i-2]>>6);
+		aullW[i]=aullW[i-16]+s0+aullW[i-7]+s1;
+	}
+
+	a=aullState[0]; b=aullState[1]; c=aullState[2]; d=aullState[3];
+	e=aullState[4]; f=aullState[5]; g=aullState[6]; h=aullState[7];
+
+	for(i=0;i<80;i++){
+		uint64_t S1=ROR64(e,14)^ROR64(e,18)^ROR64(e,41);
+		uint64_t ch=(e&f)^(~e&g);
+		uint64_t t1=h+S1+ch+s_aullSha512K[i]+aullW[i];
+		uint64_t S0=ROR64(a,28)^ROR64(a,34)^ROR64(a,39);
+		uint64_t maj=(a&b)^(a&c)^(b&c);
+		uint64_t t2=S0+maj;
+		h=g; g=f; f=e; e=d+t1;
+		d=c; c=b; b=a; a=t1+t2;
+	}
+
+	aullState[0]+=a; aullState[1]+=b; aullState[2]+=c; aullState[3]+=d;
+	aullState[4]+=e; aullState[5]+=f; aullState[6]+=g; aullState[7]+=h;
+}
+
+
+
+#ifdef SHA512_USE_AVX2
+#define ROR64X4(x,n) _mm256_or_si256(_mm256_srli_epi64((x),(n)),_mm256_slli_epi64((x),64-(n)))
+
+/* one block of each of the four lanes, lane i reads apabData[i] and updates apullState[i] */
+__attribute__((target("avx2")))
+static void Sha512Blocks4Avx2(uint64_t** apullState, const uint8_t** apabData, size_t ulNumBlocks){
+	__m256i atW[80];
+	__m256i atState[8];
+	__m256i a,b,c,d,e,f,g,h;
+	size_t ulBlock=0;
+	int i=0;
+
+	for(i=0;i<8;i++){
+		atState[i]=_mm256_set_epi64x((long long)apullState[3][i],(long long)apullState[2][i],(long long)apullState[1][i],(long long)apullState[0][i]);
+	}
+
+	for(ulBlock=0;ulBlock<ulNumBlocks;ulBlock++){
+		size_t ulOffset=ulBlock*128;
+
+		for(i=0;i<16;i++){
+			atW[i]=_mm256_set_epi64x(
+				(long long)Load64Be(apabData[3]+ulOffset+8*i),(long long)Load64Be(apabData[2]+ulOffset+8*i),
+				(long long)Load64Be(apabData[1]+ulOffset+8*i),(long long)Load64Be(apabData[0]+ulOffset+8*i));
+		}
+		for(i=16;i<80;i++){
+			__m256i s0=_mm256_xor_si256(_mm256_xor_si256(ROR64X4(atW[i-15],1),ROR64X4(atW[i-15],8)),_mm256_srli_epi64(atW[i-15],7));
+			__m256i s1=_mm256_xor_si256(_mm256_xor_si256(ROR64X4(atW[i-2],19),ROR64X4(atW[i-2],61)),_mm256_srli_epi64(atW[i-2],6));
+			atW[i]=_mm256_add_epi64(_mm256_add_epi64(atW[i-16],s0),_mm256_add_epi64(atW[i-7],s1));
+		}
+
+		a=atState[0]; b=atState[1]; c=atState[2]; d=atState[3];
+		e=atState[4]; f=atState[5]; g=atState[6]; h=atState[7];
+
+		for(i=0;i<80;i++){
+			__m256i S1=_mm256_xor_si256(_mm256_xor_si256(ROR64X4(e,14),ROR64X4(e,18)),ROR64X4(e,41));
+			__m256i ch=_mm256_xor_si256(_mm256_and_si256(e,f),_mm256_andnot_si256(e,g));
+			__m256i t1=_mm256_add_epi64(_mm256_add_epi64(h,S1),_mm256_add_epi64(ch,_mm256_add_epi64(atW[i],_mm256_set1_epi64x((long long)s_aullSha512K[i]))));
+			__m256i S0=_mm256_xor_si256(_mm256_xor_si256(ROR64X4(a,28),ROR64X4(a,34)),ROR64X4(a,39));
+			__m256i maj=_mm256_or_si256(_mm256_and_si256(a,_mm256_or_si256(b,c)),_mm256_and_si256(b,c));
+			h=g; g=f; f=e; e=_mm256_add_epi64(d,t1);
+			d=c; c=b; b=a; a=_mm256_add_epi64(t1,_mm256_add_epi64(S0,maj));
+		}
+
+		atState[0]=_mm256_add_epi64(atState[0],a); atState[1]=_mm256_add_epi64(atState[1],b);
+		atState[2]=_mm256_add_epi64(atState[2],c); atState[3]=_mm256_add_epi64(atState[3],d);
+		atState[4]=_mm256_add_epi64(atState[4],e); atState[5]=_mm256_add_epi64(atState[5],f);
+		atState[6]=_mm256_add_epi64(atState[6],g); atState[7]=_mm256_add_epi64(atState[7],h);
+	}
+
+	for(i=0;i<8;i++){
+		uint64_t aullLane[4];
+		_mm256_storeu_si256((__m256i*)aullLane,atState[i]);
+		apullState[0][i]=aullLane[0];
+		apullState[1][i]=aullLane[1];
+		apullState[2][i]=aullLane[2];
+		apullState[3][i]=aullLane[3];
+	}
+}
+#endif
+
+
+
+/* name of the multi buffer implementation in use, for reports */
+const char* Sha512Engine(void){
+#ifdef SHA512_USE_AVX2
+	if(__builtin_cpu_supports("avx2"))
+		return "AVX2 4 lanes";
+#endif
+	return "C";
+}
+
+
+
+void Sha512Init(SHA512_CTX_T* ptCtx){
+	static const uint64_t aullInit[8]={
+		0x6a09e667f3bcc908ULL,0xbb67ae8584caa73bULL,0x3c6ef372fe94f82bULL,0xa54ff53a5f1d36f1ULL,
+		0x510e527fade682d1ULL,0x9b05688c2b3e6c1fULL,0x1f83d9abfb41bd6bULL,0x5be0cd19137e2179ULL,
+	};
+	memcpy(ptCtx->aullState,aullInit,sizeof(aullInit));
+	ptCtx->ullLength=0;
+	ptCtx->ulBufferLen=0;
+}
+
+
+
+/* SHA-384 uses SHA-512 with other initial values, the digest is the first 48 bytes of Sha512Final */
+void Sha384Init(SHA512_CTX_T* ptCtx){
+	static const uint64_t aullInit[8]={
+		0xcbbb9d5dc1059ed8ULL,0x629a292a367cd507ULL,0x9159015a3070dd17ULL,0x152fecd8f70e5939ULL,
+		0x67332667ffc00b31ULL,0x8eb44a8768581511ULL,0xdb0c2e0d64f98fa7ULL,0x47b5481dbefa4fa4ULL,
+	};
+	memcpy(ptCtx->aullState,aullInit,sizeof(aullInit));
+	ptCtx->ullLength=0;
+	ptCtx->ulBufferLen=0;
+}
+
+
+
+void Sha512Update(SHA512_CTX_T* ptCtx, const void* pvData, size_t ulSize){
+	const uint8_t* pabData=(const uint8_t*)pvData;
+
+	ptCtx->ullLength+=ulSize;
+
+	if(ptCtx->ulBufferLen){
+		size_t ulFill=HIL_MIN(ulSize,128-ptCtx->ulBufferLen);
+		memcpy(&ptCtx->abBuffer[ptCtx->ulBufferLen],pabData,ulFill);
+		ptCtx->ulBufferLen+=ulFill;
+		pabData+=ulFill;
+		ulSize-=ulFill;
+		if(ptCtx->ulBufferLen<128)
+			return;
+		Sha512Block(ptCtx->aullState,ptCtx->abBuffer);
+		ptCtx->ulBufferLen=0;
+	}
+
+	while(ulSize>=128){
+		Sha512Block(ptCtx->aullState,pabData);
+		pabData+=128;
+		ulSize-=128;
+	}
+
+	memcpy(ptCtx->abBuffer,pabData,ulSize);
+	ptCtx->ulBufferLen=ulSize;
+}
+
+
+
+void Sha512Final(SHA512_CTX_T* ptCtx, uint8_t* abDigest){
+	uint64_t ullBits=ptCtx->ullLength*8;
+	int i=0;
+
+	ptCtx->abBuffer[ptCtx->ulBufferLen++]=0x80;
+	if(ptCtx->ulBufferLen>112){
+		memset(&ptCtx->abBuffer[ptCtx->ulBufferLen],0,128-ptCtx->ulBufferLen);
+		Sha512Block(ptCtx->aullState,ptCtx->abBuffer);
+		ptCtx->ulBufferLen=0;
+	}
+	/* the upper 64 bits of the 128 bit length are always 0 here */
+	memset(&ptCtx->abBuffer[ptCtx->ulBufferLen],0,120-ptCtx->ulBufferLen);
+	for(i=0;i<8;i++){
+		ptCtx->abBuffer[120+i]=(uint8_t)(ullBits>>(56-8*i));
+	}
+	Sha512Block(ptCtx->aullState,ptCtx->abBuffer);
+
+	for(i=0;i<64;i++){
+		abDigest[i]=(uint8_t)(ptCtx->aullState[i/8]>>(56-8*(i%8)));
+	}
+}
+
+
+
+/* SHA-384 of iNumBuffers buffers, abDigest receives SHA384_DIGEST_SIZE bytes per buffer
+ * groups of four buffers step through their common full blocks together,
+ * the remaining blocks of the longer buffers are hashed one by one */
+void Sha384Multi(const uint8_t* const* apabData, const size_t* aulSize, int iNumBuffers, uint8_t* abDigest){
+	SHA512_CTX_T atCtx[SHA512_LANES];
+	uint8_t abFull[SHA512_DIGEST_SIZE];
+	int iFirst=0;
+	int i=0;
+
+	for(iFirst=0;iFirst<iNumBuffers;iFirst+=SHA512_LANES){
+		int iLanes=HIL_MIN(SHA512_LANES,iNumBuffers-iFirst);
+		size_t aulDone[SHA512_LANES]={0};
+
+		for(i=0;i<iLanes;i++){
+			Sha384Init(&atCtx[i]);
+		}
+
+#ifdef SHA512_USE_AVX2
+		if(iLanes>1 && __builtin_cpu_supports("avx2")){
+			uint64_t* apullState[SHA512_LANES];
+			const uint8_t* apabLane[SHA512_LANES];
+			size_t ulCommon=aulSize[iFirst]/128;
+
+			for(i=0;i<SHA512_LANES;i++){
+				/* unused lanes repeat lane 0 into a scratch context */
+				int iLane=i<iLanes ? i : 0;
+				apullState[i]=i<iLanes ? atCtx[i].aullState : atCtx[iLanes].aullState;
+				apabLane[i]=apabData[iFirst+iLane];
+				if(i<iLanes)
+					ulCommon=HIL_MIN(ulCommon,aulSize[iFirst+i]/128);
+			}
+			if(iLanes<SHA512_LANES)
+				memcpy(atCtx[iLanes].aullState,atCtx[0].aullState,sizeof(atCtx[0].aullState));
+
+			if(ulCommon){
+				Sha512Blocks4Avx2(apullState,apabLane,ulCommon);
+				for(i=0;i<iLanes;i++){
+					aulDone[i]=ulCommon*128;
+					atCtx[i].ullLength=aulDone[i];
+				}
+			}
+		}
+#endif
+
+		for(i=0;i<iLanes;i++){
+			Sha512Update(&atCtx[i],apabData[iFirst+i]+aulDone[i],aulSize[iFirst+i]-aulDone[i]);
+			Sha512Final(&atCtx[i],abFull);
+			memcpy(&abDigest[(iFirst+i)*SHA384_DIGEST_SIZE],abFull,SHA384_DIGEST_SIZE);
+		}
+	}
+}
+
+
+
+void Sha384(const void* pvData, size_t ulSize, uint8_t* abDigest){
+	const uint8_t* pabData=(const uint8_t*)pvData;
+	Sha384Multi(&pabData,&ulSize,1,abDigest);
+}